@@ -2,19 +2,20 @@
 
 //--------------------Button CLASS---------------------------------------------------------------//
 
-void Button::updateState()
+void Button::updateState(uint32_t now)
 {
     state = digitalRead(pin);
-    if (micros() - m_last_update >= 2500UL) //Short delay of 5ms to prevent weird things from happening
+    if (now - m_last_update >= 2500UL) //Short delay of 5ms to prevent weird things from happening
     {
         if (state && (state != prevState))
         {
             clickedOnce = true;
+            press_time = now;
         }
         else{
             clickedOnce = false;
         }
-        m_last_update = micros();
+        m_last_update = now;
     }
 }
 
@@ -27,10 +28,10 @@ void Button::setup() const {
 
 //--------------------ButtonUtils NAMESPACE---------------------------------------------------------------//
 
-void ButtonUtils::updateButtons(const std::vector<Button*>& myButtons) {
-    if(micros()-getMostRecentUpdate(myButtons) >= 5000){
+void ButtonUtils::updateButtons(const std::vector<Button*>& myButtons, uint32_t now) {
+    if(now-getMostRecentUpdate(myButtons) >= 5000){
         for (Button* btn : myButtons) {
-            btn->updateState();
+            btn->updateState(now);
         }
     }
 }
@@ -5,20 +5,24 @@
 class Button{
   public:
   uint32_t m_last_update;
+  uint32_t press_time;   //Time of the update that registered the last click, in microseconds
   const uint8_t pin;
   bool state;
   bool prevState;
   bool clickedOnce;
-  Button(const uint8_t gpio):pin(gpio),state(false),prevState(false),clickedOnce(false), m_last_update(micros()){}
+  Button(const uint8_t gpio):pin(gpio),state(false),prevState(false),clickedOnce(false), m_last_update(0), press_time(0){}
   void setup() const;
-  void updateState();
+  /// @param now The current time in microseconds, usually sampled once per loop and shared by every button
+  void updateState(uint32_t now);
+  void updateState(){ updateState(micros()); }
   void remember(){prevState = state; clickedOnce=false;}
   private:
 };
 
 namespace ButtonUtils{
   uint32_t getMostRecentUpdate(const std::vector<Button*>& myButtons);
-  void updateButtons(const std::vector<Button*>& myButtons);
+  void updateButtons(const std::vector<Button*>& myButtons, uint32_t now);
+  inline void updateButtons(const std::vector<Button*>& myButtons){ updateButtons(myButtons, micros()); }
   void rememberButtons(const std::vector<Button*>& myButtons);
   void setupButtons(const std::vector<Button*>& myButtons);
 }
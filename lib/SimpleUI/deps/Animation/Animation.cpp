@@ -1,77 +1,308 @@
 #include "Animation.h"
 #include <math.h>
+#include <algorithm>
 
 namespace SimpleUI{
 
+//--------------------AnimationStore CLASS---------------------------------------------------------------//
+
+    AnimationStore& AnimationStore::global(){
+        static AnimationStore store;
+        return s_active ? *s_active : store;
+    }
+
+    //Elements can be created by the scene preloader while the main loop creates its own, so slot bookkeeping is guarded
+    void AnimationStore::m_lock(){
+        while (m_busy.test_and_set(std::memory_order_acquire)){
+            #ifdef ESP32
+            vTaskDelay(0);
+            #endif
+        }
+    }
+
+    uint16_t AnimationStore::acquire(float start, float end, uint32_t length, float factor){
+        m_lock();
+        uint16_t slot = 0;
+        while (slot < CAPACITY && (m_flags[slot] & USED))
+            slot++;
+        if (slot == CAPACITY)
+            m_overflows++;
+        else{
+            m_used++;
+            if (slot >= m_high)
+                m_high = slot + 1;
+        }
+        m_flags[slot] = USED;
+        m_unlock();
+        if (slot == CAPACITY)
+            Serial.printf("SimpleUI: SIMPLEUI_MAX_ANIMATIONS (%u) reached, the new animation won't move\n", static_cast<unsigned int>(CAPACITY));
+
+        const uint64_t now = m_time;
+        m_start[slot] = start;
+        m_end[slot] = end;
+        m_setValue(slot, start);
+        m_factor[slot] = factor;
+        m_T[slot] = 0.0f;
+        m_length[slot] = length;
+        m_elapsed[slot] = 0UL;
+        m_startTime[slot] = now;
+        m_now[slot] = now;
+        m_step[slot] = 0;
+        m_max_steps[slot] = 0;
+        m_threshold[slot] = 0.0f;
+        m_shown[slot] = UNSHOWN;
+        m_state[slot] = AnimState::Start;
+        return slot;
+    }
+
+    void AnimationStore::release(uint16_t slot){
+        if (slot >= CAPACITY)
+            return;
+        m_lock();
+        m_flags[slot] = 0;
+        m_used--;
+        while (m_high && !(m_flags[m_high - 1] & USED))
+            m_high--;
+        m_unlock();
+    }
+
+    void AnimationStore::copy(const AnimationStore& source, uint16_t from, uint16_t to){
+        m_start[to] = source.m_start[from];
+        m_end[to] = source.m_end[from];
+        m_progress[to] = source.m_progress[from];
+        m_fixed[to] = source.m_fixed[from];
+        m_factor[to] = source.m_factor[from];
+        m_T[to] = source.m_T[from];
+        m_length[to] = source.m_length[from];
+        m_elapsed[to] = source.m_elapsed[from];
+        m_startTime[to] = source.m_startTime[from];
+        m_now[to] = source.m_now[from];
+        m_shown[to] = source.m_shown[from];
+        m_state[to] = source.m_state[from];
+        m_flags[to] = (source.m_flags[from] & ~USED) | (m_flags[to] & USED);
+        copyModes(source, from, to);
+    }
+
+    void AnimationStore::copyModes(const AnimationStore& source, uint16_t from, uint16_t to){
+        m_step[to] = source.m_step[from];
+        m_max_steps[to] = source.m_max_steps[from];
+        m_threshold[to] = source.m_threshold[from];
+    }
+
+    /*Every stage runs over all the slots at once. The easing is the expensive part, so it's skipped for the slots that aren't running and
+    for the ones that can't have moved enough since their value was last published*/
+    void AnimationStore::update(uint64_t now){
+        m_time = now;
+        if (now == m_updated)
+            return;
+        m_updated = now;
+        const uint16_t count = m_high;
+        for (uint16_t i = 0; i < count; i++)
+            m_T[i] = (m_flags[i] & ENABLED) && m_state[i] != AnimState::Finished ? m_advance(i, now) : -1.0f;
+        for (uint16_t i = 0; i < count; i++){
+            if (m_T[i] >= 0.0f)
+                m_T[i] = Animation::smoothStep(m_T[i], m_factor[i]);
+        }
+
+        for (uint16_t i = 0; i < count; i++){
+            if ((m_flags[i] & ENABLED) && m_state[i] != AnimState::Finished)
+                m_publish(i, now);
+            else if ((m_flags[i] & (ENABLED | LOOP)) == (ENABLED | LOOP))
+                m_finish(i);
+            else
+                m_flags[i] &= ~DIRTY;
+        }
+    }
+
+    void AnimationStore::update(uint16_t slot, uint64_t now){
+        if (!(m_flags[slot] & ENABLED)){
+            m_flags[slot] &= ~DIRTY;
+            return;
+        }
+        if (m_state[slot] == AnimState::Finished){
+            if (m_flags[slot] & LOOP)
+                m_finish(slot);
+            else
+                m_flags[slot] &= ~DIRTY;
+            return;
+        }
+        m_T[slot] = m_advance(slot, now);
+        if (m_T[slot] >= 0.0f)
+            m_T[slot] = Animation::smoothStep(m_T[slot], m_factor[slot]);
+        m_publish(slot, now);
+    }
+
+    /*!
+        @brief Move a running slot to the given time, in whole steps if it has a fixed timestep
+        @return How far it is through its length, negative if its value can't have changed by its threshold since it was last published
+    */
+    float AnimationStore::m_advance(uint16_t slot, uint64_t now){
+        uint32_t elapsed = m_elapsedAt(slot, now);
+        const uint32_t step = m_step[slot];
+        if (step){
+            if (elapsed < m_length[slot])
+                elapsed -= elapsed % step;
+            //A late frame only catches up a few steps, the rest of the timeline is pushed back so the animation slows down instead of jumping
+            const uint32_t catch_up = step * m_max_steps[slot];
+            if (catch_up && elapsed > m_elapsed[slot] + catch_up){
+                elapsed = m_elapsed[slot] + catch_up;
+                m_startTime[slot] = now - elapsed;
+            }
+        }
+        m_elapsed[slot] = elapsed;
+
+        //The easing is never steeper than its factor, which bounds how much the value can have moved without evaluating it
+        const float threshold = m_threshold[slot];
+        if (threshold > 0.0f && elapsed < m_length[slot] && m_factor[slot] >= 1.0f && m_shown[slot] != UNSHOWN){
+            const uint32_t moved = elapsed > m_shown[slot] ? elapsed - m_shown[slot] : m_shown[slot] - elapsed;
+            if (fabsf(m_end[slot] - m_start[slot]) * m_factor[slot] * static_cast<float>(moved) < threshold * static_cast<float>(m_length[slot]))
+                return -1.0f;
+        }
+        const float T = static_cast<float>(elapsed) / static_cast<float>(m_length[slot] ? m_length[slot] : 1);
+        return T > 1.0f ? 1.0f : T;
+    }
+
+    /*Publish the eased value of m_advance() unless it moved less than the threshold, the last value of an animation is always published.
+    Evaluating a slot again at the same time keeps what the first evaluation found*/
+    void AnimationStore::m_publish(uint16_t slot, uint64_t now){
+        if (now != m_now[slot])
+            m_flags[slot] &= ~DIRTY;
+        m_now[slot] = now;
+        m_state[slot] = m_elapsed[slot] >= m_length[slot] ? AnimState::Finished : AnimState::Running;
+        if (m_T[slot] < 0.0f)
+            return;
+        const float value = Animation::clamp(Animation::lerp(m_start[slot], m_end[slot], m_T[slot]), m_start[slot], m_end[slot]);
+        if (m_state[slot] != AnimState::Finished && fabsf(value - m_progress[slot]) < m_threshold[slot])
+            return;
+        if (value != m_progress[slot])
+            m_flags[slot] |= DIRTY;
+        m_setValue(slot, value);
+        m_shown[slot] = m_elapsed[slot];
+    }
+
+    void AnimationStore::countStates(uint16_t& running, uint16_t& dirty) const {
+        running = 0;
+        dirty = 0;
+        for (uint16_t i = 0; i < m_high; i++){
+            running += (m_flags[i] & ENABLED) && m_state[i] != AnimState::Finished;
+            dirty += (m_flags[i] & DIRTY) != 0;
+        }
+    }
+
+    //A looping animation that reached its end starts over
+    void AnimationStore::m_finish(uint16_t slot){
+        m_startTime[slot] = m_time;
+        m_elapsed[slot] = 0UL;
+        if (m_progress[slot] != m_start[slot])
+            m_flags[slot] |= DIRTY;
+        m_setValue(slot, m_start[slot]);
+        m_shown[slot] = 0UL;
+        m_state[slot] = AnimState::Start;
+    }
+
+//--------------------Animation CLASS---------------------------------------------------------------//
+
     float Animation::smoothStep(const float x, const float k){
         float xk = std::pow(x, k);
         return xk / (xk + std::pow(1-x, k));
     }
 
+    //The copy lives in the store of the original, a copy of a handle without a slot has none either
+    Animation::Animation(const Animation& other)
+    : m_store(other.m_store), m_slot(other.isValid() ? m_store->acquire(0.0f, 1.0f, 0U, 1.0f) : AnimationStore::OVERFLOW_SLOT),
+      m_start(other.m_start), m_end(other.m_end){
+        if (isValid() && other.isValid())
+            store().copy(other.store(), other.m_slot, m_slot);
+    }
+
+    Animation& Animation::operator=(const Animation& other){
+        if (this == &other)
+            return *this;
+        if (m_store != other.m_store || isValid() != other.isValid()){
+            m_store->release(m_slot);
+            m_store = other.m_store;
+            m_slot = other.isValid() ? m_store->acquire(0.0f, 1.0f, 0U, 1.0f) : AnimationStore::OVERFLOW_SLOT;
+        }
+        m_start = other.m_start;
+        m_end = other.m_end;
+        if (isValid() && other.isValid())
+            store().copy(other.store(), other.m_slot, m_slot);
+        return *this;
+    }
+
+    Animation& Animation::operator=(Animation&& other) noexcept {
+        if (this != &other){
+            std::swap(m_store, other.m_store);
+            std::swap(m_slot, other.m_slot);
+            std::swap(m_start, other.m_start);
+            std::swap(m_end, other.m_end);
+        }
+        return *this;
+    }
+
     void Animation::Start(){
-        m_enable = true;
-        m_startTime = micros();
+        store().m_flags[m_slot] |= AnimationStore::ENABLED;
+        store().m_startTime[m_slot] = store().now();
+        store().m_elapsed[m_slot] = 0UL;
+        store().m_shown[m_slot] = AnimationStore::UNSHOWN;
     }
 
     void Animation::Resume(){
-        m_enable = true; 
-        m_startTime = micros() - m_elapsed;
+        store().m_flags[m_slot] |= AnimationStore::ENABLED;
+        store().m_startTime[m_slot] = store().now() - store().m_elapsed[m_slot];
     };
 
+    void Animation::Pause(){
+        store().m_flags[m_slot] &= ~AnimationStore::ENABLED;
+    }
+
+    void Animation::setFixedStep(uint32_t step, uint8_t max_steps){
+        store().m_step[m_slot] = step;
+        store().m_max_steps[m_slot] = max_steps;
+    }
+
+    void Animation::setLoop(bool loop){
+        if (loop)
+            store().m_flags[m_slot] |= AnimationStore::LOOP;
+        else
+            store().m_flags[m_slot] &= ~AnimationStore::LOOP;
+    }
+
     void Animation::Reset(){
-        m_startTime = micros();
-        m_elapsed = 0UL;
-        m_progress = m_start;
-        m_state = AnimState::Start;
+        store().m_finish(m_slot);
     }
-    
+
     void Animation::Flip(){
-        float temp = m_start;
-        m_start = m_end;
-        m_end = temp;
-        m_elapsed = m_length - m_elapsed;
-        m_startTime = m_now - m_elapsed;
+        std::swap(m_start, m_end);
+        if (!isValid())
+            return;
+        AnimationStore& s = store();
+        float temp = s.m_start[m_slot];
+        s.m_start[m_slot] = s.m_end[m_slot];
+        s.m_end[m_slot] = temp;
+        s.m_elapsed[m_slot] = s.m_length[m_slot] - s.m_elapsed[m_slot];
+        s.m_startTime[m_slot] = s.m_now[m_slot] - s.m_elapsed[m_slot];
+        s.m_shown[m_slot] = AnimationStore::UNSHOWN;
     }
 
+    /*An animation holding back its value below the threshold reports where its timeline is rather than what it last published. Its value
+    stays at the start for the first few frames while it runs, read as Start AnimatedApp would resume it instead of flipping it when the
+    focus changes meanwhile, and the icon would finish shrinking before growing back*/
     const AnimState Animation::getState() const {
-        if (fabs(m_progress - m_end) <= EPSILON || m_state == AnimState::Finished)
+        if (!isValid())
             return AnimState::Finished;
-        else if (fabs(m_progress - m_start) <= EPSILON || m_state == AnimState::Start)
+        const AnimationStore& s = store();
+        const bool holding = s.m_threshold[m_slot] > 0.0f && s.m_shown[m_slot] != s.m_elapsed[m_slot];
+        if (fabs(s.m_progress[m_slot] - s.m_end[m_slot]) <= EPSILON || s.m_state[m_slot] == AnimState::Finished)
+            return AnimState::Finished;
+        else if ((fabs(s.m_progress[m_slot] - s.m_start[m_slot]) <= EPSILON && !holding) || s.m_state[m_slot] == AnimState::Start)
             return AnimState::Start;
         else
             return AnimState::Running;
     }
 
-
     void Animation::Update(){
-        
-        if (m_enable) {
-            if ( m_state != AnimState::Finished) 
-            {
-                m_now = micros();
-                m_elapsed = m_now - m_startTime;
-
-                m_T = normalize(static_cast<float>(m_elapsed), 0, m_length);
-                m_T = std::clamp(m_T, 0.0f, 1.0f);
-
-                /*
-                if(func == Interpolation::Sinusoidal) 
-                    m_T = static_cast<float>(0.5*sin(m_T*M_PI-M_PI_2)+0.5);
-                else if (func == Interpolation::SmoothStep)
-                    m_T = smoothStep(m_T, smoothstep);
-                */
-                m_T = smoothStep(m_T, factor);
-
-                m_progress = Animation::clamp(lerp(m_start, m_end, m_T), m_start, m_end);
-
-
-                m_state = m_elapsed >= m_length ? AnimState::Finished : AnimState::Running;
-            }
-            else{
-                if (loop)
-                    Reset();
-            }
-        }
+        store().update(m_slot, store().now());
     }
 
 }
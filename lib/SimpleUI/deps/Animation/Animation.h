@@ -1,17 +1,123 @@
 #pragma once
 #include <Arduino.h>
 #include <stdint.h>
+#include <atomic>
+
+/*How many animations can exist at the same time: one for every UIImage and AnimatedApp, two for every UI. Past it acquire() prints a
+warning and the new animations get no slot, they never move and read as finished at their end value. Animation::isValid() and
+AnimationStore::getOverflows() tell them apart*/
+#ifndef SIMPLEUI_MAX_ANIMATIONS
+  #define SIMPLEUI_MAX_ANIMATIONS 64
+#endif
 
 namespace SimpleUI{
-    
+
     //Used to represent the completition state of an animation
-    enum class AnimState{Start, Running, Finished};
+    enum class AnimState : uint8_t {Start, Running, Finished};
+
+    /*The state of every animation, kept as parallel arrays so that advancing all of them is a handful of tight loops over contiguous
+    memory instead of a walk through objects scattered across the heap. Animation objects are just handles to a slot of the store.*/
+    class AnimationStore{
+        public:
+        static constexpr uint16_t CAPACITY = SIMPLEUI_MAX_ANIMATIONS;
+        static constexpr uint16_t OVERFLOW_SLOT = CAPACITY;   //Written by the animations created while the store was full, never read
+        static constexpr int FIXED_BITS = 4;    //Fractional bits of the fixed point copy of the values, a sixteenth like SimpleUI::Fixed
+
+        /*While a Scope exists the animations created belong to another store, the benchmarks build their elements in one so they don't
+        take the slots of the UI. Every handle keeps the store it was created in, which has to outlive it.*/
+        class Scope{
+            public:
+            explicit Scope(AnimationStore& store) : m_previous(s_active){ s_active = &store; }
+            ~Scope(){ s_active = m_previous; }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            private:
+            AnimationStore* m_previous;
+        };
+
+        //!@return The store every Animation lives in, the one of the innermost Scope if there's one
+        static AnimationStore& global();
+
+        //!@return A free slot initialized with the given parameters, OVERFLOW_SLOT if there's none left, which is also reported on the serial
+        uint16_t acquire(float start, float end, uint32_t length, float factor);
+        void release(uint16_t slot);
+        //!@brief Copy the whole state of a slot of a store, this one or another, into one of this store
+        void copy(const AnimationStore& source, uint16_t from, uint16_t to);
+        //!@brief Copy only the stepping and threshold modes of a slot of a store into one of this store
+        void copyModes(const AnimationStore& source, uint16_t from, uint16_t to);
+
+        /*!
+            @brief Advance every enabled animation to the time of a frame, the animations started, resumed or reset afterwards count from it.
+            Updating again to the same time does nothing, so the damage of a frame can be computed before rendering it.
+            @param now Microseconds on the clock of the UI, sampled once per frame
+        */
+        void update(uint64_t now);
+        //!@brief Advance a single animation, same math as update()
+        void update(uint16_t slot, uint64_t now);
+
+        //!@brief Move to the time of a new frame without advancing anything, so the animations started before update() count from it
+        inline void setTime(uint64_t now){ m_time = now; }
+        //!@return The time of the current frame in microseconds, the store never reads a timer itself
+        inline uint64_t now() const { return m_time; }
+
+        //!@return How many slots are in use
+        inline uint16_t getUsed() const { return m_used; }
+        //!@return How many animations didn't fit and had to share the overflow slot, raise SIMPLEUI_MAX_ANIMATIONS if it isn't 0
+        inline uint16_t getOverflows() const { return m_overflows; }
+        //!@brief Count the animations that are running and the ones whose value changed in the last update
+        void countStates(uint16_t& running, uint16_t& dirty) const;
+
+        private:
+        friend class Animation;
+        static constexpr uint16_t SLOTS = CAPACITY + 1;
+        static constexpr uint32_t UNSHOWN = UINT32_MAX;    //The published value doesn't match any point of the current timeline
+        enum Flags : uint8_t {USED = 1, ENABLED = 2, LOOP = 4, DIRTY = 8};
+
+        void m_lock();
+        inline void m_unlock(){ m_busy.clear(std::memory_order_release); }
+        void m_finish(uint16_t slot);
+        float m_advance(uint16_t slot, uint64_t now);
+        void m_publish(uint16_t slot, uint64_t now);
+        //The fixed point copy is converted once here, so the elements that read it every frame don't convert floats themselves
+        inline void m_setValue(uint16_t slot, float value){
+            m_progress[slot] = value;
+            m_fixed[slot] = static_cast<int32_t>(lroundf(value * (1 << FIXED_BITS)));
+        }
+        //!@return How long a slot has been running at the given time, capped to its length
+        inline uint32_t m_elapsedAt(uint16_t slot, uint64_t now) const {
+            const uint64_t elapsed = now > m_startTime[slot] ? now - m_startTime[slot] : 0;
+            return elapsed < m_length[slot] ? static_cast<uint32_t>(elapsed) : m_length[slot];
+        }
 
-    
+        float m_start[SLOTS];
+        float m_end[SLOTS];
+        float m_progress[SLOTS];
+        int32_t m_fixed[SLOTS];         //m_progress in sixteenths, rounded to the nearest
+        float m_factor[SLOTS];
+        float m_T[SLOTS];
+        uint32_t m_length[SLOTS];
+        uint32_t m_elapsed[SLOTS];
+        uint64_t m_startTime[SLOTS];
+        uint64_t m_now[SLOTS];
+        uint32_t m_step[SLOTS];         //Fixed timestep in microseconds, 0 for continuous time
+        uint8_t m_max_steps[SLOTS];     //Most steps a late frame catches up, 0 for all of them
+        float m_threshold[SLOTS];       //Smallest change of the value that gets published
+        uint32_t m_shown[SLOTS];        //Elapsed time of the published value
+        AnimState m_state[SLOTS];
+        uint8_t m_flags[SLOTS] = {};
+        uint16_t m_used = 0;
+        uint16_t m_overflows = 0;
+        uint16_t m_high = 0;    //One past the highest slot ever used, the bulk update doesn't look further
+        std::atomic_flag m_busy = ATOMIC_FLAG_INIT;
+        uint64_t m_time = 0;
+        uint64_t m_updated = UINT64_MAX;    //Time of the last bulk update
+        static inline AnimationStore* s_active = nullptr;   //Set by Scope
+    };
+
+    /*A handle to an animation in the AnimationStore it was created in, copying it copies the animation into a slot of its own. A handle
+    created while the store was full has no slot: it keeps its start and end itself and reads as finished at its end value*/
     class Animation{
         public:
-        float factor = 1.0f;
-        bool loop = false;
         friend class AnimatedApp;
 
         public:
@@ -21,14 +127,21 @@ namespace SimpleUI{
             @param length The duration of the animation in milliseconds
             @param step How much smoothing to apply (>1)
         */
-        Animation(float start = 0.0f, float end = 1.0f, unsigned int length = 1000U, float step = 1.0f) 
-        : m_start(start), m_end(end), m_length(length*1000U), m_now(micros()), m_startTime(micros()), m_progress(start), factor(step){}
+        Animation(float start = 0.0f, float end = 1.0f, unsigned int length = 1000U, float step = 1.0f)
+        : m_store(&AnimationStore::global()), m_slot(m_store->acquire(start, end, length*1000U, step)), m_start(start), m_end(end){}
+        Animation(const Animation& other);
+        Animation(Animation&& other) noexcept : m_store(other.m_store), m_slot(other.m_slot), m_start(other.m_start), m_end(other.m_end){
+            other.m_slot = AnimationStore::OVERFLOW_SLOT;
+        }
+        Animation& operator=(const Animation& other);
+        Animation& operator=(Animation&& other) noexcept;
+        ~Animation(){ m_store->release(m_slot); }
 
 
         void Start();
         //To be called after a pause
         void Resume();
-        inline void Pause() { m_enable = false; };
+        void Pause();
         //Restart the animation
         void Reset();
         void Flip();
@@ -43,10 +156,36 @@ namespace SimpleUI{
         const AnimState getState() const;
 
         /// @return True if the animation goes forwards
-        inline const bool getDirection() const { return m_start < m_end; };
+        inline const bool getDirection() const { return isValid() ? store().m_start[m_slot] < store().m_end[m_slot] : m_start < m_end; };
         /// @return The interpolated value
-        inline const float getProgress() const { return m_progress; }
-        inline const bool isEnabled() const { return m_enable; }
+        inline const float getProgress() const { return isValid() ? store().m_progress[m_slot] : m_end; }
+        /// @return The interpolated value in sixteenths, rounded once when it was published. SimpleUI::Fixed::of() reads it as a Fixed
+        inline int32_t getFixed() const {
+            return isValid() ? store().m_fixed[m_slot] : static_cast<int32_t>(lroundf(m_end * (1 << AnimationStore::FIXED_BITS)));
+        }
+        inline const bool isEnabled() const { return isValid() && (store().m_flags[m_slot] & AnimationStore::ENABLED); }
+        /// @return False if the store was full when the animation was created, it then never moves and stays at its end value
+        inline bool isValid() const { return m_slot != AnimationStore::OVERFLOW_SLOT; }
+        /// @return How much smoothing is applied
+        inline float getFactor() const { return isValid() ? store().m_factor[m_slot] : 1.0f; }
+        inline void setFactor(float factor){ store().m_factor[m_slot] = factor; }
+        /// @param loop Restart the animation every time it finishes
+        void setLoop(bool loop);
+        inline bool isLooping() const { return isValid() && (store().m_flags[m_slot] & AnimationStore::LOOP); }
+
+        /*!
+            @brief Only advance in whole steps, so the value at any moment doesn't depend on when the frames happened to be rendered
+            @param step      Length of a step in microseconds, 0 goes back to continuous time
+            @param max_steps How many steps a late frame may catch up, the rest of the animation is pushed back instead of jumping. 0 catches up at once
+        */
+        void setFixedStep(uint32_t step, uint8_t max_steps = 0);
+        /// @param threshold Smallest change of the value worth publishing, usually what moves the output by a pixel. 0 publishes every change
+        inline void setThreshold(float threshold){ store().m_threshold[m_slot] = threshold; }
+        inline float getThreshold() const { return isValid() ? store().m_threshold[m_slot] : 0.0f; }
+        /// @brief Step and publish changes like another animation does
+        inline void adoptModes(const Animation& other){ store().copyModes(other.store(), other.m_slot, m_slot); }
+        /// @return True if the value changed in the last update, an element whose animation isn't dirty looks the same as in the last frame
+        inline bool isDirty() const { return isValid() && (store().m_flags[m_slot] & AnimationStore::DIRTY); }
 
 
         bool operator==(const AnimState state){
@@ -64,24 +203,25 @@ namespace SimpleUI{
         static inline float normalize(const float x, const float min, const float max){ return (x - min) / (max - min); }
 
         static inline float map(const float x, const float in_min, const float in_max, const float out_min, const float out_max){ return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min; }
-    
+
         static inline float clamp(const float x, const float y, const float z){
             if(y < z)
-                return (x < y) ? y : (x > z) ? z : x; 
+                return (x < y) ? y : (x > z) ? z : x;
             else if (y > z)
-                return (x < z) ? z : (x > y) ? y : x; 
+                return (x < z) ? z : (x > y) ? y : x;
             else
                 return y;
         }
 
-        private:
         static constexpr float EPSILON = 0.0005;
-        
-        AnimState m_state = AnimState::Start;
-        float m_T = 0.0f, m_start, m_end, m_progress;
-        unsigned int m_length;
-        uint32_t m_elapsed = 0UL, m_now, m_startTime;
-        bool m_enable = false;
+
+        private:
+        inline AnimationStore& store() const { return *m_store; }
+        AnimationStore* m_store;
+        uint16_t m_slot;
+        //Only read while the handle has no slot, a valid one keeps them in the store
+        float m_start;
+        float m_end;
     };
 
 }
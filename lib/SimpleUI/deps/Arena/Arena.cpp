@@ -0,0 +1,43 @@
+#include "Arena.h"
+#if SIMPLEUI_ALLOC_GUARD
+#include <atomic>
+#endif
+
+namespace SimpleUI{
+
+    void FrameArena::reserve(size_t capacity){
+        free(m_block);
+        m_block = capacity ? static_cast<uint8_t*>(malloc(capacity)) : nullptr;
+        m_capacity = m_block ? capacity : 0;
+        m_used = 0;
+    }
+
+    void* FrameArena::allocate(size_t bytes, size_t align){
+        const size_t start = (m_used + align - 1) & ~(align - 1);
+        if (!m_block || start + bytes > m_capacity)
+            return nullptr;
+        m_used = start + bytes;
+        if (m_used > m_peak)
+            m_peak = m_used;
+        return m_block + start;
+    }
+
+    #if SIMPLEUI_ALLOC_GUARD
+    namespace AllocGuard{
+        std::atomic<size_t> counter{0};
+        size_t allocations(){ return counter.load(std::memory_order_relaxed); }
+    }
+    #endif
+}
+
+#if SIMPLEUI_ALLOC_GUARD && !defined(ESP32)
+//Every other form of new ends up here, so this is enough to count all of them
+void* operator new(size_t size){
+    SimpleUI::AllocGuard::counter.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+#endif
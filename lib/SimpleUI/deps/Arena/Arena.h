@@ -0,0 +1,94 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <new>
+#include <vector>
+
+//Set to 1 on the host build to count every general heap allocation, the UI then asserts that steady state frames make none
+#ifndef SIMPLEUI_ALLOC_GUARD
+    #define SIMPLEUI_ALLOC_GUARD 0
+#endif
+
+#if SIMPLEUI_ALLOC_GUARD
+    #include <assert.h>
+#endif
+
+namespace SimpleUI{
+
+    /*A bump allocator for memory that only lives for one frame. The block is allocated once, every allocation just moves an offset
+    forward and reset() frees everything at once, so the scratch buffers of the render path never touch (and never fragment) the heap.*/
+    class FrameArena{
+        public:
+        explicit FrameArena(size_t capacity = 0){ reserve(capacity); }
+        ~FrameArena(){ free(m_block); }
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        //Allocate the block, only meant to be called at init since it discards everything that's been allocated
+        void reserve(size_t capacity);
+        /*!
+            @return Memory that is valid until the next reset(), or nullptr if the arena is full
+            @param bytes How many bytes to allocate
+            @param align The required alignment, must be a power of two
+        */
+        void* allocate(size_t bytes, size_t align = alignof(max_align_t));
+        template<typename T>
+        inline T* allocate(size_t count){ return static_cast<T*>(allocate(count * sizeof(T), alignof(T))); }
+        inline void reset(){ m_used = 0; }
+
+        inline bool owns(const void* ptr) const { return ptr >= m_block && ptr < m_block + m_capacity; }
+        inline size_t getCapacity() const { return m_capacity; }
+        inline size_t getUsed() const { return m_used; }
+        //!@return The highest usage ever reached, useful to tune the capacity
+        inline size_t getPeak() const { return m_peak; }
+        //!@return How many allocations didn't fit and had to fall back to the heap
+        inline size_t getOverflows() const { return m_overflows; }
+        inline void countOverflow() { m_overflows++; }
+
+        private:
+        uint8_t* m_block = nullptr;
+        size_t m_capacity = 0;
+        size_t m_used = 0;
+        size_t m_peak = 0;
+        size_t m_overflows = 0;
+    };
+
+    //Standard allocator on top of a FrameArena, falls back to the heap when the arena is full or missing
+    template<typename T>
+    struct ArenaAllocator{
+        using value_type = T;
+        FrameArena* arena;
+
+        ArenaAllocator(FrameArena* arena = nullptr) noexcept : arena(arena){}
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena){}
+
+        T* allocate(size_t n){
+            if (arena){
+                if (T* ptr = arena->allocate<T>(n))
+                    return ptr;
+                arena->countOverflow();
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        void deallocate(T* ptr, size_t) noexcept {
+            if (!arena || !arena->owns(ptr))
+                ::operator delete(ptr);
+        }
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+    };
+
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    #if SIMPLEUI_ALLOC_GUARD
+    namespace AllocGuard{
+        //!@return How many times the global operator new has been called since boot
+        size_t allocations();
+    }
+    #endif
+}
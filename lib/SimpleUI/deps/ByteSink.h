@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#ifdef ARDUINO
+    #include <Print.h>
+#else
+    #include <unistd.h>
+#endif
+
+namespace SimpleUI{
+
+    //Where a binary stream goes, a UART on the device, a pipe or a socket on the host
+    class ByteSink{
+        public:
+        virtual ~ByteSink(){}
+        //!@return How many bytes were written, less than asked means the transport failed
+        virtual size_t write(const uint8_t* data, size_t length) = 0;
+    };
+
+    #ifdef ARDUINO
+    //Any Arduino stream, usually a HardwareSerial
+    class PrintSink : public ByteSink{
+        public:
+        explicit PrintSink(Print& out) : m_out(out){}
+        size_t write(const uint8_t* data, size_t length) override { return m_out.write(data, length); }
+
+        private:
+        Print& m_out;
+    };
+    #else
+    //A file descriptor, e.g. one end of a pipe or a connected loopback socket
+    class FdSink : public ByteSink{
+        public:
+        explicit FdSink(int fd) : m_fd(fd){}
+        size_t write(const uint8_t* data, size_t length) override {
+            size_t written = 0;
+            while (written < length){
+                const ssize_t result = ::write(m_fd, data + written, length - written);
+                if (result <= 0)
+                    break;
+                written += static_cast<size_t>(result);
+            }
+            return written;
+        }
+
+        private:
+        int m_fd;
+    };
+    #endif
+
+}
@@ -0,0 +1,25 @@
+#include "Clock.h"
+#ifdef ESP32
+    #include <esp_timer.h>
+#endif
+
+namespace SimpleUI{
+
+    SystemClock& SystemClock::global(){
+        static SystemClock clock;
+        return clock;
+    }
+
+    uint64_t SystemClock::now(){
+        #ifdef ESP32
+        return static_cast<uint64_t>(esp_timer_get_time());
+        #else
+        const uint32_t low = ::micros();
+        if (low < m_last)
+            m_wraps++;
+        m_last = low;
+        return (static_cast<uint64_t>(m_wraps) << 32) | low;
+        #endif
+    }
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <Arduino.h>
+#include <stdint.h>
+
+namespace SimpleUI{
+
+    /*A monotonic source of time in microseconds. The UI owns one and samples it once per frame, everything that animates gets that time
+    handed down instead of reading the hardware timer itself, so time can be faked. It's 64 bits wide so it never wraps around.*/
+    class Clock{
+        public:
+        virtual ~Clock(){}
+        //!@return Microseconds since the clock started
+        virtual uint64_t now() = 0;
+        //!@return The lower 32 bits of now(), for timestamps that only ever get subtracted from each other
+        inline uint32_t micros(){ return static_cast<uint32_t>(now()); }
+    };
+
+    //The hardware timer
+    class SystemClock : public Clock{
+        public:
+        //!@return The clock used until another one is injected
+        static SystemClock& global();
+        uint64_t now() override;
+
+        #ifndef ESP32
+        private:
+        //micros() wraps every ~71 minutes, the wraps seen so far make up the upper half
+        uint32_t m_last = 0;
+        uint32_t m_wraps = 0;
+        #endif
+    };
+
+    //A clock that only moves when told to, for replays, host tests and benchmarks
+    class VirtualClock : public Clock{
+        public:
+        explicit VirtualClock(uint64_t start = 0) : m_now(start){}
+        uint64_t now() override { return m_now; }
+        inline void set(uint64_t now){ m_now = now; }
+        inline void advance(uint64_t time){ m_now += time; }
+
+        private:
+        uint64_t m_now;
+    };
+
+}
@@ -0,0 +1,353 @@
+#include "FrameStream.h"
+#include <string.h>
+
+namespace SimpleUI{
+
+    using namespace FrameStreamFormat;
+
+    static inline void putU16(uint8_t* out, uint16_t value){
+        out[0] = value & 0xFF;
+        out[1] = value >> 8;
+    }
+
+    static inline void putU32(uint8_t* out, uint32_t value){
+        for (uint8_t i = 0; i < 4; i++)
+            out[i] = (value >> (i * 8)) & 0xFF;
+    }
+
+    static inline uint16_t getU16(const uint8_t* in){ return in[0] | (in[1] << 8); }
+    static inline uint32_t getU32(const uint8_t* in){ return in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<uint32_t>(in[3]) << 24); }
+
+//--------------------FrameStreamer CLASS---------------------------------------------------------------//
+
+    FrameStreamer::FrameStreamer(ByteSink* sink, uint16_t width, uint16_t height)
+    : m_sink(sink), m_width(width), m_height(height),
+      m_columns((width + SIMPLEUI_STREAM_TILE - 1) / SIMPLEUI_STREAM_TILE), m_rows((height + SIMPLEUI_STREAM_TILE - 1) / SIMPLEUI_STREAM_TILE)
+    {
+        m_hashes = new uint32_t[m_columns * m_rows]();
+        m_changed = new uint8_t[m_columns * m_rows]();
+    }
+
+    FrameStreamer::~FrameStreamer(){
+        delete[] m_hashes;
+        delete[] m_changed;
+    }
+
+    uint32_t FrameStreamer::m_hashTile(const uint16_t* pixels, uint16_t column, uint16_t row) const {
+        const uint16_t x = column * SIMPLEUI_STREAM_TILE;
+        const uint16_t y = row * SIMPLEUI_STREAM_TILE;
+        const uint16_t w = m_width - x < SIMPLEUI_STREAM_TILE ? m_width - x : SIMPLEUI_STREAM_TILE;
+        const uint16_t h = m_height - y < SIMPLEUI_STREAM_TILE ? m_height - y : SIMPLEUI_STREAM_TILE;
+        uint32_t hash = FNV_BASIS;
+        for (uint16_t j = 0; j < h; j++){
+            const uint16_t* line = pixels + static_cast<size_t>(y + j) * m_width + x;
+            for (uint16_t i = 0; i < w; i++)
+                hash = (hash ^ line[i]) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    //Everything after the magic goes into the checksum, a transport that fails once fails the whole frame
+    bool FrameStreamer::m_write(const uint8_t* data, size_t length){
+        if (m_failed)
+            return false;
+        const size_t skip = m_written < sizeof(MAGIC) ? sizeof(MAGIC) - m_written : 0;
+        for (size_t i = skip; i < length; i++)
+            m_checksum = (m_checksum ^ data[i]) * FNV_PRIME;
+        m_written += length;
+        m_failed = m_sink->write(data, length) != length;
+        return !m_failed;
+    }
+
+    size_t FrameStreamer::send(const uint16_t* pixels){
+        const uint16_t count = getTileCount();
+        const bool key = m_force_key.exchange(false, std::memory_order_relaxed) || (SIMPLEUI_STREAM_KEYFRAME && m_frame % SIMPLEUI_STREAM_KEYFRAME == 0);
+        uint16_t changed = 0;
+        for (uint16_t row = 0, index = 0; row < m_rows; row++){
+            for (uint16_t column = 0; column < m_columns; column++, index++){
+                const uint32_t hash = m_hashTile(pixels, column, row);
+                m_changed[index] = key || hash != m_hashes[index];
+                m_hashes[index] = hash;
+                changed += m_changed[index];
+            }
+        }
+
+        m_checksum = FNV_BASIS;
+        m_written = 0;
+        m_failed = false;
+        uint8_t header[HEADER_SIZE];
+        memcpy(header, MAGIC, sizeof(MAGIC));
+        header[4] = VERSION;
+        header[5] = key ? FLAG_KEY : 0;
+        putU32(header + 6, m_frame);
+        putU16(header + 10, m_width);
+        putU16(header + 12, m_height);
+        header[14] = SIMPLEUI_STREAM_TILE;
+        header[15] = 0;
+        putU16(header + 16, changed);
+        m_write(header, sizeof(header));
+
+        for (uint16_t index = 0; index < count && !m_failed; index++){
+            if (!m_changed[index])
+                continue;
+            const uint16_t x = (index % m_columns) * SIMPLEUI_STREAM_TILE;
+            const uint16_t y = (index / m_columns) * SIMPLEUI_STREAM_TILE;
+            const uint16_t w = m_width - x < SIMPLEUI_STREAM_TILE ? m_width - x : SIMPLEUI_STREAM_TILE;
+            const uint16_t h = m_height - y < SIMPLEUI_STREAM_TILE ? m_height - y : SIMPLEUI_STREAM_TILE;
+            const size_t length = encodeRLE(pixels + static_cast<size_t>(y) * m_width + x, m_width, w, h, m_tile_buffer);
+            uint8_t tile[TILE_HEADER_SIZE];
+            putU16(tile, index);
+            putU16(tile + 2, static_cast<uint16_t>(length));
+            m_write(tile, sizeof(tile));
+            m_write(m_tile_buffer, length);
+        }
+
+        uint8_t checksum[4];
+        putU32(checksum, m_checksum);
+        m_write(checksum, sizeof(checksum));
+
+        m_frame++;
+        //A frame that didn't make it whole leaves the viewer behind, the next one resends everything
+        if (m_failed)
+            m_force_key.store(true, std::memory_order_relaxed);
+        m_last_size = m_failed ? 0 : m_written;
+        return m_last_size;
+    }
+
+    size_t FrameStreamer::encodeRLE(const uint16_t* pixels, size_t stride, uint16_t w, uint16_t h, uint8_t* out){
+        size_t length = 0;
+        size_t literal_at = 0;      //Where the control byte of the open literal is
+        uint8_t literals = 0;       //Pixels in the open literal
+        const size_t count = static_cast<size_t>(w) * h;
+        auto at = [&](size_t i){ return pixels[(i / w) * stride + i % w]; };
+
+        for (size_t i = 0; i < count;){
+            const uint16_t value = at(i);
+            size_t run = 1;
+            while (i + run < count && run < 129 && at(i + run) == value)
+                run++;
+            if (run >= 2){
+                out[length++] = 0x80 | static_cast<uint8_t>(run - 2);
+                putU16(out + length, value);
+                length += 2;
+                literals = 0;
+                i += run;
+                continue;
+            }
+            if (!literals){
+                literal_at = length++;
+            }
+            putU16(out + length, value);
+            length += 2;
+            out[literal_at] = literals++;
+            if (literals == 128)
+                literals = 0;
+            i++;
+        }
+        return length;
+    }
+
+//--------------------FrameStreamDecoder CLASS---------------------------------------------------------------//
+
+    FrameStreamDecoder::~FrameStreamDecoder(){
+        delete[] m_work;
+        delete[] m_pixels;
+        delete[] m_body;
+    }
+
+    bool FrameStreamDecoder::decodeRLE(const uint8_t* data, size_t length, uint16_t* pixels, size_t stride, uint16_t w, uint16_t h){
+        const size_t count = static_cast<size_t>(w) * h;
+        size_t i = 0;
+        size_t at = 0;
+        auto put = [&](uint16_t value){ pixels[(i / w) * stride + i % w] = value; i++; };
+        while (at < length){
+            const uint8_t control = data[at++];
+            const size_t pixels_in = control & 0x80 ? (control & 0x7F) + 2 : control + 1;
+            if (i + pixels_in > count)
+                return false;
+            if (control & 0x80){
+                if (at + 2 > length)
+                    return false;
+                const uint16_t value = getU16(data + at);
+                at += 2;
+                for (size_t n = 0; n < pixels_in; n++)
+                    put(value);
+            }
+            else{
+                if (at + pixels_in * 2 > length)
+                    return false;
+                for (size_t n = 0; n < pixels_in; n++, at += 2)
+                    put(getU16(data + at));
+            }
+        }
+        return i == count;
+    }
+
+    //Drop the frame being received and look for the next magic
+    void FrameStreamDecoder::m_reset(){
+        m_state = State::Magic;
+        m_filled = 0;
+        m_body_size = 0;
+    }
+
+    /*The magic of a broken frame may have been followed by the start of a real one, like the keyframe sent after a frame the transport cut
+    short. Everything after the magic is fed again, each pass works on fewer bytes so this always ends.*/
+    size_t FrameStreamDecoder::m_rescan(){
+        const size_t header = HEADER_SIZE - sizeof(MAGIC);
+        const size_t count = header + m_body_size;
+        uint8_t* pending = new uint8_t[count];
+        memcpy(pending, m_header + sizeof(MAGIC), header);
+        if (m_body_size)
+            memcpy(pending + header, m_body, m_body_size);
+        m_reset();
+        const size_t frames = feed(pending, count);
+        delete[] pending;
+        return frames;
+    }
+
+    bool FrameStreamDecoder::m_beginFrame(){
+        if (m_header[4] != VERSION || m_header[14] == 0 || m_header[14] > SIMPLEUI_STREAM_TILE)
+            return false;
+        const uint16_t width = getU16(m_header + 10);
+        const uint16_t height = getU16(m_header + 12);
+        if (!width || !height)
+            return false;
+        m_key = m_header[5] & FLAG_KEY;
+        if (width != m_width || height != m_height){
+            //A new size can only start from a keyframe
+            if (!m_key)
+                return false;
+            delete[] m_work;
+            delete[] m_pixels;
+            m_width = width;
+            m_height = height;
+            m_work = new uint16_t[static_cast<size_t>(width) * height]();
+            m_pixels = new uint16_t[static_cast<size_t>(width) * height]();
+            m_synced = false;
+        }
+        const uint32_t frame = getU32(m_header + 6);
+        if (!m_key && (!m_synced || frame != m_frame + 1))
+            return false;
+        m_columns = (width + m_header[14] - 1) / m_header[14];
+        m_rows = (height + m_header[14] - 1) / m_header[14];
+        m_tiles_left = getU16(m_header + 16);
+        if (m_tiles_left > m_columns * m_rows)
+            return false;
+        const size_t body = static_cast<size_t>(m_tiles_left) * (TILE_HEADER_SIZE + MAX_TILE_BYTES) + 4;
+        if (body > m_body_capacity){
+            delete[] m_body;
+            m_body_capacity = static_cast<size_t>(m_columns) * m_rows * (TILE_HEADER_SIZE + MAX_TILE_BYTES) + 4;
+            m_body = new uint8_t[m_body_capacity];
+        }
+        memcpy(m_work, m_pixels, static_cast<size_t>(width) * height * sizeof(uint16_t));
+        return true;
+    }
+
+    bool FrameStreamDecoder::m_applyTile(){
+        const uint8_t edge = m_header[14];
+        if (m_tile_index >= m_columns * m_rows)
+            return false;
+        const uint16_t x = (m_tile_index % m_columns) * edge;
+        const uint16_t y = (m_tile_index / m_columns) * edge;
+        const uint16_t w = m_width - x < edge ? m_width - x : edge;
+        const uint16_t h = m_height - y < edge ? m_height - y : edge;
+        return decodeRLE(m_tile_buffer, m_expected, m_work + static_cast<size_t>(y) * m_width + x, m_width, w, h);
+    }
+
+    void FrameStreamDecoder::m_endFrame(){
+        uint16_t* done = m_work;
+        m_work = m_pixels;
+        m_pixels = done;
+        m_frame = getU32(m_header + 6);
+        m_tiles = getU16(m_header + 16);
+        m_frame_size = m_size;
+        m_synced = true;
+        if (m_callback)
+            m_callback(*this, m_context);
+    }
+
+    size_t FrameStreamDecoder::feed(const uint8_t* data, size_t length){
+        size_t frames = 0;
+        for (size_t i = 0; i < length; i++){
+            const uint8_t byte = data[i];
+            m_size++;
+            switch (m_state){
+                case State::Magic:
+                    //A mismatch may itself be the start of the magic
+                    m_filled = byte == MAGIC[m_filled] ? m_filled + 1 : byte == MAGIC[0];
+                    if (m_filled == sizeof(MAGIC)){
+                        m_state = State::Header;
+                        m_checksum = FNV_BASIS;
+                        m_size = sizeof(MAGIC);
+                        m_expected = HEADER_SIZE;
+                    }
+                    break;
+
+                case State::Header:
+                    m_header[m_filled++] = byte;
+                    m_hash(byte);
+                    if (m_filled < m_expected)
+                        break;
+                    if (!m_beginFrame()){
+                        m_errors++;
+                        frames += m_rescan();
+                        break;
+                    }
+                    m_state = m_tiles_left ? State::TileHeader : State::Checksum;
+                    m_filled = 0;
+                    m_expected = m_tiles_left ? TILE_HEADER_SIZE : 4;
+                    break;
+
+                case State::TileHeader:
+                    m_body[m_body_size++] = byte;
+                    m_tile_buffer[m_filled++] = byte;
+                    m_hash(byte);
+                    if (m_filled < m_expected)
+                        break;
+                    m_tile_index = getU16(m_tile_buffer);
+                    m_expected = getU16(m_tile_buffer + 2);
+                    m_filled = 0;
+                    if (!m_expected || m_expected > sizeof(m_tile_buffer)){
+                        m_errors++;
+                        frames += m_rescan();
+                        break;
+                    }
+                    m_state = State::TileData;
+                    break;
+
+                case State::TileData:
+                    m_body[m_body_size++] = byte;
+                    m_tile_buffer[m_filled++] = byte;
+                    m_hash(byte);
+                    if (m_filled < m_expected)
+                        break;
+                    if (!m_applyTile()){
+                        m_errors++;
+                        frames += m_rescan();
+                        break;
+                    }
+                    m_filled = 0;
+                    m_state = --m_tiles_left ? State::TileHeader : State::Checksum;
+                    m_expected = m_tiles_left ? TILE_HEADER_SIZE : 4;
+                    break;
+
+                case State::Checksum:
+                    m_body[m_body_size++] = byte;
+                    m_tile_buffer[m_filled++] = byte;
+                    if (m_filled < 4)
+                        break;
+                    if (getU32(m_tile_buffer) != m_checksum){
+                        m_errors++;
+                        frames += m_rescan();
+                        break;
+                    }
+                    m_endFrame();
+                    frames++;
+                    m_reset();
+                    break;
+            }
+        }
+        return frames;
+    }
+
+}
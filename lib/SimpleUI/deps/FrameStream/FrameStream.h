@@ -0,0 +1,160 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include "ByteSink.h"
+
+//Edge in pixels of the square tiles a frame is compared and sent in
+#define SIMPLEUI_STREAM_TILE 16
+//Every this many frames all the tiles are sent, so a viewer that joins late or lost bytes catches up. 0 only sends the first frame whole
+#define SIMPLEUI_STREAM_KEYFRAME 120
+
+namespace SimpleUI{
+
+    /*
+    The framebuffer stream, every value is little endian:
+
+    Frame   magic "SUIF" | version u8 | flags u8 | frame u32 | width u16 | height u16 | tile u8 | reserved u8 | tiles u16 | tile... | checksum u32
+    Tile    index u16 (row major) | length u16 | length bytes of RLE pixels, the tile's rows one after another clipped to the frame
+    RLE     control byte c: if c & 0x80 the next pixel repeats (c & 0x7F) + 2 times, else c + 1 literal pixels follow
+    The checksum is FNV-1a over every byte after the magic. A frame without FLAG_KEY only holds the tiles that changed since the last one.
+    */
+    namespace FrameStreamFormat{
+        static constexpr uint8_t MAGIC[4] = {'S', 'U', 'I', 'F'};
+        static constexpr uint8_t VERSION = 1;
+        static constexpr uint8_t FLAG_KEY = 1;
+        static constexpr size_t HEADER_SIZE = 18;   //Magic included
+        static constexpr size_t TILE_HEADER_SIZE = 4;
+        static constexpr uint32_t FNV_BASIS = 2166136261UL;
+        static constexpr uint32_t FNV_PRIME = 16777619UL;
+        //Bytes of the worst case RLE of a full tile, every pixel a literal
+        static constexpr size_t MAX_TILE_BYTES = SIMPLEUI_STREAM_TILE * SIMPLEUI_STREAM_TILE * 2 + (SIMPLEUI_STREAM_TILE * SIMPLEUI_STREAM_TILE + 127) / 128;
+    }
+
+    /*Sends a framebuffer as the tiles that changed since the previous frame. Only a hash of every tile is kept rather than a copy of the
+    frame, the periodic keyframes cover the unlikely collisions. What is sent scales with how much changes on screen, not with its size.*/
+    class FrameStreamer{
+        public:
+        /*!
+            @param sink   Where the frames are written, it must outlive the streamer
+            @param width  Width of the frames in pixels
+            @param height Height of the frames in pixels
+        */
+        FrameStreamer(ByteSink* sink, uint16_t width, uint16_t height);
+        ~FrameStreamer();
+        FrameStreamer(const FrameStreamer&) = delete;
+        FrameStreamer& operator=(const FrameStreamer&) = delete;
+
+        /*!
+            @brief Send the tiles of a frame that changed since the last one, nothing but the header and checksum if none did
+            @param pixels RGB565 pixels of the frame, row major
+            @return How many bytes were written, 0 if the transport failed
+        */
+        size_t send(const uint16_t* pixels);
+        //!@brief Send every tile of the next frame, safe to call from another task than the one sending
+        inline void requestKeyframe(){ m_force_key.store(true, std::memory_order_relaxed); }
+
+        inline uint32_t getFrames() const { return m_frame; }
+        //!@return The bytes written by the last send()
+        inline size_t getLastSize() const { return m_last_size; }
+        inline uint16_t getTileCount() const { return m_columns * m_rows; }
+
+        /*!
+            @brief Compress a rectangle of RGB565 pixels with the stream's RLE
+            @param out Must hold FrameStreamFormat::MAX_TILE_BYTES for a tile, or 2 bytes per pixel plus a byte every 128 in general
+            @return How many bytes were written
+        */
+        static size_t encodeRLE(const uint16_t* pixels, size_t stride, uint16_t w, uint16_t h, uint8_t* out);
+
+        private:
+        uint32_t m_hashTile(const uint16_t* pixels, uint16_t column, uint16_t row) const;
+        bool m_write(const uint8_t* data, size_t length);
+
+        ByteSink* m_sink;
+        uint16_t m_width, m_height;
+        uint16_t m_columns, m_rows;
+        uint32_t* m_hashes;
+        uint8_t* m_changed;   //One flag per tile for the frame being sent
+        uint32_t m_frame = 0;
+        uint32_t m_checksum = 0;
+        size_t m_written = 0;
+        size_t m_last_size = 0;
+        std::atomic<bool> m_force_key{true};
+        bool m_failed = false;
+        uint8_t m_tile_buffer[FrameStreamFormat::MAX_TILE_BYTES];
+    };
+
+    /*Rebuilds the frames of a stream from its bytes, fed in chunks of any size as they arrive. Bytes that aren't part of a frame, like
+    text printed on the same UART, are skipped. A frame is only applied once its checksum matches, and after a lost frame the deltas
+    are ignored until the next keyframe. The bytes of a broken frame are searched again for the start of the next one, a frame cut short
+    swallows the keyframe the sender follows it with otherwise.*/
+    class FrameStreamDecoder{
+        public:
+        using FrameCallback = void (*)(const FrameStreamDecoder& decoder, void* context);
+
+        FrameStreamDecoder() = default;
+        ~FrameStreamDecoder();
+        FrameStreamDecoder(const FrameStreamDecoder&) = delete;
+        FrameStreamDecoder& operator=(const FrameStreamDecoder&) = delete;
+
+        //!@param callback Called with every frame once it's complete, getPixels() then holds it
+        inline void onFrame(FrameCallback callback, void* context = nullptr){ m_callback = callback; m_context = context; }
+        //!@return How many frames were completed by these bytes
+        size_t feed(const uint8_t* data, size_t length);
+
+        //!@return The last complete frame, nullptr before the first keyframe
+        inline const uint16_t* getPixels() const { return m_synced ? m_pixels : nullptr; }
+        inline uint16_t getWidth() const { return m_width; }
+        inline uint16_t getHeight() const { return m_height; }
+        //!@return The number the sender gave to the last complete frame
+        inline uint32_t getFrame() const { return m_frame; }
+        //!@return The bytes of the last complete frame, header and checksum included
+        inline size_t getFrameSize() const { return m_frame_size; }
+        //!@return How many tiles the last complete frame updated
+        inline uint16_t getFrameTiles() const { return m_tiles; }
+        //!@return How many frames were dropped for a bad checksum, a malformed tile or a gap in the numbering
+        inline uint32_t getErrors() const { return m_errors; }
+
+        //!@return False if the RLE doesn't fill exactly w * h pixels
+        static bool decodeRLE(const uint8_t* data, size_t length, uint16_t* pixels, size_t stride, uint16_t w, uint16_t h);
+
+        private:
+        enum class State : uint8_t {Magic, Header, TileHeader, TileData, Checksum};
+
+        void m_reset();
+        bool m_beginFrame();
+        bool m_applyTile();
+        void m_endFrame();
+        size_t m_rescan();
+        inline void m_hash(uint8_t byte){ m_checksum = (m_checksum ^ byte) * FrameStreamFormat::FNV_PRIME; }
+
+        State m_state = State::Magic;
+        uint8_t m_header[FrameStreamFormat::HEADER_SIZE];
+        uint8_t m_tile_buffer[FrameStreamFormat::MAX_TILE_BYTES];
+        size_t m_filled = 0;     //Bytes collected for the current state
+        size_t m_expected = 0;   //Bytes the current state needs
+        uint32_t m_checksum = 0;
+        size_t m_size = 0;
+        uint8_t* m_body = nullptr;     //What came after the header of the frame being received, fed again if the frame turns out broken
+        size_t m_body_size = 0;
+        size_t m_body_capacity = 0;
+
+        //The frame being received, only copied into m_pixels when it's complete
+        uint16_t* m_work = nullptr;
+        uint16_t* m_pixels = nullptr;
+        uint16_t m_width = 0, m_height = 0;
+        uint16_t m_columns = 0, m_rows = 0;
+        uint16_t m_tiles_left = 0;
+        uint16_t m_tile_index = 0;
+        bool m_key = false;
+
+        uint32_t m_frame = 0;
+        uint16_t m_tiles = 0;
+        size_t m_frame_size = 0;
+        uint32_t m_errors = 0;
+        bool m_synced = false;
+        FrameCallback m_callback = nullptr;
+        void* m_context = nullptr;
+    };
+
+}
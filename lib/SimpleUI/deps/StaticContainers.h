@@ -0,0 +1,199 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
+#include <assert.h>
+
+/*Fixed capacity replacements for the standard containers used by SimpleUI. They keep their storage inline, so their size is known at link time
+and they never touch the heap. Inserting into a full container fails and returns false instead of growing.*/
+
+namespace StaticContainers{
+
+    //A vector with inline storage for up to N elements
+    template<typename T, size_t N>
+    class StaticVector{
+        public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        StaticVector() = default;
+        StaticVector(std::initializer_list<T> init){ for (const T& value : init) push_back(value); }
+        StaticVector(const StaticVector& other){ for (const T& value : other) push_back(value); }
+        StaticVector& operator=(const StaticVector& other){
+            if (this != &other){
+                clear();
+                for (const T& value : other)
+                    push_back(value);
+            }
+            return *this;
+        }
+        ~StaticVector(){ clear(); }
+
+        bool push_back(const T& value){
+            if (m_size >= N)
+                return false;
+            new (&data()[m_size++]) T(value);
+            return true;
+        }
+        template<typename... Args>
+        bool emplace_back(Args&&... args){
+            if (m_size >= N)
+                return false;
+            new (&data()[m_size++]) T(std::forward<Args>(args)...);
+            return true;
+        }
+        void pop_back(){ data()[--m_size].~T(); }
+        void clear(){
+            while (m_size)
+                pop_back();
+        }
+        void assign(size_t count, const T& value){
+            clear();
+            for (size_t i = 0; i < count && i < N; i++)
+                push_back(value);
+        }
+        iterator erase(iterator first, iterator last){
+            iterator out = first;
+            for (iterator in = last; in != end(); in++, out++)
+                *out = std::move(*in);
+            while (end() != out)
+                pop_back();
+            return first;
+        }
+
+        inline T& operator[](size_t i){ return data()[i]; }
+        inline const T& operator[](size_t i) const { return data()[i]; }
+        inline T& back(){ return data()[m_size - 1]; }
+        inline const T& back() const { return data()[m_size - 1]; }
+        inline iterator begin(){ return data(); }
+        inline iterator end(){ return data() + m_size; }
+        inline const_iterator begin() const { return data(); }
+        inline const_iterator end() const { return data() + m_size; }
+        inline size_t size() const { return m_size; }
+        inline bool empty() const { return m_size == 0; }
+        static constexpr size_t capacity(){ return N; }
+
+        private:
+        inline T* data(){ return reinterpret_cast<T*>(m_storage); }
+        inline const T* data() const { return reinterpret_cast<const T*>(m_storage); }
+        alignas(T) uint8_t m_storage[N * sizeof(T)];
+        size_t m_size = 0;
+    };
+
+    //A map with inline storage for up to N entries, lookups are linear which is the fastest option for the sizes a UI deals with
+    template<typename K, typename V, size_t N>
+    class StaticMap{
+        public:
+        using value_type = std::pair<K, V>;
+        using iterator = value_type*;
+        using const_iterator = const value_type*;
+
+        std::pair<iterator, bool> insert(const value_type& entry){
+            iterator found = find(entry.first);
+            if (found != end())
+                return {found, false};
+            if (!m_entries.push_back(entry))
+                return {end(), false};
+            return {&m_entries.back(), true};
+        }
+        iterator find(const K& key){
+            for (value_type& entry : m_entries){
+                if (entry.first == key)
+                    return &entry;
+            }
+            return end();
+        }
+        const_iterator find(const K& key) const {
+            for (const value_type& entry : m_entries){
+                if (entry.first == key)
+                    return &entry;
+            }
+            return end();
+        }
+        //Unlike the standard one this doesn't throw, a missing key gives a default constructed value
+        V at(const K& key) const {
+            const_iterator found = find(key);
+            return found != end() ? found->second : V();
+        }
+        //A full map has no entry to give for a new key, use insert() where that can happen
+        V& operator[](const K& key){
+            iterator found = find(key);
+            if (found != end())
+                return found->second;
+            const bool inserted = m_entries.push_back({key, V()});
+            assert(inserted && "StaticMap is full");
+            (void)inserted;
+            return m_entries.back().second;
+        }
+        inline size_t count(const K& key) const { return find(key) != end(); }
+        inline void clear(){ m_entries.clear(); }
+        inline iterator begin(){ return m_entries.begin(); }
+        inline iterator end(){ return m_entries.end(); }
+        inline const_iterator begin() const { return m_entries.begin(); }
+        inline const_iterator end() const { return m_entries.end(); }
+        inline size_t size() const { return m_entries.size(); }
+        inline bool empty() const { return m_entries.empty(); }
+
+        private:
+        StaticVector<value_type, N> m_entries;
+    };
+
+    template<typename Signature, size_t Size>
+    class InplaceFunction;
+
+    //A callable wrapper like std::function, the callable is stored inline and the ones that don't fit are rejected at compile time
+    template<typename R, typename... Args, size_t Size>
+    class InplaceFunction<R(Args...), Size>{
+        public:
+        InplaceFunction() = default;
+
+        template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, InplaceFunction>::value>::type>
+        InplaceFunction(F&& func){
+            using Callable = typename std::decay<F>::type;
+            static_assert(sizeof(Callable) <= Size, "The callable doesn't fit, raise SIMPLEUI_CALLBACK_SIZE");
+            static_assert(alignof(Callable) <= alignof(max_align_t), "The callable is over-aligned");
+            new (m_storage) Callable(std::forward<F>(func));
+            m_invoke = [](void* storage, Args... args) -> R { return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...); };
+            m_manage = [](void* dst, const void* src){
+                if (src)
+                    new (dst) Callable(*static_cast<const Callable*>(src));
+                else
+                    static_cast<Callable*>(dst)->~Callable();
+            };
+        }
+        InplaceFunction(const InplaceFunction& other){ copyFrom(other); }
+        InplaceFunction& operator=(const InplaceFunction& other){
+            if (this != &other){
+                reset();
+                copyFrom(other);
+            }
+            return *this;
+        }
+        ~InplaceFunction(){ reset(); }
+
+        inline R operator()(Args... args) const { return m_invoke(m_storage, std::forward<Args>(args)...); }
+        inline explicit operator bool() const { return m_invoke != nullptr; }
+
+        private:
+        void reset(){
+            if (m_manage)
+                m_manage(m_storage, nullptr);
+            m_invoke = nullptr;
+            m_manage = nullptr;
+        }
+        void copyFrom(const InplaceFunction& other){
+            if (other.m_manage)
+                other.m_manage(m_storage, other.m_storage);
+            m_invoke = other.m_invoke;
+            m_manage = other.m_manage;
+        }
+        alignas(max_align_t) mutable uint8_t m_storage[Size];
+        R (*m_invoke)(void*, Args...) = nullptr;
+        void (*m_manage)(void*, const void*) = nullptr;
+    };
+}
@@ -0,0 +1,244 @@
+#include "Telemetry.h"
+#include <string.h>
+
+namespace SimpleUI{
+
+    using namespace TelemetryFormat;
+
+    //Little endian field by field, the layout doesn't depend on how the compiler pads the record structs
+    class PayloadWriter{
+        public:
+        explicit PayloadWriter(uint8_t* out) : m_out(out){}
+        inline void u8(uint8_t value){ m_out[m_length++] = value; }
+        inline void u16(uint16_t value){ u8(value & 0xFF); u8(value >> 8); }
+        inline void u32(uint32_t value){ u16(value & 0xFFFF); u16(value >> 16); }
+        inline void f32(float value){ uint32_t bits; memcpy(&bits, &value, sizeof(bits)); u32(bits); }
+        inline uint8_t length() const { return m_length; }
+
+        private:
+        uint8_t* m_out;
+        uint8_t m_length = 0;
+    };
+
+    class PayloadReader{
+        public:
+        PayloadReader(const uint8_t* in, uint8_t length) : m_in(in), m_length(length){}
+        inline uint8_t u8(){ return m_at < m_length ? m_in[m_at++] : (m_at++, 0); }
+        inline uint16_t u16(){ const uint16_t low = u8(); return low | (u8() << 8); }
+        inline uint32_t u32(){ const uint32_t low = u16(); return low | (static_cast<uint32_t>(u16()) << 16); }
+        inline float f32(){ const uint32_t bits = u32(); float value; memcpy(&value, &bits, sizeof(value)); return value; }
+        //!@return True if exactly the whole payload was read
+        inline bool done() const { return m_at == m_length; }
+        inline uint8_t remaining() const { return m_at < m_length ? m_length - m_at : 0; }
+
+        private:
+        const uint8_t* m_in;
+        uint8_t m_length;
+        uint8_t m_at = 0;
+    };
+
+    static uint16_t fletcher16(const uint8_t* data, size_t length, uint16_t sums = 0){
+        uint16_t low = sums & 0xFF, high = sums >> 8;
+        for (size_t i = 0; i < length; i++){
+            low = (low + data[i]) % 255;
+            high = (high + low) % 255;
+        }
+        return (high << 8) | low;
+    }
+
+//--------------------TelemetryWriter CLASS---------------------------------------------------------------//
+
+    bool TelemetryWriter::m_send(TelemetryType type, const uint8_t* payload, uint8_t length){
+        uint8_t record[HEADER_SIZE + 255 + 2];
+        record[0] = SYNC[0];
+        record[1] = SYNC[1];
+        record[2] = VERSION;
+        record[3] = static_cast<uint8_t>(type);
+        record[4] = length;
+        memcpy(record + HEADER_SIZE, payload, length);
+        const uint16_t checksum = fletcher16(record + 2, HEADER_SIZE - 2 + length);
+        record[HEADER_SIZE + length] = checksum & 0xFF;
+        record[HEADER_SIZE + length + 1] = checksum >> 8;
+        const size_t size = HEADER_SIZE + length + 2;
+        const size_t written = m_sink->write(record, size);
+        m_written += written;
+        return written == size;
+    }
+
+    bool TelemetryWriter::write(const FrameRecord& record){
+        uint8_t payload[16];
+        PayloadWriter out(payload);
+        out.u32(record.frame);
+        out.u32(record.time);
+        out.u32(record.interval);
+        out.u32(record.render);
+        return m_send(TelemetryType::Frame, payload, out.length());
+    }
+
+    bool TelemetryWriter::write(const HeapRecord& record){
+        uint8_t payload[16];
+        PayloadWriter out(payload);
+        out.u32(record.free);
+        out.u32(record.min_free);
+        out.u32(record.largest_block);
+        out.u32(record.arena_peak);
+        return m_send(TelemetryType::Heap, payload, out.length());
+    }
+
+    bool TelemetryWriter::write(const SiteRecord& record){
+        uint8_t payload[MAX_PAYLOAD];
+        PayloadWriter out(payload);
+        out.u16(record.id);
+        for (size_t i = 0; i < SIMPLEUI_TELEMETRY_NAME && record.name[i]; i++)
+            out.u8(record.name[i]);
+        return m_send(TelemetryType::Site, payload, out.length());
+    }
+
+    bool TelemetryWriter::write(const ProfileRecord& record){
+        uint8_t payload[6];
+        PayloadWriter out(payload);
+        out.u16(record.id);
+        out.u32(record.max_time);
+        return m_send(TelemetryType::Profile, payload, out.length());
+    }
+
+    bool TelemetryWriter::write(const FocusRecord& record){
+        uint8_t payload[8];
+        PayloadWriter out(payload);
+        out.u32(record.frame);
+        out.u16(record.element);
+        out.u8(record.scene);
+        out.u8(record.flags);
+        return m_send(TelemetryType::Focus, payload, out.length());
+    }
+
+    bool TelemetryWriter::write(const AnimationRecord& record){
+        uint8_t payload[13];
+        PayloadWriter out(payload);
+        out.u16(record.used);
+        out.u16(record.overflows);
+        out.u16(record.running);
+        out.u16(record.dirty);
+        out.u8(record.state);
+        out.f32(record.progress);
+        return m_send(TelemetryType::Animations, payload, out.length());
+    }
+
+//--------------------TelemetryDecoder CLASS---------------------------------------------------------------//
+
+    bool TelemetryDecoder::decode(TelemetryType type, const uint8_t* payload, uint8_t length, TelemetryRecord& record){
+        PayloadReader in(payload, length);
+        record.type = type;
+        switch (type){
+            case TelemetryType::Frame:
+                record.frame = {in.u32(), in.u32(), in.u32(), in.u32()};
+                break;
+            case TelemetryType::Heap:
+                record.heap = {in.u32(), in.u32(), in.u32(), in.u32()};
+                break;
+            case TelemetryType::Site:{
+                record.site.id = in.u16();
+                const uint8_t name = in.remaining() < SIMPLEUI_TELEMETRY_NAME ? in.remaining() : SIMPLEUI_TELEMETRY_NAME;
+                for (uint8_t i = 0; i < name; i++)
+                    record.site.name[i] = static_cast<char>(in.u8());
+                record.site.name[name] = '\0';
+                break;
+            }
+            case TelemetryType::Profile:
+                record.profile.id = in.u16();
+                record.profile.max_time = in.u32();
+                break;
+            case TelemetryType::Focus:
+                record.focus.frame = in.u32();
+                record.focus.element = in.u16();
+                record.focus.scene = in.u8();
+                record.focus.flags = in.u8();
+                break;
+            case TelemetryType::Animations:
+                record.animations.used = in.u16();
+                record.animations.overflows = in.u16();
+                record.animations.running = in.u16();
+                record.animations.dirty = in.u16();
+                record.animations.state = in.u8();
+                record.animations.progress = in.f32();
+                break;
+            default:
+                return false;
+        }
+        return in.done();
+    }
+
+    size_t TelemetryDecoder::feed(const uint8_t* data, size_t length){
+        size_t records = 0;
+        for (size_t i = 0; i < length; i++)
+            records += m_push(data[i]);
+        return records;
+    }
+
+    //!@return How many records the byte completed, more than one when it ends a rescan
+    size_t TelemetryDecoder::m_push(uint8_t byte){
+        switch (m_state){
+            case State::Sync:
+                //A mismatch may itself be the start of the sync
+                m_filled = byte == SYNC[m_filled] ? m_filled + 1 : byte == SYNC[0];
+                if (m_filled == sizeof(SYNC)){
+                    memcpy(m_record, SYNC, sizeof(SYNC));
+                    m_state = State::Header;
+                }
+                return 0;
+
+            case State::Header:
+                m_record[m_filled++] = byte;
+                if (m_filled < HEADER_SIZE)
+                    return 0;
+                if (m_record[2] != VERSION){
+                    m_errors++;
+                    return m_rescan();
+                }
+                m_expected = HEADER_SIZE + m_record[4] + 2;
+                m_state = State::Record;
+                return 0;
+
+            case State::Record:
+                m_record[m_filled++] = byte;
+                if (m_filled < m_expected)
+                    return 0;
+                return m_complete();
+        }
+        return 0;
+    }
+
+    size_t TelemetryDecoder::m_complete(){
+        const uint8_t length = m_record[4];
+        const uint16_t checksum = m_record[HEADER_SIZE + length] | (m_record[HEADER_SIZE + length + 1] << 8);
+        if (checksum != fletcher16(m_record + 2, HEADER_SIZE - 2 + length)){
+            m_errors++;
+            return m_rescan();
+        }
+        m_state = State::Sync;
+        m_filled = 0;
+        TelemetryRecord record;
+        if (!decode(static_cast<TelemetryType>(m_record[3]), m_record + HEADER_SIZE, length, record)){
+            m_skipped++;
+            return 0;
+        }
+        if (m_callback)
+            m_callback(record, m_context);
+        return 1;
+    }
+
+    /*A sync that turned out to be part of something else, like text, may have swallowed the start of real records. The bytes after it
+    are fed again, each pass works on fewer bytes so this always ends.*/
+    size_t TelemetryDecoder::m_rescan(){
+        uint8_t pending[MAX_RECORD];
+        const size_t count = m_filled - 1;
+        memcpy(pending, m_record + 1, count);
+        m_state = State::Sync;
+        m_filled = 0;
+        size_t records = 0;
+        for (size_t i = 0; i < count; i++)
+            records += m_push(pending[i]);
+        return records;
+    }
+
+}
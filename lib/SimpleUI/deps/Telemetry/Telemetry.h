@@ -0,0 +1,145 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "ByteSink.h"
+
+//Longest profiler site name a record carries, longer ones are cut
+#define SIMPLEUI_TELEMETRY_NAME 48
+
+namespace SimpleUI{
+
+    /*
+    The telemetry stream is a sequence of records, every value is little endian:
+
+    Record  sync 0xA5 0x5A | version u8 | type u8 | length u8 | payload | checksum u16
+    The checksum is Fletcher-16 over version, type, length and payload. Every type has a fixed payload layout, a decoder skips the
+    types it doesn't know by their length, so new ones can be added without breaking older decoders.
+
+    Frame       frame u32 | time u32 | interval u32 | render u32             Microseconds, time is the UI's frame time
+    Heap        free u32 | min_free u32 | largest_block u32 | arena_peak u32 Bytes
+    Site        id u16 | name                                              Names a profiler site, sent before its first Profile
+    Profile     id u16 | max_time u32                                      Longest time measured at a site, in microseconds
+    Focus       frame u32 | element u16 | scene u8 | flags u8              Scene is its index in the UI, see FocusRecord flags
+    Animations  used u16 | overflows u16 | running u16 | dirty u16 | state u8 | progress f32    State and progress of the focused element's animation
+    */
+    namespace TelemetryFormat{
+        static constexpr uint8_t SYNC[2] = {0xA5, 0x5A};
+        static constexpr uint8_t VERSION = 1;
+        static constexpr size_t HEADER_SIZE = 5;    //Sync included
+        static constexpr size_t MAX_PAYLOAD = 2 + SIMPLEUI_TELEMETRY_NAME;
+        static constexpr size_t MAX_RECORD = HEADER_SIZE + 255 + 2;
+    }
+
+    enum class TelemetryType : uint8_t {Frame = 1, Heap, Site, Profile, Focus, Animations};
+
+    struct FrameRecord{
+        uint32_t frame;
+        uint32_t time;
+        uint32_t interval;  //Since the previous frame
+        uint32_t render;    //Spent rendering
+    };
+
+    struct HeapRecord{
+        uint32_t free;
+        uint32_t min_free;        //Lowest free heap since boot
+        uint32_t largest_block;
+        uint32_t arena_peak;      //Most bytes the frame arena held in a frame
+    };
+
+    struct SiteRecord{
+        uint16_t id;
+        char name[SIMPLEUI_TELEMETRY_NAME + 1];
+    };
+
+    struct ProfileRecord{
+        uint16_t id;
+        uint32_t max_time;
+    };
+
+    struct FocusRecord{
+        enum Flags : uint8_t {GLIDING = 1, TRANSITIONING = 2, PENDING = 4};
+        uint32_t frame;
+        uint16_t element;
+        uint8_t scene;
+        uint8_t flags;
+    };
+
+    struct AnimationRecord{
+        uint16_t used;
+        uint16_t overflows;
+        uint16_t running;
+        uint16_t dirty;
+        uint8_t state;      //AnimState of the focused element's animation, 0xFF if it has none
+        float progress;
+    };
+
+    //A decoded record, only the member matching the type is meaningful
+    struct TelemetryRecord{
+        TelemetryType type;
+        union{
+            FrameRecord frame;
+            HeapRecord heap;
+            SiteRecord site;
+            ProfileRecord profile;
+            FocusRecord focus;
+            AnimationRecord animations;
+        };
+    };
+
+    //Frames records onto a sink, each record is a single write so records from different places never interleave
+    class TelemetryWriter{
+        public:
+        explicit TelemetryWriter(ByteSink* sink) : m_sink(sink){}
+
+        bool write(const FrameRecord& record);
+        bool write(const HeapRecord& record);
+        bool write(const SiteRecord& record);
+        bool write(const ProfileRecord& record);
+        bool write(const FocusRecord& record);
+        bool write(const AnimationRecord& record);
+        //!@return How many bytes were written so far
+        inline size_t getWritten() const { return m_written; }
+
+        private:
+        bool m_send(TelemetryType type, const uint8_t* payload, uint8_t length);
+
+        ByteSink* m_sink;
+        size_t m_written = 0;
+    };
+
+    /*Turns the bytes of a telemetry stream back into records, fed in chunks of any size. Bytes outside of a record, like text or a
+    framebuffer stream on the same UART, are skipped.*/
+    class TelemetryDecoder{
+        public:
+        using RecordCallback = void (*)(const TelemetryRecord& record, void* context);
+
+        inline void onRecord(RecordCallback callback, void* context = nullptr){ m_callback = callback; m_context = context; }
+        //!@return How many records were completed by these bytes
+        size_t feed(const uint8_t* data, size_t length);
+        //!@return How many records were dropped for a bad checksum or an unknown version, false syncs in other data included
+        inline uint32_t getErrors() const { return m_errors; }
+        //!@return How many records of an unknown type were skipped
+        inline uint32_t getSkipped() const { return m_skipped; }
+
+        //!@return False if the payload doesn't match the layout of its type
+        static bool decode(TelemetryType type, const uint8_t* payload, uint8_t length, TelemetryRecord& record);
+
+        private:
+        enum class State : uint8_t {Sync, Header, Record};
+
+        size_t m_push(uint8_t byte);
+        size_t m_complete();
+        size_t m_rescan();
+
+        State m_state = State::Sync;
+        //The record being received from its sync on, kept whole so a rejected one can be searched for the next sync
+        uint8_t m_record[TelemetryFormat::MAX_RECORD];
+        size_t m_filled = 0;
+        size_t m_expected = 0;
+        uint32_t m_errors = 0;
+        uint32_t m_skipped = 0;
+        RecordCallback m_callback = nullptr;
+        void* m_context = nullptr;
+    };
+
+}
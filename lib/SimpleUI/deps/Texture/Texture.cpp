@@ -1,4 +1,6 @@
 #include "Texture.h"
+#include <climits>
+#include "Workers.h"
 
 const float Fmap(const float x, const float in_min, const float in_max, const float out_min, const float out_max)
 {
@@ -28,6 +30,11 @@ bool dirtyRects(Texture first, Texture second){
                 first.data.mono[i] = second.data.mono[i];
             }
         }
+        break;
+
+        //Palette, compressed and alpha textures aren't compared pixel by pixel
+        default:
+        return false;
     }
     return areDifferent;
 }
@@ -38,29 +45,6 @@ void transferFrame(uint16_t* emitter, uint16_t* receiver, size_t len){
 }
 
 
-const uint16_t rgb565(unsigned int r, unsigned int g, unsigned int b){
-    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
-}
-const uint16_t hex(std::string hex) {
-    if(hex.length() == 7){
-        // Assumes valid 7-character input like "#RRGGBB"
-        uint8_t r = ((hex[1] <= '9' ? hex[1] - '0' : (hex[1] & ~0x20) - 'A' + 10) << 4)
-                | (hex[2] <= '9' ? hex[2] - '0' : (hex[2] & ~0x20) - 'A' + 10);
-        uint8_t g = ((hex[3] <= '9' ? hex[3] - '0' : (hex[3] & ~0x20) - 'A' + 10) << 4)
-                | (hex[4] <= '9' ? hex[4] - '0' : (hex[4] & ~0x20) - 'A' + 10);
-        uint8_t b = ((hex[5] <= '9' ? hex[5] - '0' : (hex[5] & ~0x20) - 'A' + 10) << 4)
-                | (hex[6] <= '9' ? hex[6] - '0' : (hex[6] & ~0x20) - 'A' + 10);
-
-        // Convert to RGB565
-        return ((r & 0xF8) << 8) |  // 5 bits red
-            ((g & 0xFC) << 3) |  // 6 bits green
-            (b >> 3);            // 5 bits blue
-    }
-    else{
-        return 0;
-    }
-}
-
 int Texture::getArrSize8(int width, int height, float scale_fac) {
         int w = static_cast<int>(width * scale_fac);
         int h = static_cast<int>(height * scale_fac);
@@ -71,57 +55,721 @@ int Texture::getArrSize16 (int width, int height, float scale_fac){
     return (static_cast<int>(width * scale_fac) * static_cast<int>(height * scale_fac));
     }
 
-const Texture scale(Texture& input, const float scaling_factor){
-    if (scaling_factor == 1.0f)
+//Takes the output buffer from the arena when one is provided, the heap is only used if there's none or it's full
+template<typename T>
+static T* scaleBuffer(size_t len, SimpleUI::FrameArena* arena, bool& owner){
+    T* buffer = arena ? arena->allocate<T>(len) : nullptr;
+    owner = !buffer;
+    if (!buffer){
+        if (arena)
+            arena->countOverflow();
+        buffer = new T[len];
+    }
+    return buffer;
+}
+
+//!@return Whether the bit of a pixel is set in a 1 bit per pixel row
+static inline bool isLit(const uint8_t* row, unsigned int x){
+    return row[x / 8] & (0x80 >> (x % 8));
+}
+
+//Scratch memory for the tables of a single scaling, taken from the arena like the output
+template<typename T>
+struct ScaleTable{
+    T* data;
+    bool owner;
+    ScaleTable(size_t len, SimpleUI::FrameArena* arena) : data(scaleBuffer<T>(len, arena, owner)){}
+    ~ScaleTable(){ if (owner) delete[] data; }
+    inline T& operator[](size_t i){ return data[i]; }
+};
+
+//The two source pixels a bilinear sample mixes and the weight of the second one, from 0 to 32
+struct BilinearTap{
+    uint16_t index, next;
+    uint8_t weight;
+};
+
+//The source pixels a box sample covers, the first and the last one can be partially covered. Weights are in 1/256 of a pixel
+struct BoxTap{
+    uint16_t first, last;
+    uint16_t first_weight, last_weight;
+};
+
+//Samples are taken at the center of the scaled pixels, the edges repeat the outermost source pixel
+static BilinearTap bilinearTap(unsigned int dst, unsigned int source_len, const ScaleStep& step){
+    const int32_t pos = static_cast<int32_t>(dst * step.step + step.step / 2) - 0x8000;
+    const uint32_t clamped = pos > 0 ? pos : 0;
+    const unsigned int index = std::min<unsigned int>(clamped >> 16, source_len - 1);
+    return {static_cast<uint16_t>(index), static_cast<uint16_t>(std::min(index + 1, source_len - 1)), static_cast<uint8_t>((clamped >> 11) & 0x1F)};
+}
+
+static BoxTap boxTap(unsigned int dst, const ScaleStep& step){
+    const uint32_t begin = (dst * step.step) >> 8;
+    const uint32_t end = ((dst + 1) * step.step) >> 8;
+    BoxTap tap;
+    tap.first = begin >> 8;
+    tap.last = (end - 1) >> 8;
+    tap.first_weight = tap.first == tap.last ? end - begin : 256 - (begin & 0xFF);
+    tap.last_weight = end - (tap.last << 8);
+    return tap;
+}
+
+//!@return How much of a source pixel a box tap covers, in 1/256 of a pixel
+static inline uint32_t boxWeight(const BoxTap& tap, unsigned int src){
+    return src == tap.first ? tap.first_weight : src == tap.last ? tap.last_weight : 256;
+}
+
+/*Rows sampling the same source row are copied instead of being sampled again. The first row of every range of rows is always sampled,
+so the ranges rendered by the workers never read each other's output.*/
+static Texture scaleNearest(const Texture& input, unsigned int scaled_width, unsigned int scaled_height, const ScaleStep& step, SimpleUI::FrameArena* arena){
+    ScaleTable<uint16_t> columns(scaled_width, arena);
+    for (unsigned int x = 0; x < scaled_width; x++)
+        columns[x] = std::min(step.source(x), input.width - 1);
+
+    bool owner;
+    if (input.data.colorspace == PixelType::Mono){
+        const size_t in_row_bytes = (input.width + 7) / 8;
+        const size_t out_row_bytes = (scaled_width + 7) / 8;
+        uint8_t* buffer = scaleBuffer<uint8_t>(out_row_bytes * scaled_height, arena, owner);
+        SimpleUI::parallelRows(scaled_height, scaled_width, [&](unsigned int first_row, unsigned int last_row){
+            unsigned int previous = UINT_MAX;
+            for (unsigned int y = first_row; y < last_row; y++){
+                uint8_t* out = buffer + y * out_row_bytes;
+                const unsigned int src_y = std::min(step.source(y), input.height - 1);
+                if (src_y == previous){
+                    memcpy(out, out - out_row_bytes, out_row_bytes);
+                    continue;
+                }
+                previous = src_y;
+                const uint8_t* row = input.data.mono + src_y * in_row_bytes;
+                //Every output byte is assembled in a register and stored once
+                for (size_t b = 0; b < out_row_bytes; b++){
+                    uint8_t byte = 0;
+                    const unsigned int end = std::min<unsigned int>(b * 8 + 8, scaled_width);
+                    for (unsigned int x = b * 8; x < end; x++){
+                        if (isLit(row, columns[x]))
+                            byte |= 0x80 >> (x % 8);
+                    }
+                    out[b] = byte;
+                }
+            }
+        });
+        return Texture(scaled_width, scaled_height, buffer, owner);
+    }
+
+    uint16_t* buffer = scaleBuffer<uint16_t>(static_cast<size_t>(scaled_width) * scaled_height, arena, owner);
+    SimpleUI::parallelRows(scaled_height, scaled_width, [&](unsigned int first_row, unsigned int last_row){
+        unsigned int previous = UINT_MAX;
+        for (unsigned int y = first_row; y < last_row; y++){
+            uint16_t* out = buffer + y * scaled_width;
+            const unsigned int src_y = std::min(step.source(y), input.height - 1);
+            if (src_y == previous){
+                memcpy(out, out - scaled_width, scaled_width * sizeof(uint16_t));
+                continue;
+            }
+            previous = src_y;
+            const uint16_t* row = input.data.rgb565 + src_y * input.width;
+            for (unsigned int x = 0; x < scaled_width; x++)
+                out[x] = row[columns[x]];
+        }
+    });
+    return Texture(scaled_width, scaled_height, buffer, owner);
+}
+
+static Texture scaleBilinear(const Texture& input, unsigned int scaled_width, unsigned int scaled_height, const ScaleStep& step, SimpleUI::FrameArena* arena){
+    ScaleTable<BilinearTap> columns(scaled_width, arena);
+    for (unsigned int x = 0; x < scaled_width; x++)
+        columns[x] = bilinearTap(x, input.width, step);
+
+    bool owner;
+    uint16_t* buffer = scaleBuffer<uint16_t>(static_cast<size_t>(scaled_width) * scaled_height, arena, owner);
+    SimpleUI::parallelRows(scaled_height, scaled_width, [&](unsigned int first_row, unsigned int last_row){
+        for (unsigned int y = first_row; y < last_row; y++){
+            const BilinearTap tap = bilinearTap(y, input.height, step);
+            const uint16_t* top = input.data.rgb565 + tap.index * input.width;
+            const uint16_t* bottom = input.data.rgb565 + tap.next * input.width;
+            uint16_t* out = buffer + y * scaled_width;
+            for (unsigned int x = 0; x < scaled_width; x++){
+                const BilinearTap& column = columns[x];
+                const uint16_t upper = blend565(top[column.index], top[column.next], column.weight);
+                const uint16_t lower = blend565(bottom[column.index], bottom[column.next], column.weight);
+                out[x] = blend565(upper, lower, tap.weight);
+            }
+        }
+    });
+    return Texture(scaled_width, scaled_height, buffer, owner);
+}
+
+/*Every scaled pixel is the weighted sum of the source pixels under it. RGB565 channels are averaged, Mono pixels are counted into a 4 bit
+coverage that becomes the alpha of a RGB565A4 texture of the mono color.*/
+static Texture scaleBox(const Texture& input, unsigned int scaled_width, unsigned int scaled_height, const ScaleStep& step, SimpleUI::FrameArena* arena,
+                        uint16_t mono_color){
+    ScaleTable<BoxTap> columns(scaled_width, arena);
+    for (unsigned int x = 0; x < scaled_width; x++)
+        columns[x] = boxTap(x, step);
+
+    const bool mono = input.data.colorspace == PixelType::Mono;
+    const size_t in_row_bytes = (input.width + 7) / 8;
+    const size_t pixels = static_cast<size_t>(scaled_width) * scaled_height;
+    const size_t alpha_row_bytes = (scaled_width + 1) / 2;
+    //The alpha plane of a Mono texture is allocated right after its colors so that the two are owned together
+    const size_t alpha_words = mono ? (alpha_row_bytes * scaled_height + 1) / 2 : 0;
+    bool owner;
+    uint16_t* buffer = scaleBuffer<uint16_t>(pixels + alpha_words, arena, owner);
+    uint8_t* alpha = mono ? reinterpret_cast<uint8_t*>(buffer + pixels) : nullptr;
+    if (mono){
+        std::fill(buffer, buffer + pixels, mono_color);
+        std::fill(alpha, alpha + alpha_row_bytes * scaled_height, 0);
+    }
+
+    SimpleUI::parallelRows(scaled_height, scaled_width, [&](unsigned int first_row, unsigned int last_row){
+        for (unsigned int y = first_row; y < last_row; y++){
+            const BoxTap rows = boxTap(y, step);
+            for (unsigned int x = 0; x < scaled_width; x++){
+                const BoxTap& column = columns[x];
+                //Partial sums of a row stay in 32 bits, only the sum weighted by the row's coverage needs more
+                uint64_t sum[3] = {};
+                uint64_t total = 0;
+                for (unsigned int src_y = rows.first; src_y <= rows.last && src_y < input.height; src_y++){
+                    const uint32_t row_weight = boxWeight(rows, src_y);
+                    uint32_t row_sum[3] = {};
+                    uint32_t row_total = 0;
+                    for (unsigned int src_x = column.first; src_x <= column.last && src_x < input.width; src_x++){
+                        const uint32_t weight = boxWeight(column, src_x);
+                        row_total += weight;
+                        if (mono){
+                            if (isLit(input.data.mono + src_y * in_row_bytes, src_x))
+                                row_sum[0] += weight;
+                        }
+                        else{
+                            const uint16_t color = input.data.rgb565[src_y * input.width + src_x];
+                            row_sum[0] += (color >> 11) * weight;
+                            row_sum[1] += ((color >> 5) & 0x3F) * weight;
+                            row_sum[2] += (color & 0x1F) * weight;
+                        }
+                    }
+                    for (int c = 0; c < 3; c++)
+                        sum[c] += static_cast<uint64_t>(row_sum[c]) * row_weight;
+                    total += static_cast<uint64_t>(row_total) * row_weight;
+                }
+                if (!total)
+                    continue;
+                if (mono){
+                    const uint8_t coverage = static_cast<uint8_t>((sum[0] * 15 + total / 2) / total);
+                    alpha[y * alpha_row_bytes + x / 2] |= coverage << (x % 2 ? 0 : 4);
+                }
+                else{
+                    const uint16_t r = static_cast<uint16_t>((sum[0] + total / 2) / total);
+                    const uint16_t g = static_cast<uint16_t>((sum[1] + total / 2) / total);
+                    const uint16_t b = static_cast<uint16_t>((sum[2] + total / 2) / total);
+                    buffer[y * scaled_width + x] = (r << 11) | (g << 5) | b;
+                }
+            }
+        }
+    });
+    if (mono)
+        return Texture(scaled_width, scaled_height, PixelType::RGB565A4, buffer, alpha, owner);
+    return Texture(scaled_width, scaled_height, buffer, owner);
+}
+
+/*!
+    @brief Scale a raw texture, the sampling positions come from per column tables and a fixed point step, there's no float math per pixel
+    @param input            The texture to scale
+    @param scaling_factor   The output size relative to the input
+    @param arena            Where the scaled pixels are allocated, when provided they only live until the arena is reset
+    @param filter           How the scaled pixels are sampled, see ScaleFilter
+    @param mono_color       The color of a box filtered Mono texture
+*/
+const Texture scale(Texture& input, const float scaling_factor, SimpleUI::FrameArena* arena, ScaleFilter filter, uint16_t mono_color){
+    if (scaling_factor == 1.0f || isEncoded(input.data.colorspace))   //Compressed textures are scaled while drawTexture() decodes them
         return input;
     const unsigned int scaled_width = static_cast<const unsigned int>(input.width * scaling_factor);
     const unsigned int scaled_height = static_cast<const unsigned int>(input.height * scaling_factor);
+    if (!scaled_width || !scaled_height)
+        return Texture(0, 0, static_cast<uint8_t*>(nullptr));
+    const ScaleStep step(scaling_factor);
 
-    if(input.data.colorspace==PixelType::Mono){
-        const size_t outputArrSize = Texture::getArrSize8(scaled_width, scaled_height, 1.0f);
-        uint8_t *buffer = new uint8_t[outputArrSize];
-        std::fill(buffer, buffer + outputArrSize, 0);
+    if (filter == ScaleFilter::Bilinear && input.data.colorspace == PixelType::Mono)
+        filter = ScaleFilter::Box;
+    if (filter == ScaleFilter::Box && scaling_factor > 1.0f)    //Growing covers less than a pixel, there's nothing to average
+        filter = input.data.colorspace == PixelType::Mono ? ScaleFilter::Nearest : ScaleFilter::Bilinear;
+    switch (filter){
+        case ScaleFilter::Bilinear: return scaleBilinear(input, scaled_width, scaled_height, step, arena);
+        case ScaleFilter::Box:      return scaleBox(input, scaled_width, scaled_height, step, arena, mono_color);
+        default:                    return scaleNearest(input, scaled_width, scaled_height, step, arena);
+    }
+}
 
-        const int in_row_bytes = (input.width + 7) / 8;
-        const int out_row_bytes = (scaled_width + 7) / 8;
-        const float inv_scaling = 1.0f / scaling_factor;
+//--------------------Compressed textures---------------------------------------------------------------//
 
-        for (unsigned int y = 0; y < scaled_height; y++)
-        {
-            const size_t dst_row_base = y * out_row_bytes;
-            unsigned const int src_y = static_cast<unsigned int>(y * inv_scaling);
+//Writes the source pixels of a row to the canvas, mapping them to the scaled columns with the same nearest neighbor rule as scale()
+struct RowWriter{
+    uint16_t* out;      //The canvas row, shifted so that 0 is the left edge of the texture
+    int begin, end;     //The scaled columns that are on the canvas
+    ScaleStep step;
+    uint8_t opacity;    //0 to 32, applied on top of the texture's own alpha
 
-            for (unsigned int x = 0; x < scaled_width; x++){
-                // Map to source pixel using nearest neighbor
-                unsigned const int src_x = static_cast<unsigned int>(x * inv_scaling);
-                // Get the index of the byte containing the pixel we look for
-                const size_t src_byte_index = src_y * in_row_bytes + src_x / 8;
-                const uint8_t src_mask = 0x80 >> (src_x % 8);
-                const bool pixel_on = input.data.mono[src_byte_index] & src_mask; // See if pixel is on or off
-
-                // Set the output pixel at the scaled coordinates to the result of the previous check
-                if (pixel_on){
-                    const size_t dst_byte_index = dst_row_base + x / 8;
-                    const uint8_t dst_mask = 0x80 >> (x % 8);
-                    buffer[dst_byte_index] |= dst_mask;
+    //!@return The first scaled column that samples the source column
+    inline int column(unsigned int src) const { return static_cast<int>(step.first(src)); }
+    inline void fill(unsigned int src_begin, unsigned int src_end, uint16_t color){
+        const int from = std::max(column(src_begin), begin);
+        const int to = std::min(column(src_end), end);
+        if (opacity >= 32){
+            for (int x = from; x < to; x++)
+                out[x] = color;
+        }
+        else{
+            for (int x = from; x < to; x++)
+                out[x] = blend565(out[x], color, opacity);
+        }
+    }
+    //Every column is given the color of the source pixel it samples
+    template<typename F>
+    inline void sample(unsigned int src_begin, unsigned int src_end, F colorAt){
+        const int from = std::max(column(src_begin), begin);
+        const int to = std::min(column(src_end), end);
+        if (opacity >= 32){
+            for (int x = from; x < to; x++)
+                out[x] = colorAt(step.source(x));
+        }
+        else{
+            for (int x = from; x < to; x++)
+                out[x] = blend565(out[x], colorAt(step.source(x)), opacity);
+        }
+    }
+    //Like sample(), but every source pixel is blended with its own alpha, from 0 to 32
+    template<typename F, typename A>
+    inline void blend(unsigned int src_begin, unsigned int src_end, F colorAt, A alphaAt){
+        const int from = std::max(column(src_begin), begin);
+        const int to = std::min(column(src_end), end);
+        for (int x = from; x < to; x++){
+            const unsigned int src = step.source(x);
+            out[x] = blend565(out[x], colorAt(src), (alphaAt(src) * opacity) >> 5);
+        }
+    }
+};
+
+
+//!@return The alpha of a pixel in a 4 bit per pixel row, scaled from 0 to 32
+static inline uint8_t alpha4(const uint8_t* row, unsigned int x){
+    const uint8_t alpha = (row[x / 2] >> (x % 2 ? 0 : 4)) & 0x0F;
+    return (alpha * 32 + 7) / 15;
+}
+
+//Calls span(begin, end) for every run of lit pixels of a 1 bit per pixel row
+template<typename F>
+static inline void forEachLit(const uint8_t* row, unsigned int width, F span){
+    for (unsigned int x = 0; x < width;){
+        if (!isLit(row, x)){
+            x++;
+            continue;
+        }
+        const unsigned int start = x;
+        while (x < width && isLit(row, x))
+            x++;
+        span(start, x);
+    }
+}
+
+static inline uint16_t readColor(const uint8_t* bytes){
+    return bytes[0] | (bytes[1] << 8);
+}
+
+//!@return The start of the row after the given one
+static const uint8_t* nextRow(const Texture& texture, const uint8_t* row){
+    switch (texture.data.colorspace){
+        case PixelType::RGB565A1:
+            return row + (texture.width + 7) / 8;
+        case PixelType::RGB565A4:
+            return row + (texture.width + 1) / 2;
+        case PixelType::RLEMono:
+            return row + 1 + 2 * row[0];
+        case PixelType::RLE565:{
+            for (unsigned int x = 0; x < texture.width;){
+                const uint8_t header = *row++;
+                const unsigned int count = (header & 0x3F) + 1;
+                switch (header >> 6){
+                    case 0:  row += 2 * count; break;
+                    case 1:  row += 2;         break;
+                    default:                   break;
                 }
+                x += count;
             }
+            return row;
         }
-        return Texture(scaled_width, scaled_height, std::move(buffer), true);
+        default:
+            return row + (texture.width * static_cast<unsigned int>(texture.data.colorspace) + 7) / 8;
     }
-    else{
-        size_t outputArrSize = Texture::getArrSize16(scaled_width, scaled_height, 1.0f);
-        uint16_t *buffer = new uint16_t[outputArrSize];
+}
 
-        const float inv_scaling = 1.0f / scaling_factor;
-        for (unsigned int y = 0; y < scaled_height; y++){
-            unsigned const int src_y = static_cast<unsigned int>(y * inv_scaling);
+//!@return The start of a later row, rows of a fixed size are reached at once and the run length encoded ones are walked
+static const uint8_t* seekRow(const Texture& texture, const uint8_t* row, unsigned int from, unsigned int to){
+    switch (texture.data.colorspace){
+        case PixelType::RLEMono:
+        case PixelType::RLE565:
+            for (; from < to; from++)
+                row = nextRow(texture, row);
+            return row;
+        default:
+            return from < to ? row + (nextRow(texture, row) - row) * (to - from) : row;
+    }
+}
 
-            for (unsigned int x = 0; x < scaled_width; x++){
-                unsigned const int src_x = static_cast<unsigned int>(x * inv_scaling);
-                buffer[y * scaled_width + x] = input.data.rgb565[(src_y * input.width) + src_x];
+//Records the color and the alpha, from 0 to 32, of every scaled column of a row instead of drawing it, used by decode()
+struct DecodeWriter{
+    uint16_t* colors;
+    uint8_t* alpha;
+    int begin, end;
+    ScaleStep step;
+
+    inline int column(unsigned int src) const { return static_cast<int>(step.first(src)); }
+    inline void fill(unsigned int src_begin, unsigned int src_end, uint16_t color){
+        for (int x = std::max(column(src_begin), begin); x < std::min(column(src_end), end); x++){
+            colors[x] = color;
+            alpha[x] = 32;
+        }
+    }
+    template<typename F>
+    inline void sample(unsigned int src_begin, unsigned int src_end, F colorAt){
+        blend(src_begin, src_end, colorAt, [](unsigned int){ return 32; });
+    }
+    template<typename F, typename A>
+    inline void blend(unsigned int src_begin, unsigned int src_end, F colorAt, A alphaAt){
+        for (int x = std::max(column(src_begin), begin); x < std::min(column(src_end), end); x++){
+            const unsigned int src = step.source(x);
+            colors[x] = colorAt(src);
+            alpha[x] = alphaAt(src);
+        }
+    }
+};
+
+template<typename Writer>
+static void decodeRow(const Texture& texture, const uint8_t* row, unsigned int src_y, Writer& writer, uint16_t mono_color){
+    const uint16_t* colors = texture.data.rgb565 + src_y * texture.width;    //Only meaningful for the RGB565 formats
+    const auto colorAt = [colors](unsigned int src){ return colors[src]; };
+    switch (texture.data.colorspace){
+        case PixelType::Mono:
+            forEachLit(row, texture.width, [&](unsigned int begin, unsigned int end){ writer.fill(begin, end, mono_color); });
+            break;
+        case PixelType::RGB565:
+            writer.sample(0, texture.width, colorAt);
+            break;
+        case PixelType::RGB565A1:
+            forEachLit(row, texture.width, [&](unsigned int begin, unsigned int end){ writer.sample(begin, end, colorAt); });
+            break;
+        case PixelType::RGB565A4:{
+            //Transparent spans are skipped, opaque ones copied and only the ones in between are blended
+            for (unsigned int x = 0; x < texture.width;){
+                const uint8_t alpha = alpha4(row, x);
+                const unsigned int start = x;
+                if (alpha == 0){
+                    while (x < texture.width && alpha4(row, x) == 0)
+                        x++;
+                }
+                else if (alpha == 32){
+                    while (x < texture.width && alpha4(row, x) == 32)
+                        x++;
+                    writer.sample(start, x, colorAt);
+                }
+                else{
+                    while (x < texture.width && alpha4(row, x) != 0 && alpha4(row, x) != 32)
+                        x++;
+                    writer.blend(start, x, colorAt, [row](unsigned int src){ return alpha4(row, src); });
+                }
+            }
+            break;
+        }
+        case PixelType::RLEMono:{
+            unsigned int x = 0;
+            const uint8_t* run = row + 1;
+            for (uint8_t i = 0; i < row[0]; i++, run += 2){
+                x += run[0];
+                writer.fill(x, x + run[1], mono_color);
+                x += run[1];
+            }
+            break;
+        }
+        case PixelType::RLE565:{
+            for (unsigned int x = 0; x < texture.width;){
+                const uint8_t header = *row++;
+                const unsigned int count = (header & 0x3F) + 1;
+                switch (header >> 6){
+                    case 0:{
+                        writer.sample(x, x + count, [row, x](unsigned int src){ return readColor(row + 2 * (src - x)); });
+                        row += 2 * count;
+                        break;
+                    }
+                    case 1:
+                        writer.fill(x, x + count, readColor(row));
+                        row += 2;
+                        break;
+                    default:
+                        break;
+                }
+                x += count;
+            }
+            break;
+        }
+        default:{
+            const unsigned int bits = static_cast<unsigned int>(texture.data.colorspace);
+            const uint8_t mask = (1 << bits) - 1;
+            const uint16_t* palette = texture.data.palette;
+            writer.sample(0, texture.width, [row, bits, mask, palette](unsigned int src){
+                const unsigned int bit = src * bits;
+                return palette[(row[bit / 8] >> (8 - bits - bit % 8)) & mask];
+            });
+            break;
+        }
+    }
+}
+
+/*!
+    @brief Decode a texture straight into a canvas, one row at a time and without any intermediate buffer. Transparent runs are
+    skipped without touching the canvas, opaque ones are copied and only the partially transparent pixels are blended.
+    @param canvas           Where the texture is drawn
+    @param texture          A texture in any format
+    @param x                X coordinate of the top left corner
+    @param y                Y coordinate of the top left corner
+    @param scaling_factor   The drawn size relative to the texture, sampled like scale() does
+    @param mono_color       The color of the lit pixels of Mono and RLEMono textures
+    @param opacity          How opaque the whole texture is, from 0 to 32
+*/
+void drawTexture(GFXcanvas16* canvas, const Texture& texture, int x, int y, float scaling_factor, uint16_t mono_color, uint8_t opacity){
+    const bool has_alpha = texture.data.colorspace == PixelType::RGB565A1 || texture.data.colorspace == PixelType::RGB565A4;
+    const uint8_t* row = has_alpha ? texture.data.alpha : texture.data.encoded;
+    if (!row || !opacity)
+        return;
+    const int scaled_width = static_cast<int>(texture.width * scaling_factor);
+    const int scaled_height = static_cast<int>(texture.height * scaling_factor);
+    const int canvas_width = canvas->width();
+    const int canvas_height = canvas->height();
+    if (scaled_width <= 0 || scaled_height <= 0 || x >= canvas_width || y >= canvas_height || x + scaled_width <= 0)
+        return;
+
+    //Only the rows on the canvas are split across the workers, each range finds its own first source row
+    const unsigned int first_visible = std::max(-y, 0);
+    const unsigned int last_visible = std::min(scaled_height, canvas_height - y);
+    const RowWriter writer{nullptr, std::max(-x, 0), std::min(scaled_width, canvas_width - x), ScaleStep(scaling_factor), opacity};
+    if (first_visible >= last_visible)
+        return;
+    const uint8_t* const first_row = row;
+    SimpleUI::parallelRows(last_visible - first_visible, writer.end - writer.begin, [&](unsigned int begin, unsigned int end){
+        RowWriter range_writer = writer;
+        unsigned int row_index = 0;
+        const uint8_t* range_row = first_row;
+        for (unsigned int dst_y = first_visible + begin; dst_y < first_visible + end; dst_y++){
+            const unsigned int src_y = std::min(writer.step.source(dst_y), texture.height - 1);
+            range_row = seekRow(texture, range_row, row_index, src_y);
+            row_index = src_y;
+            range_writer.out = canvas->getBuffer() + (y + static_cast<int>(dst_y)) * canvas_width + x;
+            decodeRow(texture, range_row, src_y, range_writer, mono_color);
+        }
+    });
+}
+
+/*!
+    @brief Decode and scale a texture once into a raw one that drawTexture() copies at its own size, it's drawn exactly like the source
+    would be at the same factor. Palette2, Palette4 and RGB565 become RGB565, every other format RGB565A4 with its transparency kept.
+    @param input            A texture in any format
+    @param scaling_factor   The size of the output relative to the input, sampled like drawTexture() does
+    @param mono_color       The color of the lit pixels of Mono and RLEMono textures
+    @return A texture that owns its pixels, empty if the input has no pixels or the scaled size is 0
+*/
+const Texture decode(const Texture& input, const float scaling_factor, uint16_t mono_color){
+    const bool has_alpha = input.data.colorspace == PixelType::RGB565A1 || input.data.colorspace == PixelType::RGB565A4;
+    const uint8_t* row = has_alpha ? input.data.alpha : input.data.encoded;
+    const unsigned int scaled_width = static_cast<unsigned int>(input.width * scaling_factor);
+    const unsigned int scaled_height = static_cast<unsigned int>(input.height * scaling_factor);
+    if (!row || !scaled_width || !scaled_height)
+        return Texture(0, 0, static_cast<uint8_t*>(nullptr));
+
+    const PixelType type = input.data.colorspace;
+    const bool opaque = type == PixelType::RGB565 || type == PixelType::Palette2 || type == PixelType::Palette4;
+    const size_t pixels = static_cast<size_t>(scaled_width) * scaled_height;
+    const size_t alpha_row_bytes = (scaled_width + 1) / 2;
+    //The alpha plane is allocated right after the colors so that the two are owned together
+    uint16_t* colors = new uint16_t[pixels + (opaque ? 0 : (alpha_row_bytes * scaled_height + 1) / 2)]();
+    uint8_t* alpha = opaque ? nullptr : reinterpret_cast<uint8_t*>(colors + pixels);
+    uint8_t* row_alpha = new uint8_t[scaled_width];
+
+    DecodeWriter writer{nullptr, row_alpha, 0, static_cast<int>(scaled_width), ScaleStep(scaling_factor)};
+    unsigned int row_index = 0;
+    for (unsigned int dst_y = 0; dst_y < scaled_height; dst_y++){
+        const unsigned int src_y = std::min(writer.step.source(dst_y), input.height - 1);
+        row = seekRow(input, row, row_index, src_y);
+        row_index = src_y;
+        writer.colors = colors + dst_y * scaled_width;
+        memset(row_alpha, 0, scaled_width);
+        decodeRow(input, row, src_y, writer, mono_color);
+        if (opaque)
+            continue;
+        uint8_t* packed = alpha + dst_y * alpha_row_bytes;
+        memset(packed, 0, alpha_row_bytes);
+        for (unsigned int x = 0; x < scaled_width; x++)
+            packed[x / 2] |= ((row_alpha[x] * 15 + 16) / 32) << (x % 2 ? 0 : 4);
+    }
+    delete[] row_alpha;
+    if (opaque)
+        return Texture(scaled_width, scaled_height, colors, true);
+    return Texture(scaled_width, scaled_height, PixelType::RGB565A4, colors, alpha, true);
+}
+
+//Appends bytes while counting them, nothing is written past the capacity or when there's no output
+struct EncodeBuffer{
+    uint8_t* output;
+    size_t capacity;
+    size_t size = 0;
+    inline void push(uint8_t byte){
+        if (output && size < capacity)
+            output[size] = byte;
+        size++;
+    }
+    inline void pushColor(uint16_t color){ push(color & 0xFF); push(color >> 8); }
+    inline size_t result() const { return !output || size <= capacity ? size : 0; }
+};
+
+/*!
+    @brief Compress a Mono texture to RLEMono
+    @param output   Where the encoded rows are written, nullptr to only measure them
+    @return The size of the encoded texture, 0 if it doesn't fit in the output or can't be encoded
+*/
+size_t encodeRLEMono(const Texture& input, uint8_t* output, size_t capacity){
+    if (input.data.colorspace != PixelType::Mono || input.width > 255)
+        return 0;
+    EncodeBuffer buffer{output, capacity};
+    const unsigned int row_bytes = (input.width + 7) / 8;
+    uint8_t runs[128][2];
+    for (unsigned int y = 0; y < input.height; y++){
+        const uint8_t* row = input.data.mono + y * row_bytes;
+        uint8_t count = 0;
+        unsigned int previous_end = 0;
+        for (unsigned int x = 0; x < input.width;){
+            if (!(row[x / 8] & (0x80 >> (x % 8)))){
+                x++;
+                continue;
+            }
+            const unsigned int start = x;
+            while (x < input.width && (row[x / 8] & (0x80 >> (x % 8))))
+                x++;
+            runs[count][0] = start - previous_end;
+            runs[count][1] = x - start;
+            previous_end = x;
+            count++;
+        }
+        buffer.push(count);
+        for (uint8_t i = 0; i < count; i++){
+            buffer.push(runs[i][0]);
+            buffer.push(runs[i][1]);
+        }
+    }
+    return buffer.result();
+}
+
+/*!
+    @brief Compress an RGB565 texture to RLE565
+    @param output       Where the encoded rows are written, nullptr to only measure them
+    @param transparent  The color that is encoded as transparent, -1 for none
+    @return The size of the encoded texture, 0 if it doesn't fit in the output or can't be encoded
+*/
+size_t encodeRLE565(const Texture& input, uint8_t* output, size_t capacity, int32_t transparent){
+    if (input.data.colorspace != PixelType::RGB565)
+        return 0;
+    EncodeBuffer buffer{output, capacity};
+    for (unsigned int y = 0; y < input.height; y++){
+        const uint16_t* row = input.data.rgb565 + y * input.width;
+        for (unsigned int x = 0; x < input.width;){
+            unsigned int run = 1;
+            while (x + run < input.width && run < 64 && row[x + run] == row[x])
+                run++;
+            if (row[x] == transparent){
+                buffer.push(0x80 | (run - 1));
+            }
+            else if (run > 1){
+                buffer.push(0x40 | (run - 1));
+                buffer.pushColor(row[x]);
+            }
+            else{   //A literal lasts until two equal pixels or a transparent one start a run
+                while (x + run < input.width && run < 64 && row[x + run] != transparent
+                       && (x + run + 1 >= input.width || row[x + run] != row[x + run + 1]))
+                    run++;
+                buffer.push(run - 1);
+                for (unsigned int i = 0; i < run; i++)
+                    buffer.pushColor(row[x + i]);
+            }
+            x += run;
+        }
+    }
+    return buffer.result();
+}
+
+/*!
+    @brief Compress an RGB565 texture to Palette2 or Palette4
+    @param format   PixelType::Palette2 or PixelType::Palette4
+    @param palette  Filled with the colors of the texture, it needs room for 4 or 16 of them
+    @param output   Where the packed rows are written, nullptr to only measure them
+    @return The size of the encoded texture, 0 if it doesn't fit in the output or has more colors than the palette
+*/
+size_t encodePalette(const Texture& input, PixelType format, uint16_t* palette, uint8_t* output, size_t capacity){
+    if (input.data.colorspace != PixelType::RGB565 || (format != PixelType::Palette2 && format != PixelType::Palette4))
+        return 0;
+    const unsigned int bits = static_cast<unsigned int>(format);
+    const unsigned int colors = 1 << bits;
+    unsigned int used = 0;
+    EncodeBuffer buffer{output, capacity};
+    for (unsigned int y = 0; y < input.height; y++){
+        uint8_t byte = 0;
+        unsigned int filled = 0;
+        for (unsigned int x = 0; x < input.width; x++){
+            const uint16_t color = input.data.rgb565[y * input.width + x];
+            unsigned int index = 0;
+            while (index < used && palette[index] != color)
+                index++;
+            if (index == used){
+                if (used == colors)
+                    return 0;
+                palette[used++] = color;
+            }
+            byte |= index << (8 - bits - filled);
+            filled += bits;
+            if (filled == 8){
+                buffer.push(byte);
+                byte = 0;
+                filled = 0;
+            }
+        }
+        if (filled)
+            buffer.push(byte);
+    }
+    return buffer.result();
+}
+
+/*!
+    @brief Build the alpha plane of an RGB565A1 or RGB565A4 texture
+    @param alpha    One byte per pixel, from 0 (transparent) to 255 (opaque)
+    @param format   PixelType::RGB565A1, pixels are kept if their alpha is at least half, or PixelType::RGB565A4
+    @param output   Where the packed rows are written, nullptr to only measure them
+    @return The size of the plane, 0 if it doesn't fit in the output
+*/
+size_t encodeAlpha(const uint8_t* alpha, unsigned int width, unsigned int height, PixelType format, uint8_t* output, size_t capacity){
+    if (format != PixelType::RGB565A1 && format != PixelType::RGB565A4)
+        return 0;
+    const unsigned int bits = format == PixelType::RGB565A1 ? 1 : 4;
+    EncodeBuffer buffer{output, capacity};
+    for (unsigned int y = 0; y < height; y++){
+        uint8_t byte = 0;
+        unsigned int filled = 0;
+        for (unsigned int x = 0; x < width; x++){
+            const uint8_t value = alpha[y * width + x];
+            byte |= (bits == 1 ? value >= 128 : (value * 15 + 127) / 255) << (8 - bits - filled);
+            filled += bits;
+            if (filled == 8){
+                buffer.push(byte);
+                byte = 0;
+                filled = 0;
             }
         }
-        return Texture(scaled_width, scaled_height, std::move(buffer), true);
+        if (filled)
+            buffer.push(byte);
     }
+    return buffer.result();
 }
@@ -3,9 +3,27 @@
 #include <math.h>
 #include <Arduino.h>
 #include <string.h>
+#include <string>
+#include <Adafruit_GFX.h>
+#include "Arena.h"
 
 
-enum class PixelType{Mono=1, RGB565=16};
+/*Mono and RGB565 are raw bitmaps, the others are compressed and drawn with drawTexture(). Every row of a compressed texture
+is encoded on its own:
+    RLEMono    A byte with the number of lit runs, then a (gap from the previous run, length) byte pair per run. Width up to 255
+    Palette2   2 bit indices into a 4 color palette, packed from the most significant bit, every row starts on a new byte
+    Palette4   4 bit indices into a 16 color palette, same packing as Palette2
+    RLE565     Packets with a header byte: the top two bits are the kind and the other six the pixel count minus one.
+               0 is a literal followed by its colors, 1 a run followed by one color, 2 a run of transparent pixels.
+               Colors are little endian.
+    RGB565A1   Raw RGB565 colors with a separate 1 bit per pixel mask, packed like Mono. Unset pixels aren't drawn
+    RGB565A4   Raw RGB565 colors with a separate 4 bit per pixel alpha plane, two pixels per byte starting from the high nibble*/
+enum class PixelType{Mono=1, Palette2=2, Palette4=4, RGB565=16, RLEMono=17, RLE565=18, RGB565A1=19, RGB565A4=20};
+
+//!@return True if the pixels have to be decoded by drawTexture()
+constexpr bool isEncoded(PixelType type){
+    return type != PixelType::Mono && type != PixelType::RGB565;
+}
 
 //A wrapper for supporting multiple data types used in the Texture structure
 struct TextureData{
@@ -13,10 +31,15 @@ struct TextureData{
     union{
         uint8_t* mono;
         uint16_t* rgb565;
+        const uint8_t* encoded;
     };
+    const uint16_t* palette = nullptr;    //Only used by the palette formats
+    const uint8_t* alpha = nullptr;       //Only used by the formats with an alpha plane
     TextureData() : colorspace(PixelType::Mono), mono(nullptr) {}
     TextureData(PixelType type, uint8_t *input) : colorspace(type), mono(input) {}
     TextureData(PixelType type, uint16_t *input) : colorspace(type), rgb565(input) {}
+    TextureData(PixelType type, const uint8_t *input, const uint16_t* colors) : colorspace(type), encoded(input), palette(colors) {}
+    TextureData(PixelType type, const uint16_t *colors, const uint8_t* plane) : colorspace(type), rgb565(const_cast<uint16_t*>(colors)), alpha(plane) {}
 };
 
 //A useful and versatile image wrapper that holds dimensions and a pointer to an array of any supported colorspace
@@ -28,6 +51,13 @@ struct Texture{
     Texture(unsigned int w, unsigned int h, uint16_t *input, bool owner = false) : width(w), height(h), data(PixelType::RGB565, input), ownsData(owner) {}
     Texture(unsigned int w, unsigned int h, const uint8_t *input, bool owner = false) : width(w), height(h), data(PixelType::Mono, (uint8_t *)input), ownsData(owner) {}
     Texture(unsigned int w, unsigned int h, const uint16_t *input, bool owner = false) : width(w), height(h), data(PixelType::RGB565, (uint16_t *)input), ownsData(owner) {}
+    //A compressed texture, the palette is only needed by Palette2 and Palette4
+    Texture(unsigned int w, unsigned int h, PixelType type, const uint8_t *input, const uint16_t* palette = nullptr)
+        : width(w), height(h), data(type, input, palette), ownsData(false) {}
+    /*A texture with transparency, type is either PixelType::RGB565A1 or PixelType::RGB565A4. An owned texture frees the colors only,
+    the alpha plane has to live in the same allocation*/
+    Texture(unsigned int w, unsigned int h, PixelType type, const uint16_t *colors, const uint8_t* alpha, bool owner = false)
+        : width(w), height(h), data(type, colors, alpha), ownsData(owner) {}
     TextureData getData(){return data;}
     static int getArrSize8(int width, int height, float scale_fac);
     static int getArrSize16 (int width, int height, float scale_fac);
@@ -35,8 +65,10 @@ struct Texture{
     ~Texture(){
         if (ownsData) {
             switch (data.colorspace) {
-                case PixelType::Mono:   delete[] data.mono;   break;
-                case PixelType::RGB565: delete[] data.rgb565; break;
+                case PixelType::RGB565:
+                case PixelType::RGB565A1:
+                case PixelType::RGB565A4: delete[] data.rgb565; break;
+                default:                delete[] data.mono;   break;
             }
         }
     }
@@ -44,10 +76,84 @@ struct Texture{
     bool ownsData = false;
 };
 
+//How scale() picks the source pixels of every scaled pixel
+enum class ScaleFilter : uint8_t{
+    Nearest,    //The source pixel the scaled one falls on, any raw format
+    Bilinear,   //A mix of the four closest source pixels, RGB565 only, Mono textures are box filtered instead
+    Box         //The average of the source pixels covered by the scaled one, only when shrinking. Mono becomes RGB565A4 with the coverage as alpha
+};
+
+/*Walks the source in 16.16 fixed point steps, one per scaled pixel. scale() and drawTexture() share it so that they sample the
+same pixels for the same factor. It isn't the float rule the nearest neighbor scaling used before, dst * (1.0f / scaling_factor): at
+factors whose inverse 16.16 can't hold, like 1.7, some scaled columns and rows sample the next source pixel. Never more than one,
+tools/scale_compare.cpp counts them.*/
+struct ScaleStep{
+    uint32_t step;  //Source pixels per scaled pixel, 16.16, rounded up so that exact multiples land where dst / scaling_factor does
+
+    explicit ScaleStep(float scaling_factor) : step(static_cast<uint32_t>(ceilf(65536.0f / scaling_factor))){}
+    //!@return The source pixel sampled by a scaled one
+    inline unsigned int source(unsigned int dst) const { return (dst * step) >> 16; }
+    //!@return The first scaled pixel that samples the source pixel
+    inline unsigned int first(unsigned int src) const { return ((src << 16) + step - 1) / step; }
+};
+
 void transferFrame(uint16_t* emitter, uint16_t* receiver, size_t len);
 bool dirtyRects(Texture first, Texture second);
 const float Fmap(const float x, const float in_min, const float in_max, const float out_min, const float out_max);
 const float Flerp(const float v0, const float v1, const float t);
-const Texture scale(Texture &input, const float scaling_factor);
-const uint16_t rgb565(unsigned int r, unsigned int g, unsigned int b);
-const uint16_t hex(std::string hex);
\ No newline at end of file
+const Texture scale(Texture &input, const float scaling_factor, SimpleUI::FrameArena* arena = nullptr, ScaleFilter filter = ScaleFilter::Nearest,
+                    uint16_t mono_color = 0xFFFF);
+void drawTexture(GFXcanvas16* canvas, const Texture& texture, int x, int y, float scaling_factor = 1.0f, uint16_t mono_color = 0xFFFF, uint8_t opacity = 32);
+const Texture decode(const Texture& input, const float scaling_factor = 1.0f, uint16_t mono_color = 0xFFFF);
+size_t encodeRLEMono(const Texture& input, uint8_t* output, size_t capacity);
+size_t encodeRLE565(const Texture& input, uint8_t* output, size_t capacity, int32_t transparent = -1);
+size_t encodePalette(const Texture& input, PixelType format, uint16_t* palette, uint8_t* output, size_t capacity);
+size_t encodeAlpha(const uint8_t* alpha, unsigned int width, unsigned int height, PixelType format, uint8_t* output, size_t capacity);
+//Converts 8 bit channels to RGB565 by keeping their most significant bits
+constexpr uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b){
+    return static_cast<uint16_t>(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+//Converts a 0xRRGGBB color to RGB565
+constexpr uint16_t rgb888to565(uint32_t rgb){
+    return rgb565((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+}
+
+constexpr uint8_t hexDigit(char c){
+    return c <= '9' ? c - '0' : (c & ~0x20) - 'A' + 10;
+}
+
+/*!
+    @brief Parse a color in the "#RRGGBB" format, it can be evaluated at compile time.
+    @return The RGB565 color, 0 if the string isn't 7 characters long
+*/
+constexpr uint16_t hex(const char* str){
+    size_t length = 0;
+    while (str[length])
+        length++;
+    if (length != 7)
+        return 0;
+    return rgb565((hexDigit(str[1]) << 4) | hexDigit(str[2]),
+                  (hexDigit(str[3]) << 4) | hexDigit(str[4]),
+                  (hexDigit(str[5]) << 4) | hexDigit(str[6]));
+}
+inline uint16_t hex(const std::string& str){ return hex(str.c_str()); }
+
+//Compile time color literal, "#ff8e00"_rgb565
+constexpr uint16_t operator""_rgb565(const char* str, size_t){
+    return hex(str);
+}
+
+/*!
+    @brief Mix two RGB565 colors, all three channels are blended at once in a single 32 bit register.
+    @param from   Color returned when alpha is 0
+    @param to     Color returned when alpha is 32
+    @param alpha  Weight of the second color, from 0 to 32
+*/
+constexpr uint16_t blend565(uint16_t from, uint16_t to, uint8_t alpha){
+    uint32_t bg = (from | (static_cast<uint32_t>(from) << 16)) & 0x07E0F81FUL;
+    const uint32_t fg = (to | (static_cast<uint32_t>(to) << 16)) & 0x07E0F81FUL;
+    bg += ((fg - bg) * alpha) >> 5;
+    bg &= 0x07E0F81FUL;
+    return static_cast<uint16_t>(bg | (bg >> 16));
+}
@@ -0,0 +1,145 @@
+#include "Workers.h"
+
+namespace SimpleUI{
+
+    WorkerPool& WorkerPool::global(){
+        static WorkerPool pool;
+        return s_active ? *s_active : pool;
+    }
+
+    //Worker i renders range i + 1, the calling thread keeps range 0
+    void WorkerPool::m_work(uint8_t index){
+        const unsigned int range = index + 1U;
+        if (range < m_ranges)
+            m_job(m_context, m_rangeBegin(range), m_rangeBegin(range + 1));
+    }
+
+#ifdef ESP32
+
+    void WorkerPool::m_hold(){
+        while (m_busy.exchange(true, std::memory_order_acquire))
+            vTaskDelay(1);
+    }
+
+    bool WorkerPool::start(uint8_t workers){
+        if (!workers)
+            return getWorkers();
+        m_hold();
+        if (!m_count){
+            if (!m_done)
+                m_done = xSemaphoreCreateCountingStatic(MAX_WORKERS, 0, &m_done_buffer);
+            const BaseType_t core = xPortGetCoreID() ? 0 : 1;
+            m_tasks[0] = xTaskCreateStaticPinnedToCore(m_task, "Raster", SIMPLEUI_WORKER_STACK, this, configMAX_PRIORITIES - 2, m_stacks[0], &m_task_buffers[0], core);
+            m_count = m_tasks[0] ? 1 : 0;
+        }
+        m_release();
+        return getWorkers();
+    }
+
+    //Once the pool is held every worker has given back the semaphore of its last range, so deleting it can't leave a call waiting
+    void WorkerPool::stop(){
+        m_hold();
+        for (uint8_t i = 0; i < m_count; i++){
+            vTaskDelete(m_tasks[i]);
+            m_tasks[i] = nullptr;
+        }
+        m_count = 0;
+        m_release();
+    }
+
+    void WorkerPool::m_task(void* pool){
+        WorkerPool* self = static_cast<WorkerPool*>(pool);
+        for (;;){
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            self->m_work(0);
+            xSemaphoreGive(self->m_done);
+        }
+    }
+
+    void WorkerPool::m_run(unsigned int count, unsigned int threads, Job job, void* context){
+        m_job = job;
+        m_context = context;
+        m_items = count;
+        m_ranges = threads;
+        for (uint8_t i = 0; i + 1U < threads; i++)
+            xTaskNotifyGive(m_tasks[i]);
+        job(context, 0, m_rangeBegin(1));
+        for (uint8_t i = 0; i + 1U < threads; i++)
+            xSemaphoreTake(m_done, portMAX_DELAY);
+    }
+
+#else
+
+    void WorkerPool::m_hold(){
+        while (m_busy.exchange(true, std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+
+    bool WorkerPool::start(uint8_t workers){
+        if (!workers)
+            return getWorkers();
+        m_hold();
+        if (!m_count){
+            workers = workers < MAX_WORKERS ? workers : MAX_WORKERS;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = false;
+            //The workers only wait for the calls made from now on, the last one before a stop() isn't run again
+            const uint32_t generation = m_generation;
+            for (uint8_t i = 0; i < workers; i++)
+                m_workers[i] = std::thread([this, i, generation](){ m_loop(i, generation); });
+            m_count = workers;
+        }
+        m_release();
+        return getWorkers();
+    }
+
+    void WorkerPool::m_loop(uint8_t index, uint32_t seen){
+        for (;;){
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&](){ return m_stopping || m_generation != seen; });
+                if (m_stopping)
+                    return;
+                seen = m_generation;
+            }
+            m_work(index);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0)
+                m_finished.notify_one();
+        }
+    }
+
+    //Holding the pool first means no worker is between being woken up and reporting back, so none of them can skip its range
+    void WorkerPool::stop(){
+        m_hold();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (uint8_t i = 0; i < m_count; i++)
+            m_workers[i].join();
+        m_count = 0;
+        m_release();
+    }
+
+    //Every worker is woken up, the ones without a range just report back
+    void WorkerPool::m_run(unsigned int count, unsigned int threads, Job job, void* context){
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = job;
+            m_context = context;
+            m_items = count;
+            m_ranges = threads;
+            m_pending = m_count;
+            m_generation++;
+        }
+        m_wake.notify_all();
+        job(context, 0, m_rangeBegin(1));
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.wait(lock, [this](){ return m_pending == 0; });
+    }
+
+#endif
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <type_traits>
+#ifdef ESP32
+    #include <Arduino.h>
+#else
+    #include <thread>
+    #include <mutex>
+    #include <condition_variable>
+#endif
+
+//Most workers a pool can start besides the calling thread on the host, the ESP32 only has one other core to give
+#ifndef SIMPLEUI_MAX_WORKERS
+  #define SIMPLEUI_MAX_WORKERS 3
+#endif
+//Rows are only handed to other threads in ranges of at least this many pixels, smaller jobs cost more to synchronize than to render
+#ifndef SIMPLEUI_PARALLEL_PIXELS
+  #define SIMPLEUI_PARALLEL_PIXELS 4096
+#endif
+//Bytes of stack of every worker task on the ESP32, the stacks are static so starting the pool doesn't touch the heap
+#ifndef SIMPLEUI_WORKER_STACK
+  #define SIMPLEUI_WORKER_STACK 3072
+#endif
+
+namespace SimpleUI{
+
+    /*A small pool of workers that the raster kernels split their rows across. The calling thread always renders the first range itself
+    and waits for the others, every row is written by exactly one of them with the same math as the serial path, so the output doesn't
+    depend on how many workers there are. Until start() is called everything runs on the calling thread.*/
+    class WorkerPool{
+        public:
+        #ifdef ESP32
+        static constexpr uint8_t MAX_WORKERS = 1;
+        #else
+        static constexpr uint8_t MAX_WORKERS = SIMPLEUI_MAX_WORKERS;
+        #endif
+
+        /*While a Scope exists the library's kernels run on another pool, the benchmarks time one of their own without stopping the
+        one of the UI. Only open one while nothing else renders.*/
+        class Scope{
+            public:
+            explicit Scope(WorkerPool& pool) : m_previous(s_active){ s_active = &pool; }
+            ~Scope(){ s_active = m_previous; }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            private:
+            WorkerPool* m_previous;
+        };
+
+        //!@return The pool used by the library's kernels, the one of the innermost Scope if there's one
+        static WorkerPool& global();
+
+        /*!
+            @brief Start the workers, meant to be called once at init. On the ESP32 a single task is pinned to the core that isn't calling,
+            so call it from the task that renders. A call in progress is waited for.
+            @param workers How many threads to start besides the calling one, capped to MAX_WORKERS
+            @return False if no worker could be started, the kernels then stay serial
+        */
+        bool start(uint8_t workers = MAX_WORKERS);
+        //!@brief Stop the workers once the call in progress is done, the kernels are serial until start() is called again
+        void stop();
+        ~WorkerPool(){ stop(); }
+        //!@return How many workers are running besides the calling thread
+        inline uint8_t getWorkers() const { return m_count.load(std::memory_order_relaxed); }
+
+        /*!
+            @brief Split [0, count) in contiguous ranges and call body(begin, end) once per range, one range per thread.
+            A call made while the pool is already busy, from a worker or from another thread, runs serially instead.
+            @param count      How many items, usually rows
+            @param min_range  The smallest range worth handing to another thread
+        */
+        template<typename F>
+        void parallelFor(unsigned int count, unsigned int min_range, F&& body){
+            using Body = typename std::remove_reference<F>::type;
+            const unsigned int ranges = count / (min_range ? min_range : 1);
+            if (ranges < 2 || !getWorkers() || m_busy.exchange(true, std::memory_order_acquire)){
+                body(0U, count);
+                return;
+            }
+            //Counted again once the pool is held, start() and stop() wait for it so the workers can't change meanwhile
+            const unsigned int workers = getWorkers();
+            const unsigned int threads = ranges < workers + 1 ? ranges : workers + 1;
+            if (threads < 2)
+                body(0U, count);
+            else
+                m_run(count, threads, [](void* context, unsigned int begin, unsigned int end){ (*static_cast<Body*>(context))(begin, end); }, &body);
+            m_busy.store(false, std::memory_order_release);
+        }
+
+        private:
+        using Job = void (*)(void* context, unsigned int begin, unsigned int end);
+
+        void m_run(unsigned int count, unsigned int threads, Job job, void* context);
+        void m_work(uint8_t index);
+        //!@brief Wait for the call in progress and hold the pool, the calls made meanwhile run serially
+        void m_hold();
+        inline void m_release(){ m_busy.store(false, std::memory_order_release); }
+        inline unsigned int m_rangeBegin(unsigned int index) const { return static_cast<unsigned int>(static_cast<uint64_t>(m_items) * index / m_ranges); }
+
+        std::atomic<bool> m_busy{false};
+        std::atomic<uint8_t> m_count{0};
+        //The job of the current call, written before the workers are woken up
+        Job m_job = nullptr;
+        void* m_context = nullptr;
+        unsigned int m_items = 0;
+        unsigned int m_ranges = 0;
+
+        #ifdef ESP32
+        static void m_task(void* pool);
+        TaskHandle_t m_tasks[MAX_WORKERS] = {};
+        StaticTask_t m_task_buffers[MAX_WORKERS];
+        StackType_t m_stacks[MAX_WORKERS][SIMPLEUI_WORKER_STACK];
+        SemaphoreHandle_t m_done = nullptr;
+        StaticSemaphore_t m_done_buffer;
+        #else
+        //!@brief Body of a worker thread, it runs the calls made after the generation it starts from
+        void m_loop(uint8_t index, uint32_t seen);
+        std::thread m_workers[MAX_WORKERS];
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_finished;
+        uint32_t m_generation = 0;
+        unsigned int m_pending = 0;
+        bool m_stopping = false;
+        #endif
+        static inline WorkerPool* s_active = nullptr;   //Set by Scope
+    };
+
+    //!@brief Run body(begin, end) over the rows of an image on the global pool, in ranges of at least SIMPLEUI_PARALLEL_PIXELS pixels
+    template<typename F>
+    inline void parallelRows(unsigned int rows, unsigned int width, F&& body){
+        WorkerPool::global().parallelFor(rows, width ? (SIMPLEUI_PARALLEL_PIXELS + width - 1) / width : rows, body);
+    }
+
+}
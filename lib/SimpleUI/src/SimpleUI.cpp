@@ -1,6 +1,35 @@
 #include "SimpleUI.h"
 
 namespace SimpleUI{
+
+  /*In the static memory profile a full container drops what is added to it, the overflow is reported on the serial with the name of
+  the capacity to raise. The dynamic profile always succeeds.*/
+  template<typename L, typename T>
+  static bool append(L& list, const T& value, const char* capacity){
+    #if SIMPLEUI_STATIC_MEMORY
+    if (list.push_back(value))
+      return true;
+    Serial.printf("SimpleUI: %s reached, the item was dropped\n", capacity);
+    return false;
+    #else
+    list.push_back(value);
+    return true;
+    #endif
+  }
+
+  template<typename M, typename K, typename V>
+  static bool insert(M& map, const K& key, const V& value, const char* capacity){
+    #if SIMPLEUI_STATIC_MEMORY
+    if (map.insert({key, value}).first != map.end())
+      return true;
+    Serial.printf("SimpleUI: %s reached, the item was dropped\n", capacity);
+    return false;
+    #else
+    map.insert({key, value});
+    return true;
+    #endif
+  }
+
 //--------------------Cone STRUCT---------------------------------------------------------------//
 
   /*!
@@ -19,10 +48,10 @@ namespace SimpleUI{
 
 
   /*!
-      @brief Focus an object by its UUID
-      @param ele The element UUID to focus
+      @brief Focus an object by its ID
+      @param ele The element ID to focus
   */
-  void Focus::focus(std::string ele){
+  void Focus::focus(ElementID ele){
       previousElementID = focusedElementID;
       focusedElementID = ele;
     }
@@ -39,9 +68,9 @@ namespace SimpleUI{
 
   /*!
     @return A boolean that when true, means that the passed object's identity is currently focused
-    @param obj The UUID of the object in cause
+    @param obj The ID of the object in cause
   */
-  bool Focus::isFocusing(std::string obj){
+  bool Focus::isFocusing(ElementID obj){
       return (focusedElementID == obj);
     }
 
@@ -63,56 +92,32 @@ namespace SimpleUI{
 
 //--------------------UIElement CLASS---------------------------------------------------------------//
 
-  Point UIElement::centerToCornerPos(unsigned int x_pos, unsigned int y_pos, unsigned int w, unsigned int h){
-        unsigned int new_x = static_cast<unsigned int>(static_cast<float>(x_pos)-(static_cast<float>(w)*0.5f));
-        unsigned int new_y = static_cast<unsigned int>(static_cast<float>(y_pos)-(static_cast<float>(h)*0.5f));
-        return Point(new_x, new_y);
-      }
-
   bool UIElement::isFocused() const {
-    return m_parent_ui->focus.focusedElementID==m_UUID;
+    return m_parent_ui->focus.focusedElementID==m_id;
   }
 
   void UIElement::drawFocusOutline(const Outline& outline) const {
     INSTRUMENTATE(m_parent_ui)
-    if (focus_style == FocusStyle::Outline && isFocused()) {
-      Outline draw_outline = custom_focus_outline ? focus_outline : outline;
-
-      Point rect_drawing_pos = getDrawPoint();
-      rect_drawing_pos -= (draw_outline.border_distance + 1);
-      int16_t draw_width = m_width + draw_outline.border_distance*2 +2;
-      int16_t draw_height = m_height + draw_outline.border_distance*2 +2;
-
-
-      if(draw_outline.radius != 0){
-        int16_t draw_radius = draw_outline.radius;
-        for (int i = 0; i < draw_outline.thickness; i++) {
-          m_parent_ui->buffer->drawRoundRect(rect_drawing_pos.x, rect_drawing_pos.y, draw_width, draw_height, draw_radius, draw_outline.color);
-          if (!(i % 2)){
-            int16_t temp_r = draw_radius + 1;
-            m_parent_ui->buffer->drawCircleHelper(rect_drawing_pos.x + temp_r, rect_drawing_pos.y + temp_r, temp_r, 1, draw_outline.color);
-            m_parent_ui->buffer->drawCircleHelper(rect_drawing_pos.x + draw_width - temp_r - 1, rect_drawing_pos.y + temp_r, temp_r, 2, draw_outline.color);
-            m_parent_ui->buffer->drawCircleHelper(rect_drawing_pos.x + draw_width - temp_r - 1, rect_drawing_pos.y + draw_height - temp_r - 1, temp_r, 4, draw_outline.color);
-            m_parent_ui->buffer->drawCircleHelper(rect_drawing_pos.x + temp_r, rect_drawing_pos.y + draw_height - temp_r - 1, temp_r, 8, draw_outline.color);
-          }
-          
-          draw_width += 2;
-          draw_height += 2; 
-          rect_drawing_pos--;
-          draw_radius++;
-        }
-      }
-      else{
+    if (focus_style == FocusStyle::Outline && isFocused() && !m_parent_ui->isFocusGliding()) {
+      m_strokeOutline(custom_focus_outline ? focus_outline : outline, getDrawPoint(), m_width, m_height);
+    }
+  }
 
-        for (int i = 0; i < draw_outline.thickness; i++) {
-          m_parent_ui->buffer->drawRect(rect_drawing_pos.x, rect_drawing_pos.y, draw_width, draw_height, draw_outline.color);
-          draw_width += 2;
-          draw_height += 2;
-          rect_drawing_pos--;
-        }
+  OutlineRing UIElement::getFocusRing(const Outline& outline) const {
+    return OutlineRing(custom_focus_outline ? focus_outline : outline, Rect(getDrawPoint(), m_width, m_height));
+  }
 
-      }
-    }
+  /*!
+    @brief Draw an outline around any rectangle
+    @param outline  The outline to draw
+    @param pos      Top left corner of the outlined rectangle
+    @param w        Width of the outlined rectangle
+    @param h        Height of the outlined rectangle
+  */
+  void UIElement::m_strokeOutline(const Outline& draw_outline, Point pos, unsigned int w, unsigned int h) const {
+      if (!draw_outline.thickness)
+        return;
+      m_parent_ui->getOutlineCache().stroke(m_parent_ui->buffer, OutlineRing(draw_outline, Rect(pos, w, h)));
   }
 
   void UIElement::render(){
@@ -120,31 +125,91 @@ namespace SimpleUI{
     drawFocusOutline();
   }
 
+  //!@return A box that contains everything the element draws, both scaled and unscaled, including its focus outline
+  Rect UIElement::getBounds() const {
+    Rect bounds(getPos(), m_width, m_height);
+    bounds.merge(Rect(getConstraintedPos(), m_s_width, m_s_height));
+    if (focus_style == FocusStyle::Outline){
+      //Without its own outline the element is outlined with the scene's, the larger of the two covers both
+      int reach = focus_outline.border_distance + focus_outline.thickness;
+      const Scene* scene = m_parent_ui ? m_parent_ui->getActiveScene() : nullptr;
+      if (!custom_focus_outline && scene)
+        reach = std::max(reach, scene->settings.focus.outline.border_distance + scene->settings.focus.outline.thickness);
+      bounds.inflate(reach + 1);
+    }
+    return bounds;
+  }
+
+  /*!
+    @brief Draw a texture at the element's constrained position and update the scaled size. Nearest sampled textures are scaled and
+    decoded straight into the canvas, filtered ones are scaled into the frame arena first. Both go through drawTexture(), which splits
+    its rows across the worker pool when it's running.
+    Opaque raw images used to be blitted with GFX's drawRGBBitmap() and drawBitmap(). drawTexture() clips them the same way and writes
+    the same pixels, a Mono texture only sets its lit pixels to the mono color, test_texture compares the two.
+    @param opacity From 0 to 32
+  */
+  void UIElement::m_drawTexture(Texture& texture, float scale_fac, uint16_t mono_color, uint8_t opacity){
+    if (isEncoded(texture.data.colorspace) || scale_filter == ScaleFilter::Nearest){
+      m_setScaledSize(static_cast<unsigned int>(texture.width * scale_fac), static_cast<unsigned int>(texture.height * scale_fac));
+      const Point drawing_pos = getConstraintedPos();
+      drawTexture(m_parent_ui->buffer, texture, drawing_pos.x, drawing_pos.y, scale_fac, mono_color, opacity);
+      return;
+    }
+
+    const Texture drawing_image = scale(texture, scale_fac, &m_parent_ui->getArena(), scale_filter, mono_color);
+    m_setScaledSize(drawing_image.width, drawing_image.height);
+    const Point drawing_pos = getConstraintedPos();
+    drawTexture(m_parent_ui->buffer, drawing_image, drawing_pos.x, drawing_pos.y, 1.0f, mono_color, opacity);
+  }
+
+  //Every layout change only dirties the bounds of the groups on the path to the root, stopping at the first one that's already dirty
+  void UIElement::m_invalidateBounds(){
+    m_geometry_version++;
+    for (Group* group = m_group; group && !group->m_bounds_dirty; group = group->m_group)
+      group->m_bounds_dirty = true;
+  }
+
+  void UIElement::m_setScaledSize(unsigned int w, unsigned int h){
+    if (w != m_s_width || h != m_s_height){
+      m_s_width = w;
+      m_s_height = h;
+      m_invalidateBounds();
+    }
+  }
+
   Point UIElement::getDrawPoint() const {
     return getConstraintedPos();
   }
 
   Point UIElement::getCenterPoint() const {
-    return UiUtils::centerPos(m_position.x, m_position.y, m_width, m_height);
+    const Point pos = getPos();
+    return UiUtils::centerPos(pos.x, pos.y, m_width, m_height);
   }
 
   Point UIElement::getConstraintedPos() const {
-    int widthDiff = m_width - m_s_width;
-    int heightDiff = m_height - m_s_height;
-    int widthDiff_2 = static_cast<int>(widthDiff * 0.5);
-    int heightDiff_2 = static_cast<int>(heightDiff * 0.5);
+    return getConstraintedPos(m_s_width, m_s_height);
+  }
+
+  //The offsets are computed in fixed point, halves included, and the position is rounded to a pixel only once at the end
+  Point UIElement::getConstraintedPos(unsigned int scaled_w, unsigned int scaled_h) const {
+    const Fixed widthDiff(m_width - static_cast<int>(scaled_w));
+    const Fixed heightDiff(m_height - static_cast<int>(scaled_h));
+    const Fixed widthDiff_2 = widthDiff.half();
+    const Fixed heightDiff_2 = heightDiff.half();
+    const Fixed x = m_position.x;
+    const Fixed y = m_position.y;
     switch (scale_constraint){
-      case Constraint::TopLeft:     return Point( m_position.x, m_position.y );
-      case Constraint::Top:         return Point( m_position.x + widthDiff_2,  m_position.y);
-      case Constraint::TopRight:    return Point( m_position.x + widthDiff,  m_position.y);
-      case Constraint::Left:        return Point( m_position.x,  m_position.y + heightDiff_2);
-      case Constraint::Center:      return Point( m_position.x + widthDiff_2,  m_position.y + heightDiff_2);
-      case Constraint::Right:       return Point( m_position.x + widthDiff,  m_position.y + heightDiff_2);
-      case Constraint::BottomLeft:  return Point( m_position.x,  m_position.y + heightDiff);
-      case Constraint::Bottom:      return Point( m_position.x + widthDiff_2,  m_position.y + heightDiff);
-      case Constraint::BottomRight: return Point( m_position.x + heightDiff,  m_position.y + heightDiff);
+      case Constraint::TopLeft:     return m_position.round();
+      case Constraint::Top:         return FixedPoint( x + widthDiff_2,  y).round();
+      case Constraint::TopRight:    return FixedPoint( x + widthDiff,  y).round();
+      case Constraint::Left:        return FixedPoint( x,  y + heightDiff_2).round();
+      case Constraint::Center:      return FixedPoint( x + widthDiff_2,  y + heightDiff_2).round();
+      case Constraint::Right:       return FixedPoint( x + widthDiff,  y + heightDiff_2).round();
+      case Constraint::BottomLeft:  return FixedPoint( x,  y + heightDiff).round();
+      case Constraint::Bottom:      return FixedPoint( x + widthDiff_2,  y + heightDiff).round();
+      case Constraint::BottomRight: return FixedPoint( x + widthDiff,  y + heightDiff).round();
     }
-    return Point(m_position.x, m_position.y);
+    return m_position.round();
   }
 
 //--------------------UIImage CLASS---------------------------------------------------------------//
@@ -152,21 +217,49 @@ namespace SimpleUI{
   void UIImage::render(){
     INSTRUMENTATE(m_parent_ui)
     drawFocusOutline();
-    anim.Update();
-  
-    const float scale_fac = anim.getProgress();
-    const Texture drawing_image = scale(*m_body, scale_fac);
-    m_s_height = drawing_image.height;
-    m_s_width = drawing_image.width;
-    const Point drawing_pos = getConstraintedPos();
 
-    if(drawing_image.data.colorspace == PixelType::Mono){
-      m_parent_ui->buffer->drawBitmap(drawing_pos.x, drawing_pos.y, drawing_image.data.mono, drawing_image.width, drawing_image.height, m_mono_color);
-    }
-    else{
-      m_parent_ui->buffer->drawRGBBitmap(drawing_pos.x, drawing_pos.y, drawing_image.data.rgb565, drawing_image.width, drawing_image.height);
+    const float scale = m_currentScale();
+    if (m_needsPrepared(scale)){
+      //While the scale animates the image is drawn from the source, the copy is only rebuilt once it settles
+      if (!m_prepared || (m_prepared_scale != scale && !isAnimating())){
+        m_parent_ui->countCacheMiss();
+        m_prepare(scale);
+      }
+      if (m_prepared_scale == scale){
+        m_setScaledSize(m_prepared->width, m_prepared->height);
+        const Point drawing_pos = getConstraintedPos();
+        drawTexture(m_parent_ui->buffer, *m_prepared, drawing_pos.x, drawing_pos.y, 1.0f, m_mono_color, m_opacity);
+        return;
+      }
     }
+    m_drawTexture(*m_body, scale, m_mono_color, m_opacity);
+  }
+
+  void UIImage::prepare(){
+    const float scale = m_currentScale();
+    if (m_needsPrepared(scale) && (!m_prepared || m_prepared_scale != scale))
+      m_prepare(scale);
+  }
+
+  //!@return True if the image is drawn from a copy at the given scale, see keep_decoded
+  bool UIImage::m_needsPrepared(float scale) const {
+    #if SIMPLEUI_STATIC_MEMORY
+    return false;
+    #else
+    if (!m_body || scale <= 0.0f)
+      return false;
+    if (isEncoded(m_body->data.colorspace))
+      return keep_decoded;
+    return scale_filter != ScaleFilter::Nearest && scale != 1.0f;
+    #endif
+  }
 
+  void UIImage::m_prepare(float scale){
+    if (isEncoded(m_body->data.colorspace))
+      m_prepared.reset(new Texture(decode(*m_body, scale, m_mono_color)));
+    else
+      m_prepared.reset(new Texture(::scale(*m_body, scale, nullptr, scale_filter, m_mono_color)));
+    m_prepared_scale = scale;
   }
 
 //--------------------AnimatedApp CLASS---------------------------------------------------------------//
@@ -184,7 +277,7 @@ namespace SimpleUI{
         else if (m_parent_ui->focus.hasChanged() && m_showing == m_selected)
         { //If the element has just been unfocused and has previously completed the focusing animation, start the unfocusing
           m_showing = m_unselected;
-          anim = Animation(m_ratio, 1.0f, m_duration, anim.factor);
+          m_replaceAnimation(m_ratio, 1.0f);
           anim.Start();
         }
         break;
@@ -212,12 +305,12 @@ namespace SimpleUI{
             }
             else
             { //Fixes bug that causes the unfocused icon to stay big while it isn't focused
-              anim = Animation(m_ratio, 1.0f, m_duration, anim.factor);
+              m_replaceAnimation(m_ratio, 1.0f);
               anim.Start();
             }
           }
           else { //Reset the animation for it to be resumed with the correct parameters
-            anim = Animation(1.0f, m_ratio, m_duration, anim.factor);
+            m_replaceAnimation(1.0f, m_ratio);
           }
         }
         break;
@@ -225,68 +318,47 @@ namespace SimpleUI{
     }
   }
 
+  //The texture is drawn at the scale the animation has now, once render() catches up with it
+  Rect AnimatedApp::getAnimationDamage() const {
+    const float scale = anim.getProgress();
+    const unsigned int w = static_cast<unsigned int>(m_showing->width * scale);
+    const unsigned int h = static_cast<unsigned int>(m_showing->height * scale);
+    return getBounds().merge(Rect(getConstraintedPos(w, h), w, h));
+  }
+
+  /*!
+    @brief Replace the animation keeping its easing, stepping and threshold
+    @param start Initial scale
+    @param end   Final scale
+  */
+  void AnimatedApp::m_replaceAnimation(float start, float end){
+    Animation next(start, end, m_duration, anim.getFactor());
+    next.adoptModes(anim);
+    anim = std::move(next);
+  }
+
 void AnimatedApp::render(){
   INSTRUMENTATE(m_parent_ui)
-    anim.Update();
     m_computeAnimation();
   
-    const float scale_fac = anim.getProgress();
-    const Texture drawing_image = scale(*m_showing, scale_fac);
-    m_s_height = drawing_image.height;
-    m_s_width = drawing_image.width;
-    const Point drawing_pos = getConstraintedPos();
-
-    
-    if(drawing_image.data.colorspace == PixelType::Mono){
-      m_parent_ui->buffer->drawBitmap(drawing_pos.x, drawing_pos.y, drawing_image.data.mono, drawing_image.width, drawing_image.height, m_mono_color);
-    }
-    else{
-      m_parent_ui->buffer->drawRGBBitmap(drawing_pos.x, drawing_pos.y, drawing_image.data.rgb565, drawing_image.width, drawing_image.height);
-    }
+    m_drawTexture(*m_showing, anim.getProgress(), m_mono_color);
   }
 
 //--------------------Checkbox CLASS---------------------------------------------------------------//
 
   void Checkbox::m_drawCheckboxOutline() const {
     INSTRUMENTATE(m_parent_ui)
-    int16_t draw_width = m_width;
-    int16_t draw_height = m_height;
-    Point rect_drawing_pos = getDrawPoint();
-
-    if(outline.radius!=0){
-      int16_t initial_radius = outline.radius;
-      int16_t final_radius = outline.radius - outline.thickness;
-      if (final_radius < 0)
-        final_radius = 0;
-      int16_t rad_diff = initial_radius - final_radius;
-      float step = rad_diff / outline.thickness;
-      float draw_radius = outline.radius;
-
-      for (int i = outline.thickness; i > 0 ; i--) {
-        m_parent_ui->buffer->drawRoundRect(rect_drawing_pos.x, rect_drawing_pos.y, draw_width, draw_height, round(draw_radius), outline.color);
-        if (!(i % 2)){
-          int16_t temp_r = round(draw_radius) + 1;
-          m_parent_ui->buffer->drawCircleHelper(rect_drawing_pos.x + temp_r, rect_drawing_pos.y + temp_r, temp_r, 1, outline.color);
-          m_parent_ui->buffer->drawCircleHelper(rect_drawing_pos.x + draw_width - temp_r - 1, rect_drawing_pos.y + temp_r, temp_r, 2, outline.color);
-          m_parent_ui->buffer->drawCircleHelper(rect_drawing_pos.x + draw_width - temp_r - 1, rect_drawing_pos.y + draw_height - temp_r - 1, temp_r, 4, outline.color);
-          m_parent_ui->buffer->drawCircleHelper(rect_drawing_pos.x + temp_r, rect_drawing_pos.y + draw_height - temp_r - 1, temp_r, 8, outline.color);
-        }
-        
-        draw_width -= 2;
-        draw_height -= 2; 
-        rect_drawing_pos++;
-        draw_radius -= step;
-      }
-    }
-    else{
-      
-      for (int i = outline.thickness; i > 0 ; i--) {
-        m_parent_ui->buffer->drawRect(rect_drawing_pos.x, rect_drawing_pos.y, draw_width, draw_height, outline.color);
-        draw_width -= 2;
-        draw_height -= 2;
-        rect_drawing_pos++;
-      }
-    }
+    if (!outline.thickness)
+      return;
+    const uint8_t hole_radius = outline.radius > outline.thickness ? outline.radius - outline.thickness : 0;
+    m_parent_ui->getOutlineCache().stroke(m_parent_ui->buffer, getDrawPoint(), m_width, m_height, outline.radius, outline.thickness,
+                                          hole_radius, outline.color);
+  }
+
+  void Checkbox::prepare(){
+    if (m_parent_ui && outline.thickness)
+      m_parent_ui->getOutlineCache().warm(m_width, m_height, outline.radius, outline.thickness,
+                                          outline.radius > outline.thickness ? outline.radius - outline.thickness : 0);
   }
 
   void Checkbox::render(){
@@ -310,45 +382,635 @@ void AnimatedApp::render(){
   }
 
 
+//--------------------ListView CLASS---------------------------------------------------------------//
+
+  ListView::~ListView(){
+    for (UIElement* item : m_pool)
+      delete item;
+  }
+
+  bool ListView::setFactory(const Callback<UIElement*()>& factory){
+    for (UIElement* item : m_pool)
+      delete item;
+    m_pool.clear();
+
+    const size_t pool_size = getVisibleRows() * m_columns;
+    bool complete = true;
+    for (size_t i = 0; i < pool_size && complete; i++){
+      UIElement* item = factory();
+      item->focusable = false;
+      complete = append(m_pool, item, "SIMPLEUI_MAX_LIST_ITEMS");
+      if (!complete)
+        delete item;
+    }
+    m_bound.assign(m_pool.size(), NONE);
+    return complete;
+  }
+
+  void ListView::setSource(size_t count, const Callback<void(UIElement* item, size_t index)>& source){
+    m_source = source;
+    invalidate();
+    setCount(count);
+  }
+
+  void ListView::setCount(size_t count){
+    m_count = count;
+    //A shorter list pulls the viewport back so it doesn't show empty rows past its end
+    const size_t rows = (m_count + m_columns - 1) / m_columns;
+    const size_t visible_rows = getVisibleRows();
+    if (m_first_row + visible_rows > rows)
+      m_first_row = rows > visible_rows ? rows - visible_rows : 0;
+    if (m_selected >= m_count)
+      select(m_count ? m_count - 1 : 0);
+    for (size_t& index : m_bound){
+      if (index != NONE && index >= m_count)
+        index = NONE;
+    }
+  }
+
+  void ListView::select(size_t index){
+    m_selected = index < m_count ? index : (m_count ? m_count - 1 : 0);
+    m_scrollTo(m_selected);
+  }
+
+  //Moves the viewport by the least amount of rows that makes the index visible
+  void ListView::m_scrollTo(size_t index){
+    const size_t row = index / m_columns;
+    const size_t visible_rows = getVisibleRows();
+    if (row < m_first_row)
+      m_first_row = row;
+    else if (row >= m_first_row + visible_rows)
+      m_first_row = row - visible_rows + 1;
+  }
+
+  bool ListView::navigate(unsigned int direction){
+    if (!m_count)
+      return false;
+    const size_t column = m_selected % m_columns;
+    switch (direction){
+      case static_cast<unsigned int>(Direction::Up):
+        if (m_selected < m_columns)
+          return false;
+        select(m_selected - m_columns);
+        return true;
+      case static_cast<unsigned int>(Direction::Down):
+        if (m_selected + m_columns >= m_count)
+          return false;
+        select(m_selected + m_columns);
+        return true;
+      case static_cast<unsigned int>(Direction::Left):
+        if (column == 0)
+          return false;
+        select(m_selected - 1);
+        return true;
+      case static_cast<unsigned int>(Direction::Right):
+        if (column == m_columns - 1 || m_selected + 1 >= m_count)
+          return false;
+        select(m_selected + 1);
+        return true;
+    }
+    return false;
+  }
+
+  //The items aren't part of the scene, they're prepared here along with the selection outline around them
+  void ListView::prepare(){
+    for (UIElement* item : m_pool){
+      item->setUiListener(m_parent_ui);
+      item->prepare();
+      if (m_parent_ui && selection_outline.thickness)
+        m_parent_ui->getOutlineCache().warm(OutlineRing(selection_outline, Rect(Point(0, 0), item->getWidth(), item->getHeight())));
+    }
+  }
+
+  void ListView::click(){
+    if (m_count)
+      m_onClick(m_selected);
+  }
+
+  void ListView::render(){
+    INSTRUMENTATE(m_parent_ui)
+    if (m_pool.empty())
+      return;
+
+    const Point origin = getDrawPoint();
+    const unsigned int item_width = m_width / m_columns;
+    const size_t first = m_first_row * m_columns;
+    const size_t last = std::min(m_count, first + m_pool.size());
+
+    for (size_t index = first; index < last; index++){
+      const size_t slot = index % m_pool.size();
+      UIElement* item = m_pool[slot];
+      if (m_bound[slot] != index){
+        m_source(item, index);
+        m_bound[slot] = index;
+      }
+
+      const size_t visible_index = index - first;
+      const Point item_pos(origin.x + (visible_index % m_columns) * item_width, origin.y + (visible_index / m_columns) * m_item_height);
+      item->setUiListener(m_parent_ui);
+      item->setPos(item_pos);
+      if (item->draw)
+        item->render();
+
+      if (index == m_selected && isFocused())
+        m_strokeOutline(selection_outline, item_pos, item->getWidth(), item->getHeight());
+    }
+  }
+
+//--------------------Group CLASS---------------------------------------------------------------//
+
+  Group::Group(std::initializer_list<UIElement*> children)
+    : UIElement(0, 0, {0, 0}, false, ElementType::Group)
+  {
+    focusable = false;
+    for (const auto child : children)
+      add(child);
+  }
+
+  bool Group::add(UIElement* child){
+    if (!append(m_children, child, "SIMPLEUI_MAX_CHILDREN"))
+      return false;
+    child->m_group = this;
+    m_invalidateBounds();
+    m_bounds_dirty = true;
+    return true;
+  }
+
+  Rect Group::getBounds() const {
+    if (m_bounds_dirty){
+      m_bounds = Rect();
+      for (const auto child : m_children)
+        m_bounds.merge(child->getBounds());
+      m_bounds_dirty = false;
+    }
+    return m_bounds;
+  }
+
+  void Group::render(){
+    INSTRUMENTATE(m_parent_ui)
+    const Rect clip = m_parent_ui->getClip();
+    const Scene* scene = m_parent_ui->getActiveScene();
+    for (const auto child : m_children){
+      if (child->draw && child->getBounds().intersects(clip)){
+        child->render();
+        if (child->isFocused() && child->focus_style == FocusStyle::Outline)
+          child->drawFocusOutline(scene->settings.focus.outline);
+      }
+    }
+  }
+
+//--------------------GlyphAtlas CLASS---------------------------------------------------------------//
+
+  namespace{
+    //A surface that only records which pixels GFX lights up, used to rasterize glyphs without a canvas. A row is a single word, so the
+    //surface is 512 bytes of the stack of whoever builds the atlas
+    class GlyphSurface : public Adafruit_GFX{
+      public:
+      static constexpr int16_t SIZE = 64;
+      static constexpr int16_t ORIGIN = 16;   //Room on the left for glyphs with a negative offset
+      GlyphSurface() : Adafruit_GFX(SIZE, SIZE) {}
+      void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (color && x >= 0 && y >= 0 && x < SIZE && y < SIZE)
+          m_rows[y] |= uint64_t(1) << x;
+      }
+      inline bool isLit(int16_t x, int16_t y) const { return (m_rows[y] >> x) & 1; }
+      inline void clear(){ memset(m_rows, 0, sizeof(m_rows)); }
+      private:
+      static_assert(SIZE <= 64, "a row of the surface is a 64 bit word");
+      uint64_t m_rows[SIZE] = {};
+    };
+  }
+
+  GlyphAtlas::GlyphAtlas(const GFXfont* font, uint8_t first, uint8_t last) : m_first(first), m_line_height(8){
+    GlyphSurface surface;
+    surface.setFont(font);
+    surface.setTextWrap(false);
+
+    int16_t ascent = 0;
+    if (font){
+      first = std::max<uint8_t>(first, font->first);
+      last = std::min<uint8_t>(last, font->last);
+      m_first = first;
+      m_line_height = font->yAdvance;
+      for (uint16_t c = first; c <= last; c++)
+        ascent = std::max<int16_t>(ascent, -static_cast<int8_t>(font->glyph[c - font->first].yOffset));
+    }
+
+    for (uint16_t c = first; c <= last && m_glyphs.size() < SIMPLEUI_MAX_GLYPHS; c++){
+      surface.clear();
+      surface.drawChar(GlyphSurface::ORIGIN, ascent, c, 1, 1, 1);   //Same color as the background so that only the glyph is drawn
+
+      Glyph glyph{static_cast<uint16_t>(m_spans.size()), 0, static_cast<uint8_t>(font ? font->glyph[c - font->first].xAdvance : 6)};
+      for (int16_t y = 0; y < GlyphSurface::SIZE; y++){
+        for (int16_t x = 0; x < GlyphSurface::SIZE; x++){
+          if (!surface.isLit(x, y))
+            continue;
+          const int16_t start = x;
+          while (x < GlyphSurface::SIZE && surface.isLit(x, y))
+            x++;
+          if (!append(m_spans, Span{static_cast<int8_t>(start - GlyphSurface::ORIGIN), static_cast<int8_t>(y), static_cast<uint8_t>(x - start)}, "SIMPLEUI_MAX_GLYPH_SPANS")){
+            //The glyph is dropped whole along with every one after it, they're then drawn as blanks
+            m_spans.erase(m_spans.begin() + glyph.span_offset, m_spans.end());
+            return;
+          }
+          glyph.span_count++;
+        }
+      }
+      m_glyphs.push_back(glyph);
+    }
+  }
+
+//--------------------Label CLASS---------------------------------------------------------------//
+
+  Label::Label(Point pos, bool isCentered, const GlyphAtlas* atlas, uint16_t color, uint8_t size)
+    : UIElement(0, 0, pos, false, ElementType::Label), m_atlas(atlas), m_anchor(pos), m_color(color), m_size(size ? size : 1), m_centered(isCentered)
+  {
+    focusable = false;
+    m_layout();
+  }
+
+  void Label::setText(const char* text){
+    if (!strncmp(m_text, text, SIMPLEUI_MAX_LABEL_LENGTH))
+      return;
+    strncpy(m_text, text, SIMPLEUI_MAX_LABEL_LENGTH);
+    m_text[SIMPLEUI_MAX_LABEL_LENGTH] = '\0';
+    m_length = strlen(m_text);
+    m_stale = true;
+  }
+
+  void Label::setNumber(long number){
+    char text[SIMPLEUI_MAX_LABEL_LENGTH + 1];
+    snprintf(text, sizeof(text), "%ld", number);
+    setText(text);
+  }
+
+  void Label::setSize(uint8_t size){
+    if (!size || size == m_size)
+      return;
+    m_size = size;
+    m_stale = true;
+  }
+
+  void Label::prepare(){
+    if (m_stale)
+      m_layout();
+  }
+
+  int16_t Label::m_measure() const {
+    int16_t x = 0;
+    for (uint8_t i = 0; i < m_length; i++){
+      const GlyphAtlas::Glyph* glyph = m_atlas ? m_atlas->getGlyph(m_text[i]) : nullptr;
+      x += (glyph ? glyph->x_advance : 0) * m_size;
+    }
+    return x;
+  }
+
+  //Until the next layout the bounds are those of the new text, so the damage of the frame that lays it out covers it
+  Rect Label::getBounds() const {
+    if (!m_stale)
+      return UIElement::getBounds();
+    const int16_t width = m_measure();
+    const int16_t height = m_atlas ? m_atlas->getLineHeight() * m_size : 0;
+    Rect bounds(m_centered ? centerToCornerPos(m_anchor.x, m_anchor.y, width, height) : getPos(), width, height);
+    return bounds.merge(UIElement::getBounds());
+  }
+
+  //Place every character once, the label only changes size and position here. A label that isn't centered stays where it's been moved to
+  void Label::m_layout(){
+    m_length = strlen(m_text);
+    int16_t x = 0;
+    for (uint8_t i = 0; i < m_length; i++){
+      m_glyph_x[i] = x;
+      const GlyphAtlas::Glyph* glyph = m_atlas ? m_atlas->getGlyph(m_text[i]) : nullptr;
+      x += (glyph ? glyph->x_advance : 0) * m_size;
+    }
+    const uint16_t height = m_atlas ? m_atlas->getLineHeight() * m_size : 0;
+    if (x != m_width || height != m_height){
+      m_width = m_s_width = x;
+      m_height = m_s_height = height;
+      m_invalidateBounds();
+    }
+    if (m_centered)
+      setPos(centerToCornerPos(m_anchor.x, m_anchor.y, m_width, m_height));
+    m_stale = false;
+  }
+
+  void Label::render(){
+    INSTRUMENTATE(m_parent_ui)
+    if (!m_atlas)
+      return;
+    if (m_stale){
+      m_parent_ui->countCacheMiss();
+      m_layout();
+    }
+    GFXcanvas16* canvas = m_parent_ui->buffer;
+    uint16_t* pixels = canvas->getBuffer();
+    const int16_t width = canvas->width();
+    //Only the damaged region is drawn, the rest of the canvas keeps what the previous frame left there
+    const Rect clip = m_parent_ui->getClip();
+    const int16_t left = clip.x, right = clip.x + clip.w;
+    const int16_t top = clip.y, bottom = clip.y + clip.h;
+
+    const Point pos = getPos();
+    for (uint8_t i = 0; i < m_length; i++){
+      const GlyphAtlas::Glyph* glyph = m_atlas->getGlyph(m_text[i]);
+      if (!glyph)
+        continue;
+      const GlyphAtlas::Span* spans = m_atlas->getSpans(*glyph);
+      const int16_t origin = pos.x + m_glyph_x[i];
+      for (uint8_t s = 0; s < glyph->span_count; s++){
+        const int16_t x0 = std::max<int16_t>(origin + spans[s].x * m_size, left);
+        const int16_t x1 = std::min<int16_t>(origin + (spans[s].x + spans[s].length) * m_size, right);
+        if (x0 >= x1)
+          continue;
+        for (uint8_t r = 0; r < m_size; r++){
+          const int16_t y = pos.y + spans[s].y * m_size + r;
+          if (y < top || y >= bottom)
+            continue;
+          uint16_t* row = pixels + y * width;
+          for (int16_t x = x0; x < x1; x++)
+            row[x] = m_color;
+        }
+      }
+    }
+  }
+
 //--------------------Scene STRUCT---------------------------------------------------------------//
 
   Scene::Scene(std::initializer_list<UIElement*> elementGroup, UIElement* first_focus){
 
     for(const auto elem : elementGroup){
-      elements.insert({elem->getId(),elem});
+      addElement(elem);
     }
 
-    primaryElementID = first_focus ? first_focus->getId() : "";
+    primaryElementID = first_focus ? first_focus->getId() : 0;
+  }
+
+  //Adds an element to the scene, the children of a group are added as well so that the focus can reach them
+  bool Scene::addElement(UIElement* element){
+    if (!insert(elements, element->getId(), element, "SIMPLEUI_MAX_ELEMENTS"))
+      return false;
+    m_state = SceneState::Cold;
+    m_batches_dirty = true;
+    if (m_parent_ui)
+      element->setUiListener(m_parent_ui);
+    bool added = true;
+    if (element->getType() == ElementType::Group){
+      for (const auto child : static_cast<Group*>(element)->getChildren())
+        added = addElement(child) && added;
+    }
+    return added;
   }
 
   
+  void Scene::m_renderElement(UIElement* element) const {
+    element->render();
+    if(element->isFocused()&&element->focus_style==FocusStyle::Outline)
+      element->drawFocusOutline(settings.focus.outline);
+  }
+
+  //Elements of an unknown type or of a class that can be derived from are rendered through the virtual call, they could be anything
+  template<>
+  void Scene::m_renderBatch<UIElement>(const RenderBatch& batch, const Rect& clip) const {
+    for (uint16_t i = batch.begin; i < batch.end; i++){
+      UIElement* element = m_batched[i];
+      if(element->draw && element->getBounds().intersects(clip))
+        m_renderElement(element);
+    }
+  }
+
+  //Only a final class can be called directly, an element of a class derived from T has to go through its own overrides
+  template<typename T>
+  void Scene::m_renderBatch(const RenderBatch& batch, const Rect& clip) const {
+    static_assert(std::is_final<T>::value, "the batches of classes that can be derived from are rendered through the virtual call");
+    for (uint16_t i = batch.begin; i < batch.end; i++){
+      T* element = static_cast<T*>(m_batched[i]);
+      if(element->draw && element->T::getBounds().intersects(clip)){
+        element->T::render();
+        if(element->isFocused()&&element->focus_style==FocusStyle::Outline)
+          element->drawFocusOutline(settings.focus.outline);
+      }
+    }
+  }
+
+  //Only the elements at the root are visited, groups render their own subtree
   void Scene::renderScene() const {
       if(!settings.scriptOnTop)
         m_script();
 
-      for (const auto&[id, element] : elements)
-      {
-        if(element->draw){
-          element->render();
-          if(element->isFocused()&&element->focus_style==FocusStyle::Outline)
-            element->drawFocusOutline(settings.focus.outline);
+      const Rect clip = m_parent_ui->getClip();
+      if (settings.batchRendering){
+        if (m_batches_dirty || m_geometryVersion() != m_batches_version)
+          m_buildBatches();
+        for (const RenderBatch& batch : m_batches){
+          switch (batch.type){
+            case ElementType::UIImage:     m_renderBatch<UIImage>(batch, clip);     break;
+            case ElementType::AnimatedApp: m_renderBatch<AnimatedApp>(batch, clip); break;
+            case ElementType::Checkbox:    m_renderBatch<Checkbox>(batch, clip);    break;
+            case ElementType::Label:       m_renderBatch<Label>(batch, clip);       break;
+            default:                       m_renderBatch<UIElement>(batch, clip);   break;
+          }
         }
       }
+      else{
+        forEachElement([this, &clip](UIElement* element){
+          if(element->draw && !element->getGroup() && element->getBounds().intersects(clip))
+            m_renderElement(element);
+        });
+      }
 
       if(settings.scriptOnTop)
         m_script();
     }
 
-  UIElement* Scene::getElementByUUID(std::string UUID) const {
-    if(!UUID.empty())
-      return elements.at(UUID);
+  /*!
+    @brief Sort the root elements into runs of the same type. Every element gets a layer one above the last element it overlaps
+    with of a different type, so sorting by layer and then by type never draws something under what used to cover it.
+  */
+  void Scene::m_buildBatches() const {
+    m_batched.clear();
+    m_batches.clear();
+    forEachElement([this](UIElement* element){
+      if (!element->getGroup())
+        m_batched.push_back(element);
+    });
+
+    const size_t count = m_batched.size();
+    List<uint16_t, SIMPLEUI_MAX_ELEMENTS> layers;
+    List<Rect, SIMPLEUI_MAX_ELEMENTS> bounds;
+    for (size_t i = 0; i < count; i++){
+      bounds.push_back(m_batched[i]->getBounds());
+      uint16_t layer = 0;
+      for (size_t j = 0; j < i; j++){
+        if (bounds[j].intersects(bounds[i])){
+          const uint16_t above = layers[j] + (m_batched[j]->getType() != m_batched[i]->getType());
+          layer = std::max(layer, above);
+        }
+      }
+      layers.push_back(layer);
+    }
+
+    //Stable insertion sort on (layer, type), the draw order inside a run is the original one
+    for (size_t i = 1; i < count; i++){
+      UIElement* element = m_batched[i];
+      const uint16_t layer = layers[i];
+      size_t j = i;
+      while (j > 0 && (layers[j - 1] > layer || (layers[j - 1] == layer && m_batched[j - 1]->getType() > element->getType()))){
+        m_batched[j] = m_batched[j - 1];
+        layers[j] = layers[j - 1];
+        j--;
+      }
+      m_batched[j] = element;
+      layers[j] = layer;
+    }
+
+    for (size_t i = 0; i < count; i++){
+      if (m_batches.empty() || m_batches.back().type != m_batched[i]->getType() || layers[i] != layers[m_batches.back().begin])
+        m_batches.push_back({m_batched[i]->getType(), static_cast<uint16_t>(i), static_cast<uint16_t>(i + 1)});
+      else
+        m_batches.back().end = i + 1;
+    }
+    m_batches_dirty = false;
+    m_batches_version = m_geometryVersion();
+  }
+
+  /*!
+    @brief Build the caches of the scene's elements so that its first frame doesn't hitch, along with the focus outline of its first element.
+    It can run on another thread while a different scene is on screen: only the elements write here, the state of the scene itself is
+    built by the UI when the scene is focused. If the scene is already being prepared somewhere else this waits for it to be done.
+  */
+  void Scene::prepare(){
+    SceneState expected = SceneState::Cold;
+    if (!m_state.compare_exchange_strong(expected, SceneState::Preparing)){
+      while (m_state == SceneState::Preparing){
+        #ifdef ESP32
+        vTaskDelay(1);
+        #else
+        std::this_thread::yield();
+        #endif
+      }
+      return;
+    }
+
+    forEachElement([](UIElement* element){ element->prepare(); });
+    const UIElement* first = getElementByID(primaryElementID);
+    if (m_parent_ui && first && first->focus_style == FocusStyle::Outline)
+      m_parent_ui->getOutlineCache().warm(first->getFocusRing(settings.focus.outline));
+    m_state = SceneState::Prepared;
+  }
+
+  //Prepare the scene if it isn't and build what the frames read, on the thread that renders
+  void Scene::m_activate(){
+    prepare();
+    if (m_state == SceneState::Ready)
+      return;
+    forEachElement([this](UIElement* element){
+      if (m_parent_ui)
+        element->setUiListener(m_parent_ui);
+      element->getBounds();
+    });
+    if (settings.batchRendering)
+      m_buildBatches();
+    m_refreshGraph();
+    m_state = SceneState::Ready;
+  }
+
+  UIElement* Scene::getElementByID(ElementID id) const {
+    if(id){
+      for (uint8_t i = 0; i < m_table.count; i++){
+        if (m_table.elements[i]->getId() == id)
+          return m_table.elements[i];
+      }
+      return elements.at(id);
+    }
     else
       return nullptr;
   }
 
+  /*!
+    @brief Look up the precomputed focus neighbour of an element of the scene's layout
+    @param from       The element the focus moves from
+    @param direction  The direction of the move in degrees
+    @param neighbour  Set to the element reached, nullptr if there's none
+    @return False if the layout can't answer, either because the move isn't covered by it or the settings changed since it was computed
+  */
+  bool Scene::findNeighbour(UIElement* from, unsigned int direction, UIElement*& neighbour) const {
+    if (!m_table.count || !from || direction % 90 || direction >= 360)
+      return false;
+    if (settings.focus.algorithm != FocusingAlgorithm::Linear || settings.focus.max_distance != m_table.max_distance
+        || UiUtils::rayStep(settings.focus.accuracy) != m_table.step || !elements.empty())
+      return false;
+    m_refreshGraph();
+    if (!m_table.slots)
+      return false;
+
+    for (uint8_t i = 0; i < m_table.count; i++){
+      if (m_table.elements[i] == from){
+        const int8_t index = m_table.slots[i].neighbours[direction / 90];
+        neighbour = index < 0 ? nullptr : m_table.elements[index];
+        return !neighbour || neighbour->focusable;  //A neighbour that has been disabled makes the search go further
+      }
+    }
+    return false;
+  }
+
+  uint32_t Scene::m_geometryVersion() const {
+    uint32_t version = 0;
+    forEachElement([&version](UIElement* element){ version += element->getGeometryVersion(); });
+    return version;
+  }
+
+  /*The compile time graph only holds while the elements stay where the layout put them. A move or resize of one of the scene's elements
+  changes its geometry version, the table is then compared with the slots and the graph is linked again in RAM if one of them changed.*/
+  void Scene::m_refreshGraph() const {
+    const uint32_t version = m_geometryVersion();
+    if (!m_table.count || !m_table.slots || version == m_geometry_version)
+      return;
+    m_geometry_version = version;
+    bool changed = false;
+    for (uint8_t i = 0; i < m_table.count && !changed; i++){
+      const UIElement* element = m_table.elements[i];
+      const LayoutSlot& slot = m_table.slots[i];
+      const Point pos = element->getPos();
+      changed = pos.x != slot.corner.x || pos.y != slot.corner.y || element->getWidth() != slot.width || element->getHeight() != slot.height;
+    }
+    if (!changed)
+      return;
+
+    m_graph.clear();
+    for (uint8_t i = 0; i < m_table.count; i++){
+      const UIElement* element = m_table.elements[i];
+      const LayoutSlot slot{element->getPos(), static_cast<uint16_t>(element->getWidth()), static_cast<uint16_t>(element->getHeight()), {-1, -1, -1, -1}};
+      if (!append(m_graph, slot, "SIMPLEUI_MAX_ELEMENTS")){
+        m_table.slots = nullptr;   //The focus goes back to searching the scene
+        return;
+      }
+    }
+    linkLayout(&m_graph[0], m_graph.size(), m_table.max_distance, m_table.step);
+    m_table.slots = &m_graph[0];
+  }
+
+  //A layout entry whose size isn't the one of its element is reported, the graph is then linked again with the real sizes
+  void Scene::m_checkLayout(){
+    bool matches = true;
+    for (uint8_t i = 0; i < m_table.count; i++){
+      const UIElement* element = m_table.elements[i];
+      const LayoutSlot& slot = m_table.slots[i];
+      if (element->getWidth() != slot.width || element->getHeight() != slot.height){
+        Serial.printf("SimpleUI: layout entry %u is %ux%u but its element is %ux%u, the focus graph is linked again\n", static_cast<unsigned int>(i),
+                      static_cast<unsigned int>(slot.width), static_cast<unsigned int>(slot.height), element->getWidth(), element->getHeight());
+        matches = false;
+      }
+    }
+    if (!matches){
+      m_geometry_version = m_geometryVersion() - 1;
+      m_refreshGraph();
+    }
+  }
+
   void Scene::addParents(std::initializer_list<Scene*> scenes){
     for(const auto scene : scenes){
-      parents.push_back(scene);
+      append(parents, scene, "SIMPLEUI_MAX_PARENTS");
     }
   }
 
@@ -364,85 +1026,367 @@ void AnimatedApp::render(){
     }
   }
 
-  void UI::AddScene(Scene* scene){
+  bool UI::AddScene(Scene* scene){
 
-    scenes.push_back(scene);                 //KEEP IN MIND "REALLOCATES"
+    if (!append(scenes, scene, "SIMPLEUI_MAX_SCENES"))   //KEEP IN MIND "REALLOCATES"
+      return false;
     scene->m_parent_ui = this;
-    for(const auto&[id, element] : scene->elements){
+    scene->forEachElement([this](UIElement* element){
       element->setUiListener(this);
-    }
-    
+    });
+    return true;
+  }
+
+  UI::~UI(){
+    #if !defined(ESP32) && !SIMPLEUI_STATIC_MEMORY
+    if (m_preloader.joinable())
+      m_preloader.join();
+    #endif
   }
 
   void UI::FocusScene(Scene* scene){
+      if (scene)
+        scene->m_activate();
+      m_gliding = false;
       focus.focusScene(scene);
     }
 
+  #if defined(ESP32) && !SIMPLEUI_STATIC_MEMORY
+  static void preloadTask(void* scene){
+    static_cast<Scene*>(scene)->prepare();
+    vTaskDelete(nullptr);
+  }
+  #endif
+
+  /*!
+    @brief Prepare a scene in the background, on the other core on the ESP32 or on a worker thread everywhere else.
+    Focusing the scene before it's done waits for the preparation to finish. The static memory profile prepares it right away.
+  */
+  void UI::PreloadScene(Scene* scene){
+    if (!scene || scene->isPreparing())
+      return;
+    if (std::find(scenes.begin(), scenes.end(), scene) == scenes.end())
+      AddScene(scene);
+
+    if (scene == focus.activeScene){
+      scene->prepare();   //The scene on screen is never written from another thread
+      return;
+    }
+    #if SIMPLEUI_STATIC_MEMORY
+    scene->prepare();  //Tasks and threads allocate their stack, so the static profile prepares in place
+    #elif defined(ESP32)
+    xTaskCreatePinnedToCore(preloadTask, "Preload", 4096, scene, 1, nullptr, xPortGetCoreID() ? 0 : 1);
+    #else
+    if (m_preloader.joinable())
+      m_preloader.join();
+    m_preloader = std::thread([scene](){ scene->prepare(); });
+    #endif
+  }
+
+  /*!
+    @brief Focus a scene with an animated transition from the current frame. Call it between two frames, since the framebuffer
+    is taken as the outgoing frame.
+    @param scene      The scene to focus
+    @param transition How the new scene enters the screen
+    @param duration   The duration of the transition in milliseconds
+  */
+  void UI::TransitionTo(Scene* scene, Transition transition, unsigned int duration){
+    if (!scene)
+      return;
+    const bool can_composite = m_snapshot && m_snapshot->width() == buffer->width() && m_snapshot->height() == buffer->height();
+    if (transition != Transition::None && can_composite){
+      memcpy(m_snapshot->getBuffer(), buffer->getBuffer(), static_cast<size_t>(buffer->width()) * buffer->height() * sizeof(uint16_t));
+      m_transition = transition;
+      m_transition_anim = Animation(0.0f, 1.0f, duration, 2.0f);
+      m_transition_anim.Start();
+    }
+    FocusScene(scene);
+  }
+
+  //Mixes the freshly rendered frame with the outgoing one, the cost is a copy or a blend of the frame regardless of the scenes' content
+  void UI::m_compositeTransition(){
+    INSTRUMENTATE(this)
+    const float t = m_transition_anim.getProgress();
+    const size_t w = buffer->width();
+    const size_t h = buffer->height();
+    uint16_t* next = buffer->getBuffer();
+    const uint16_t* prev = m_snapshot->getBuffer();
+
+    switch (m_transition){
+      case Transition::SlideLeft:
+      case Transition::SlideRight:{
+        const size_t offset = std::min(w, static_cast<size_t>(round(t * w)));
+        const bool left = m_transition == Transition::SlideLeft;
+        parallelRows(h, w, [&](unsigned int begin, unsigned int end){
+          for (size_t y = begin; y < end; y++){
+            uint16_t* row = next + y * w;
+            const uint16_t* old_row = prev + y * w;
+            if (left){
+              memmove(row + (w - offset), row, offset * sizeof(uint16_t));
+              memcpy(row, old_row + offset, (w - offset) * sizeof(uint16_t));
+            }
+            else{
+              memmove(row, row + (w - offset), offset * sizeof(uint16_t));
+              memcpy(row + offset, old_row, (w - offset) * sizeof(uint16_t));
+            }
+          }
+        });
+        break;
+      }
+      case Transition::SlideUp:{
+        const size_t offset = std::min(h, static_cast<size_t>(round(t * h)));
+        memmove(next + (h - offset) * w, next, offset * w * sizeof(uint16_t));
+        memcpy(next, prev + offset * w, (h - offset) * w * sizeof(uint16_t));
+        break;
+      }
+      case Transition::SlideDown:{
+        const size_t offset = std::min(h, static_cast<size_t>(round(t * h)));
+        memmove(next, next + (h - offset) * w, offset * w * sizeof(uint16_t));
+        memcpy(next + offset * w, prev, (h - offset) * w * sizeof(uint16_t));
+        break;
+      }
+      case Transition::Fade:{
+        const uint8_t alpha = static_cast<uint8_t>(round(t * 32.0f));
+        parallelRows(h, w, [&](unsigned int begin, unsigned int end){
+          for (size_t i = begin * w; i < end * w; i++)
+            next[i] = blend565(prev[i], next[i], alpha);
+        });
+        break;
+      }
+      case Transition::None:
+        break;
+    }
+
+    if (m_transition_anim.getState() == AnimState::Finished)
+      m_transition = Transition::None;
+  }
+
   void UI::Back(){
     if (focus.previousScene){
       Serial.println("Back!");
       if ( !(focus.activeScene->parents.empty()) ) {
-        focus.focusScene(focus.previousScene);
+        FocusScene(focus.previousScene);
       }
     }else{
       return;
     }
   }
 
-  void UI::Click(){
+  /// @brief Interact with the focused element
+  /// @param input_time When the input was registered (micros), any value is a valid time. Only used by the latency profiler
+  void UI::Click(uint32_t input_time){
+    #if LATENCY_PROFILING
+    latency.stampInput(input_time);
+    #endif
     UIElement* focused = getFocused();
     if(focused)
       focused->click();
-    else
-      return;
+    #if LATENCY_PROFILING
+    latency.stampFocus(m_clock->micros());
+    #endif
   }
 
 
-  /// @brief Focus the closest object in any direction
+  /// @brief Focus the closest object in any direction, the request is queued and resolved by the next Render()
   /// @param direction The direction in counter clockwise degrees, with its origin being the center of the currently focused element (Right is 0)
-  /// @param alg The focusing algorithm that you want to use (FocusingAlgorithm::Linear, FocusingAlgorithm::Cone)
-  void UI::FocusDirection(unsigned int direction){
+  /// @param input_time When the input was registered (micros), any value is a valid time. Only used by the latency profiler
+  /// @return False if the request was dropped because SIMPLEUI_MAX_FOCUS_MOVES requests are already queued for this frame
+  bool UI::FocusDirection(unsigned int direction, uint32_t input_time){
     INSTRUMENTATE(this)
-    m_focusDir(direction);
+    #if LATENCY_PROFILING
+    latency.stampInput(input_time);
+    #endif
+    return m_focusDir(direction);
   }
 
-  /// @brief Focus the closest object in any direction
+  /// @brief Focus the closest object in any direction, the request is queued and resolved by the next Render()
   /// @param direction The direction in counter clockwise degrees, with its origin being the center of the currently focused element (Right is 0)
-  /// @param alg The focusing algorithm that you want to use (FocusingAlgorithm::Linear, FocusingAlgorithm::Cone)
-  void UI::FocusDirection(Direction direction){
-    INSTRUMENTATE(this)
-    m_focusDir(static_cast<unsigned int>(direction));
+  /// @param input_time When the input was registered (micros), any value is a valid time. Only used by the latency profiler
+  /// @return False if the request was dropped because SIMPLEUI_MAX_FOCUS_MOVES requests are already queued for this frame
+  bool UI::FocusDirection(Direction direction, uint32_t input_time){
+    return FocusDirection(static_cast<unsigned int>(direction), input_time);
   }
 
   void UI::Render(){
+    m_beginFrame();
+    m_arena.reset();
+    #if SIMPLEUI_ALLOC_GUARD
+    const size_t allocations = AllocGuard::allocations();
+    m_steady_frames = (m_focusQueue.empty() && !focus.hasChanged() && m_transition == Transition::None) ? m_steady_frames + 1 : 0;
+    #endif
+    m_resolveFocus();
+    #if LATENCY_PROFILING
+    latency.stampFocus(m_clock->micros());
+    #endif
+    //Every animation advances here at once, the elements only read their progress while rendering
+    AnimationStore::global().update(m_frame_time);
+    if (m_gliding){
+      //The elements under the swept region have to be drawn again to erase the previous ring
+      if (!m_glide_pinned)
+        m_glide_next = OutlineRing::lerp(m_glide_from, m_glide_to, m_glide_anim.getProgress());
+      if (m_damage.w != INT16_MAX || m_damage.h != INT16_MAX)
+        m_damage.merge(Rect(m_glide_last.bounds).merge(m_glide_next.bounds));
+    }
     if (focus.activeScene)
       focus.activeScene->renderScene();
+    if (m_gliding)
+      m_drawGlide();
+    if (m_transition != Transition::None)
+      m_compositeTransition();
+    #if LATENCY_PROFILING
+    latency.stampFrame(m_clock->micros());
+    #endif
     m_updateFocus();
+    m_damage = Rect(0, 0, INT16_MAX, INT16_MAX);
+    m_frame_begun = false;
+    #if SIMPLEUI_ALLOC_GUARD
+    assert((m_steady_frames < SETTLING_FRAMES || AllocGuard::allocations() == allocations) && "Heap allocation in a steady state frame");
+    #endif
   }
 
-  void UI::m_focusDir(unsigned int direction){
-    if(isFocusingFree()){
-      m_focusing_busy = true;
+  //Call this once the rendered frame has been completely transferred to the display, it closes the latency measurement of the pending input
+  void UI::Presented(){
+    #if LATENCY_PROFILING
+    latency.stampBlit(m_clock->micros());
+    #endif
+  }
 
-      UIElement* next_element;
-      if (focus.activeScene->elements.empty())
-        return;
-      else
-        if (!focus.focusedElementID.empty())
-          next_element = UiUtils::SignedDistance(direction, focus.activeScene, focus.activeScene->getElementByUUID(focus.focusedElementID));
-        else
-          next_element = UiUtils::SignedDistance(direction, focus.activeScene, nullptr);
+  bool UI::m_focusDir(unsigned int direction){
+    if (!m_focusQueue.empty() && m_focusQueue.back().direction == direction){
+      m_focusQueue.back().steps++;
+      return true;
+    }
+    return append(m_focusQueue, FocusMove{direction, 1U}, "SIMPLEUI_MAX_FOCUS_MOVES");
+  }
 
-      if (next_element){
-        focus.focus(next_element->getId());
-        focus.focusedElementID = next_element->getId();
+  //Walks every queued move starting from the focused element and applies only the final result
+  void UI::m_resolveFocus(){
+    INSTRUMENTATE(this)
+    if (m_focusQueue.empty())
+      return;
+
+    if (focus.activeScene && !focus.activeScene->empty()){
+      UIElement* const start = getFocused();
+      UIElement* current = start;
+      for (const FocusMove& move : m_focusQueue){
+        for (unsigned int i = 0; i < move.steps; i++){
+          if (current && current->navigate(move.direction))  //The element moved its inner focus, no need to search the scene
+            continue;
+          UIElement* next = m_focusStep(current, move.direction);
+          if (!next)  //Reached the edge, the remaining steps in this direction would find nothing as well
+            break;
+          current = next;
+        }
       }
+      if (current && current != start){
+        focus.focus(current->getId());
+        m_startGlide(start, current);
+      }
+    }
+
+    m_focusQueue.clear();
+    m_focusMemo.clear();
+  }
+
+  //A single search in the neighbourhood of an element, memoized so that going back and forth in the same cycle doesn't search twice
+  UIElement* UI::m_focusStep(UIElement* from, unsigned int direction){
+    for (const FocusStep& step : m_focusMemo){
+      if (step.from == from && step.direction == direction)
+        return step.to;
     }
+    UIElement* to;
+    if (!focus.activeScene->findNeighbour(from, direction, to))
+      to = UiUtils::SignedDistance(direction, focus.activeScene, from);
+    //The memo is only a shortcut, a full one just means searching again
+    if (m_focusMemo.size() < SIMPLEUI_MAX_FOCUS_MOVES * 2)
+      m_focusMemo.push_back({from, direction, to});
+    return to;
   }
 
   void UI::m_updateFocus(){
     focus.update();
-    m_focusing_busy = false;
+  }
+
+  //Only a move between two elements that are outlined when focused glides, any other focus change shows up at once
+  void UI::m_startGlide(UIElement* from, UIElement* to){
+    const Scene::SceneSettings::FocusingSettings& settings = focus.activeScene->settings.focus;
+    if (!settings.glide_duration || !from || from->focus_style != FocusStyle::Outline || to->focus_style != FocusStyle::Outline){
+      m_gliding = false;
+      return;
+    }
+    //A new move halfway through a glide starts from where the outline currently is
+    m_glide_from = m_gliding ? m_glide_last : from->getFocusRing(settings.outline);
+    m_glide_to = to->getFocusRing(settings.outline);
+    if (!m_gliding)
+      m_glide_last = m_glide_from;
+    m_glide_anim = Animation(0.0f, 1.0f, settings.glide_duration, settings.glide_easing);
+    m_glide_anim.Start();
+    m_gliding = true;
+    m_glide_pinned = false;
+  }
+
+  void UI::m_drawGlide(){
+    INSTRUMENTATE(this)
+    if (m_glide_next.thickness)
+      m_outlines.stroke(buffer, m_glide_next);
+    m_glide_last = m_glide_next;
+    m_glide_pinned = false;
+    //The last frame of the glide draws the ring exactly where the focused element draws its own from the next one on
+    if (m_glide_anim.getState() == AnimState::Finished)
+      m_gliding = false;
+  }
+
+  /*!
+    @brief The region the focus outline is going to sweep in the next Render(), from the ring drawn in the last frame to the next one.
+    An application that only redraws what changes can clear it and pass it to setDamage(), the next frame draws exactly the ring
+    this was computed for. A move queued for the next frame is resolved here, so its glide is included.
+    @return An empty rectangle when the outline isn't gliding
+  */
+  Rect UI::getFocusDamage(){
+    m_beginFrame();
+    m_resolveFocus();
+    if (!m_gliding)
+      return Rect();
+    m_glide_anim.Update();
+    m_glide_next = OutlineRing::lerp(m_glide_from, m_glide_to, m_glide_anim.getProgress());
+    m_glide_pinned = true;
+    return Rect(m_glide_last.bounds).merge(m_glide_next.bounds);
+  }
+
+  /*!
+    @brief The region the animated elements of the active scene are going to change in the next Render(), the animations are advanced
+    to the time of that frame right away. The elements whose animation didn't move enough to change a pixel aren't included.
+    The queued focus moves are resolved first, the animations they start have to be in the update Render() then skips.
+  */
+  Rect UI::getAnimationDamage(){
+    m_beginFrame();
+    m_resolveFocus();
+    AnimationStore::global().update(m_frame_time);
+    Rect damage;
+    if (focus.activeScene){
+      focus.activeScene->forEachElement([&damage](UIElement* element){
+        if (element->hasAnimationChanged())
+          damage.merge(element->getAnimationDamage());
+      });
+    }
+    return damage;
+  }
+
+  //The only read of the clock in a frame, everything rendered in it shares the same time. Asking for the damage of a frame starts it early
+  void UI::m_beginFrame(){
+    if (m_frame_begun)
+      return;
+    m_frame_time = m_clock->now();
+    AnimationStore::global().setTime(m_frame_time);
+    m_frame_begun = true;
+  }
+
+  Rect UI::getClip() const {
+    const int x = std::max(m_damage.x, 0);
+    const int y = std::max(m_damage.y, 0);
+    const int right = std::min(m_damage.x + m_damage.w, static_cast<int>(buffer->width()));
+    const int bottom = std::min(m_damage.y + m_damage.h, static_cast<int>(buffer->height()));
+    return Rect(x, y, right - x, bottom - y);
   }
 
   #if PERFORMANCE_PROFILING
@@ -460,6 +1404,384 @@ void AnimatedApp::render(){
   }
   #endif
 
+//--------------------Replay CLASS---------------------------------------------------------------//
+
+  size_t Replay::run(ReplayFrame* frames, size_t capacity, uint32_t settle){
+    Clock& previous = m_ui->getClock();
+    m_ui->setClock(&m_clock);
+    m_clock.set(0);
+
+    //Counted in 64 bits so the loop ends even when the session reaches the last microsecond frames can record, it is cut there
+    const uint64_t end = std::min<uint64_t>(static_cast<uint64_t>(m_count ? m_events[m_count - 1].time : 0) + settle, UINT32_MAX);
+    size_t next_event = 0;
+    size_t rendered = 0;
+    for (uint64_t time = 0; time <= end && (!frames || rendered < capacity); time += m_interval){
+      m_clock.set(time);
+      for (; next_event < m_count && m_events[next_event].time <= time; next_event++){
+        const ReplayEvent& event = m_events[next_event];
+        switch (event.input){
+          case ReplayInput::Direction: m_ui->FocusDirection(event.direction, event.time); break;
+          case ReplayInput::Click:     m_ui->Click(event.time);                           break;
+          case ReplayInput::Back:      m_ui->Back();                                      break;
+        }
+      }
+      if (m_background >= 0)
+        m_ui->buffer->fillScreen(static_cast<uint16_t>(m_background));
+      const uint32_t start = micros();
+      m_ui->Render();
+      const uint32_t render_time = micros() - start;
+      if (frames)
+        frames[rendered] = {static_cast<uint32_t>(time), hashFrame(m_ui->buffer), render_time};
+      rendered++;
+    }
+
+    m_ui->setClock(&previous);
+    return rendered;
+  }
+
+  uint32_t Replay::hashFrame(const GFXcanvas16* canvas){
+    const uint16_t* pixels = canvas->getBuffer();
+    const size_t count = static_cast<size_t>(canvas->width()) * canvas->height();
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < count; i++){
+      hash = (hash ^ (pixels[i] & 0xFF)) * 16777619UL;
+      hash = (hash ^ (pixels[i] >> 8)) * 16777619UL;
+    }
+    return hash;
+  }
+
+  int Replay::compare(const ReplayFrame* frames, const uint32_t* golden, size_t count){
+    for (size_t i = 0; i < count; i++){
+      if (frames[i].hash != golden[i])
+        return static_cast<int>(i);
+    }
+    return -1;
+  }
+
+  void Replay::print(const ReplayFrame* frames, size_t count){
+    Serial.printf("frame,time,hash,render_us\n");
+    for (size_t i = 0; i < count; i++)
+      Serial.printf("%u,%u,%08x,%u\n", static_cast<unsigned int>(i), static_cast<unsigned int>(frames[i].time),
+                    static_cast<unsigned int>(frames[i].hash), static_cast<unsigned int>(frames[i].render_time));
+  }
+
+//--------------------Telemetry CLASS---------------------------------------------------------------//
+
+  void Telemetry::sample(uint32_t render_time){
+    const uint64_t time = m_ui->getFrameTime();
+    m_writer.write(FrameRecord{m_frame, static_cast<uint32_t>(time), m_frame ? static_cast<uint32_t>(time - m_last_time) : 0U, render_time});
+    m_last_time = time;
+
+    const uint16_t slot = m_frame % m_interval;
+    switch (slot){
+      case 0: m_sendHeap();       break;
+      case 1: m_sendAnimations(); break;
+      case 2: m_sendProfile();    break;
+    }
+    if (slot == 3 % m_interval || m_ui->focus.focusedElementID != m_last_element || m_ui->getActiveScene() != m_last_scene)
+      m_sendFocus();
+    m_frame++;
+  }
+
+  void Telemetry::m_sendFocus(){
+    const Scene* scene = m_ui->getActiveScene();
+    uint8_t index = 0xFF;
+    for (size_t i = 0; i < m_ui->scenes.size(); i++){
+      if (m_ui->scenes[i] == scene)
+        index = static_cast<uint8_t>(i);
+    }
+    const uint8_t flags = (m_ui->isFocusGliding() ? FocusRecord::GLIDING : 0) | (m_ui->isTransitioning() ? FocusRecord::TRANSITIONING : 0) |
+                          (m_ui->isFocusingFree() ? 0 : FocusRecord::PENDING);
+    m_writer.write(FocusRecord{m_frame, m_ui->focus.focusedElementID, index, flags});
+    m_last_element = m_ui->focus.focusedElementID;
+    m_last_scene = scene;
+  }
+
+  void Telemetry::m_sendHeap(){
+    HeapRecord record{0, 0, 0, static_cast<uint32_t>(m_ui->getArena().getPeak())};
+    #ifdef ESP32
+    record.free = ESP.getFreeHeap();
+    record.min_free = ESP.getMinFreeHeap();
+    record.largest_block = ESP.getMaxAllocHeap();
+    #endif
+    m_writer.write(record);
+  }
+
+  void Telemetry::m_sendAnimations(){
+    const AnimationStore& store = AnimationStore::global();
+    AnimationRecord record{store.getUsed(), store.getOverflows(), 0, 0, 0xFF, 0.0f};
+    store.countStates(record.running, record.dirty);
+    UIElement* focused = m_ui->getActiveScene() ? m_ui->getFocused() : nullptr;
+    if (const Animation* anim = focused ? focused->getAnimation() : nullptr){
+      record.state = static_cast<uint8_t>(anim->getState());
+      record.progress = anim->getProgress();
+    }
+    m_writer.write(record);
+  }
+
+  //The names are sent the first time a site shows up and again every few rounds, so a decoder that joins late learns them too
+  void Telemetry::m_sendProfile(){
+    #if PERFORMANCE_PROFILING
+    const bool announce = m_profile_rounds++ % 8 == 0;
+    for (const auto& [name, time] : m_ui->getPerfStats()){
+      uint16_t id = 0;
+      while (id < m_sites.size() && m_sites[id] != name)
+        id++;
+      const bool known = id < m_sites.size();
+      if (!known)
+        m_sites.push_back(name);
+      if (!known || announce){
+        SiteRecord site{id, {}};
+        strncpy(site.name, name.c_str(), SIMPLEUI_TELEMETRY_NAME);
+        m_writer.write(site);
+      }
+      m_writer.write(ProfileRecord{id, time});
+    }
+    #endif
+  }
+
+//--------------------OutlineRing STRUCT---------------------------------------------------------------//
+
+  OutlineRing::OutlineRing(const Outline& outline, const Rect& around)
+    : bounds(around), thickness(outline.thickness), color(outline.color)
+  {
+    bounds.inflate(outline.border_distance + outline.thickness);
+    radius = outline.radius ? outline.radius + outline.thickness - 1 : 0;
+    hole_radius = outline.radius ? outline.radius - 1 : 0;
+  }
+
+  OutlineRing OutlineRing::lerp(const OutlineRing& from, const OutlineRing& to, float t){
+    //A single conversion of the progress, every dimension is then mixed in integers and rounded once
+    const int32_t q = static_cast<int32_t>(t * 4096.0f + 0.5f);
+    auto mix = [q](int a, int b){ return a + (((b - a) * q + 2048) >> 12); };
+    OutlineRing ring;
+    ring.bounds = Rect(mix(from.bounds.x, to.bounds.x), mix(from.bounds.y, to.bounds.y), mix(from.bounds.w, to.bounds.w), mix(from.bounds.h, to.bounds.h));
+    ring.radius = mix(from.radius, to.radius);
+    ring.thickness = mix(from.thickness, to.thickness);
+    ring.hole_radius = mix(from.hole_radius, to.hole_radius);
+    ring.color = (mix(from.color >> 11, to.color >> 11) << 11) | (mix((from.color >> 5) & 0x3F, (to.color >> 5) & 0x3F) << 5) | mix(from.color & 0x1F, to.color & 0x1F);
+    return ring;
+  }
+
+//--------------------OutlineCache CLASS---------------------------------------------------------------//
+
+  //!@return How many pixels a row of a rounded rectangle is inset from its left edge, pixels are inside if their center is
+  static uint16_t roundedInset(int w, int h, int radius, int y){
+    radius = std::min(radius, std::min(w, h) / 2);
+    if (y >= h - radius)
+      y = h - 1 - y;
+    if (y >= radius)
+      return 0;
+    const float dy = radius - y - 0.5f;
+    return static_cast<uint16_t>(ceilf(radius - sqrtf(radius * radius - dy * dy) - 0.5f));
+  }
+
+  void OutlineCache::m_rowInsets(const Entry& entry, int y, uint16_t* insets){
+    const int hole_w = entry.w - entry.thickness * 2;
+    const int hole_h = entry.h - entry.thickness * 2;
+    const int hole_y = y - entry.thickness;
+    insets[0] = roundedInset(entry.w, entry.h, entry.radius, y);
+    insets[1] = (hole_w > 0 && hole_h > 0 && hole_y >= 0) ? entry.thickness + roundedInset(hole_w, hole_h, entry.hole_radius, hole_y) : NO_HOLE;
+  }
+
+  void OutlineCache::m_rasterize(Entry& entry){
+    const int rows = std::min<int>((entry.h + 1) / 2, ROWS);
+    for (int y = 0; y < rows; y++)
+      m_rowInsets(entry, y, entry.rows[y]);
+  }
+
+  void OutlineCache::m_fill(GFXcanvas16* canvas, Point pos, const Entry& entry, uint16_t color){
+    uint16_t* pixels = canvas->getBuffer();
+    const int width = canvas->width();
+    const int height = canvas->height();
+    const auto span = [&](int y, int from, int to){
+      from = std::max(from + pos.x, 0);
+      to = std::min(to + pos.x, width);
+      uint16_t* row = pixels + y * width;
+      for (int x = from; x < to; x++)
+        row[x] = color;
+    };
+
+    for (int y = 0; y < entry.h; y++){
+      const int canvas_y = pos.y + y;
+      if (canvas_y < 0)
+        continue;
+      if (canvas_y >= height)
+        break;
+      const int mirrored = y < entry.h / 2 ? y : entry.h - 1 - y;
+      uint16_t computed[2];
+      const uint16_t* insets = computed;
+      if (mirrored < ROWS)
+        insets = entry.rows[mirrored];
+      else  //Rows of outlines taller than the cache holds are computed on the spot
+        m_rowInsets(entry, mirrored, computed);
+      if (insets[1] == NO_HOLE)
+        span(canvas_y, insets[0], entry.w - insets[0]);
+      else{
+        span(canvas_y, insets[0], insets[1]);
+        span(canvas_y, entry.w - insets[1], entry.w - insets[0]);
+      }
+    }
+  }
+
+  OutlineCache::Entry* OutlineCache::m_find(uint16_t w, uint16_t h, uint16_t radius, uint8_t thickness, uint8_t hole_radius, Entry*& oldest){
+    oldest = &m_entries[0];
+    for (Entry& entry : m_entries){
+      if (entry.w == w && entry.h == h && entry.radius == radius && entry.thickness == thickness && entry.hole_radius == hole_radius)
+        return &entry;
+      if (entry.last_used < oldest->last_used)
+        oldest = &entry;
+    }
+    return nullptr;
+  }
+
+  void OutlineCache::warm(uint16_t w, uint16_t h, uint16_t radius, uint8_t thickness, uint8_t hole_radius){
+    if (!w || !h || !thickness)
+      return;
+    Entry entry;
+    entry.w = w;
+    entry.h = h;
+    entry.radius = radius;
+    entry.thickness = thickness;
+    entry.hole_radius = hole_radius;
+    m_rasterize(entry);   //Outside of the lock, the entry is still private to this thread
+
+    while (m_warm_lock.test_and_set(std::memory_order_acquire));
+    if (m_warmed_count < SIMPLEUI_OUTLINE_WARMUPS)
+      m_warmed[m_warmed_count++] = entry;
+    m_warm_lock.clear(std::memory_order_release);
+    m_has_warmed.store(true, std::memory_order_release);
+  }
+
+  //Move the rings handed over by warm() into the cache, they count as used now so the first frame that needs them finds them
+  void OutlineCache::m_takeWarmed(){
+    while (m_warm_lock.test_and_set(std::memory_order_acquire));
+    m_has_warmed.store(false, std::memory_order_relaxed);
+    for (uint8_t i = 0; i < m_warmed_count; i++){
+      const Entry& warmed = m_warmed[i];
+      Entry* oldest;
+      Entry* entry = m_find(warmed.w, warmed.h, warmed.radius, warmed.thickness, warmed.hole_radius, oldest);
+      if (!entry)
+        entry = &(*oldest = warmed);
+      entry->last_used = ++m_clock;
+    }
+    m_warmed_count = 0;
+    m_warm_lock.clear(std::memory_order_release);
+  }
+
+  void OutlineCache::stroke(GFXcanvas16* canvas, Point pos, uint16_t w, uint16_t h, uint16_t radius, uint8_t thickness, uint8_t hole_radius, uint16_t color){
+    if (!w || !h)
+      return;
+    if (m_has_warmed.load(std::memory_order_acquire))
+      m_takeWarmed();
+    m_clock++;
+    Entry* oldest;
+    Entry* entry = m_find(w, h, radius, thickness, hole_radius, oldest);
+    if (!entry){
+      m_misses++;
+      entry = oldest;
+      entry->w = w;
+      entry->h = h;
+      entry->radius = radius;
+      entry->thickness = thickness;
+      entry->hole_radius = hole_radius;
+      m_rasterize(*entry);
+    }
+    entry->last_used = m_clock;
+    m_fill(canvas, pos, *entry, color);
+  }
+
+//--------------------LatencyTracker CLASS---------------------------------------------------------------//
+
+  #if LATENCY_PROFILING
+  void LatencyHistogram::add(uint32_t time){
+    uint8_t bucket = 0;
+    while (bucket < BUCKETS - 1 && (time >> (bucket + 1)))
+      bucket++;
+    buckets[bucket]++;
+    count++;
+    sum += time;
+    if (time > max)
+      max = time;
+  }
+
+  void LatencyHistogram::clear(){
+    *this = LatencyHistogram();
+  }
+
+  /// @param p The percentile in the range [0, 1]
+  /// @return The upper bound of the bucket that contains the requested percentile
+  uint32_t LatencyHistogram::percentile(float p) const {
+    if (!count)
+      return 0;
+    const uint32_t target = static_cast<uint32_t>(std::ceil(p * count));
+    uint32_t seen = 0;
+    for (uint8_t i = 0; i < BUCKETS; i++){
+      seen += buckets[i];
+      if (seen >= target && seen)
+        return std::min((2UL << i) - 1, static_cast<unsigned long>(max));
+    }
+    return max;
+  }
+
+  //Only the oldest input is followed, the ones that come while it's still pending share its frame and would only skew the results
+  void LatencyTracker::stampInput(uint32_t time){
+    if (m_stage == Pending::None){
+      m_input = time;
+      m_stage = Pending::Focus;
+    }
+  }
+
+  void LatencyTracker::stampFocus(uint32_t time){
+    if (m_stage == Pending::Focus){
+      m_focus = time;
+      m_stage = Pending::Frame;
+    }
+  }
+
+  void LatencyTracker::stampFrame(uint32_t time){
+    if (m_stage == Pending::Frame){
+      m_frame = time;
+      m_stage = Pending::Blit;
+    }
+  }
+
+  void LatencyTracker::stampBlit(uint32_t time){
+    if (m_stage == Pending::Blit){
+      m_histograms[static_cast<uint8_t>(LatencyStage::Focus)].add(m_focus - m_input);
+      m_histograms[static_cast<uint8_t>(LatencyStage::Frame)].add(m_frame - m_focus);
+      m_histograms[static_cast<uint8_t>(LatencyStage::Blit)].add(time - m_frame);
+      m_histograms[static_cast<uint8_t>(LatencyStage::Total)].add(time - m_input);
+      m_stage = Pending::None;
+    }
+  }
+
+  void LatencyTracker::clear(){
+    for (auto& histogram : m_histograms)
+      histogram.clear();
+    m_stage = Pending::None;
+  }
+
+  void LatencyTracker::print() const {
+    static const char* names[] = {"Focus", "Frame", "Blit", "Total"};
+    for (uint8_t i = 0; i < 4; i++){
+      const LatencyHistogram& histogram = m_histograms[i];
+      Serial.printf("%s: n=%lu mean=%luus p50<=%luus p99<=%luus max=%luus\n", names[i], static_cast<unsigned long>(histogram.count),
+                    static_cast<unsigned long>(histogram.mean()), static_cast<unsigned long>(histogram.percentile(0.5f)),
+                    static_cast<unsigned long>(histogram.percentile(0.99f)), static_cast<unsigned long>(histogram.max));
+      for (uint8_t b = 0; b < LatencyHistogram::BUCKETS; b++){
+        if (!histogram.buckets[b])
+          continue;
+        const unsigned int bar = std::max(1UL, static_cast<unsigned long>(histogram.buckets[b]) * 32UL / histogram.count);
+        Serial.printf("  <%7luus %6lu ", 2UL << b, static_cast<unsigned long>(histogram.buckets[b]));
+        for (unsigned int c = 0; c < bar; c++)
+          Serial.print('#');
+        Serial.println();
+      }
+    }
+  }
+  #endif
+
 //--------------------UiUtils NAMESPACE---------------------------------------------------------------//
 
   namespace UiUtils{
@@ -471,41 +1793,16 @@ void AnimatedApp::render(){
         return false;
       }
 
-    /*!
-        @param x_pos  X coordinate of the top-left corner
-        @param y_pos  Y coordinate of the top-left corner
-        @param w      Width in pixels
-        @param h      Height in pixels
-        @return The center point of the described boundary
-      */
-    const Point centerPos(int x_pos, int y_pos, const unsigned int w, const unsigned int h){
-        int new_x = round(static_cast<float>(x_pos)+(w*0.5f));
-        int new_y = round(static_cast<float>(y_pos)+(h*0.5f));
-        return Point(new_x, new_y);
-      }
-
-
     UIElement* SignedDistance(const unsigned int direction, Scene* scene, UIElement* focused){
       Scene::SceneSettings::FocusingSettings& settings = scene->settings.focus;
-      INSTRUMENTATE(focused->getParentUI())
-      if (scene->elements.empty()){
+      INSTRUMENTATE(scene->m_parent_ui)
+      if (scene->empty()){
         return nullptr;
       }
 
       if (settings.algorithm == FocusingAlgorithm::Linear)
       {
-        Ray ray{settings.max_distance, 1, direction};
-        switch (settings.accuracy){
-          case Quality::Low:
-            ray.step = 4;
-            break;
-          case Quality::Medium:
-            ray.step = 2;
-            break;
-          case Quality::High:
-            ray.step = 1;
-            break;
-        }
+        Ray ray{settings.max_distance, rayStep(settings.accuracy), direction};
 
         if (focused)
           return findElementInRay(focused, scene, ray);
@@ -549,24 +1846,6 @@ void AnimatedApp::render(){
       return Point(radius * cos(-angle * degToRadCoefficient), //x
                   radius * sin(-angle * degToRadCoefficient));//y
     }
-    std::set<Point> computeConePoints(Point vertex, Cone cone){
-      std::set<Point> buffer;
-
-      int half_aperture = cone.aperture/2;
-      int starting_angle = cone.bisector - half_aperture;
-      int end_angle = cone.bisector + half_aperture;
-
-      for(int i = starting_angle; i<end_angle; i+=cone.aperture_step){
-        for(int b = 0; b<cone.radius; b+=cone.rad_step){
-          Point tempPoint = polarToCartesian(b, i);
-          tempPoint.x += vertex.x;
-          tempPoint.y += vertex.y;
-          buffer.emplace(tempPoint);
-        }
-      }
-      return buffer;
-    }
-
     UIElement* findElementInCone(UIElement* focused, Scene* currentScene, const Cone& cone){
       focused->focusable = false;
 
@@ -582,11 +1861,12 @@ void AnimatedApp::render(){
         {
           tempPoint = polarToCartesian(b, i);
           tempPoint += centerPoint;
-          for(const auto&[id, element] : currentScene->elements){
-            if (element->focusable && isPointInElement(tempPoint, element)){
-              focused->focusable = true;
-              return element;
-            }
+          UIElement* found = currentScene->findElement([&tempPoint](UIElement* element){
+            return element->focusable && isPointInElement(tempPoint, element);
+          });
+          if (found){
+            focused->focusable = true;
+            return found;
           }
         }
       }
@@ -602,18 +1882,376 @@ void AnimatedApp::render(){
       for(int i = 0; i<ray.ray_length; i+=ray.step){
         tempPoint = polarToCartesian(i, ray.direction);
         tempPoint += centerPoint;
-        for(const auto&[id, element] : currentScene->elements){
-          if (element->focusable && isPointInElement(tempPoint, element)){
-            focused->focusable = true;
-            return element;
-          }
+        UIElement* found = currentScene->findElement([&tempPoint](UIElement* element){
+          return element->focusable && isPointInElement(tempPoint, element);
+        });
+        if (found){
+          focused->focusable = true;
+          return found;
         }
       }
       focused->focusable = true;
       return nullptr;
     }
 
-    const std::string constraintToString(const Constraint constraint){
+    //!@return The bytes used by the element, including the memory it owns
+    size_t getFootprint(const UIElement* element){
+      switch (element->getType()){
+        case ElementType::UIElement:    return sizeof(UIElement);
+        case ElementType::UIImage:      return sizeof(UIImage);
+        case ElementType::AnimatedApp:  return sizeof(AnimatedApp);
+        case ElementType::Checkbox:     return sizeof(Checkbox);
+        case ElementType::ListView:{
+          const ListView* list = static_cast<const ListView*>(element);
+          size_t bytes = sizeof(ListView) + list->getPoolSize() * sizeof(size_t);
+          for (size_t i = 0; i < list->getPoolSize(); i++)
+            bytes += getFootprint(list->getItem(i));
+          return bytes;
+        }
+        case ElementType::Group:
+          return sizeof(Group) + static_cast<const Group*>(element)->getChildren().size() * sizeof(UIElement*);
+        case ElementType::Label:        return sizeof(Label);
+      }
+      return sizeof(UIElement);
+    }
+
+    //!@return The bytes used by the scene and its elements, the bookkeeping of the standard containers is estimated
+    size_t getFootprint(const Scene* scene){
+      size_t bytes = sizeof(Scene) + scene->name.capacity();
+      #if !SIMPLEUI_STATIC_MEMORY
+      bytes += scene->elements.bucket_count() * sizeof(void*) + scene->elements.size() * (sizeof(std::pair<ElementID, UIElement*>) + sizeof(void*));
+      bytes += scene->parents.capacity() * sizeof(Scene*);
+      #endif
+      bytes += (scene->size() - scene->elements.size()) * sizeof(UIElement*);
+      scene->forEachElement([&bytes](UIElement* element){ bytes += getFootprint(element); });
+      return bytes;
+    }
+
+    //Prints the size of every element type and the footprint of every scene of a UI, useful to track memory regressions
+    void printFootprint(const UI* ui){
+      Serial.printf("UIElement: %u bytes\n", static_cast<unsigned int>(sizeof(UIElement)));
+      Serial.printf("UIImage: %u bytes\n", static_cast<unsigned int>(sizeof(UIImage)));
+      Serial.printf("AnimatedApp: %u bytes\n", static_cast<unsigned int>(sizeof(AnimatedApp)));
+      Serial.printf("Checkbox: %u bytes\n", static_cast<unsigned int>(sizeof(Checkbox)));
+      Serial.printf("ListView: %u bytes\n", static_cast<unsigned int>(sizeof(ListView)));
+      Serial.printf("Group: %u bytes\n", static_cast<unsigned int>(sizeof(Group)));
+      Serial.printf("Label: %u bytes\n", static_cast<unsigned int>(sizeof(Label)));
+      Serial.printf("Scene: %u bytes\n", static_cast<unsigned int>(sizeof(Scene)));
+      Serial.printf("UI: %u bytes\n", static_cast<unsigned int>(sizeof(UI)));
+      const AnimationStore& animations = AnimationStore::global();
+      Serial.printf("Animations: %u / %u slots, %u overflowed (%u bytes)\n", animations.getUsed(), AnimationStore::CAPACITY,
+                    animations.getOverflows(), static_cast<unsigned int>(sizeof(AnimationStore)));
+      for (size_t i = 0; i < ui->scenes.size(); i++){
+        const Scene* scene = ui->scenes[i];
+        Serial.printf("Scene %u (%u elements): %u bytes\n", static_cast<unsigned int>(i), static_cast<unsigned int>(scene->size()),
+                      static_cast<unsigned int>(getFootprint(scene)));
+      }
+    }
+
+    /*!
+      @brief Compare the time it takes to render a scene of mixed elements with and without batchRendering, the results are printed on the serial
+      @param canvas The canvas to draw on, it's left dirty
+      @param count  How many elements the scene has, the static memory profile caps it at SIMPLEUI_MAX_ELEMENTS
+      @param frames How many frames are averaged for each mode
+      @note The elements animate in a store of their own, run it while the UI is paused and on a stack that fits a UI and a Scene
+      @return False if the animations of the elements don't fit in SIMPLEUI_MAX_ANIMATIONS, nothing is timed then
+    */
+    bool benchmarkRender(GFXcanvas16* canvas, size_t count, unsigned int frames){
+      static const uint8_t dot[] = {0x60, 0xF0, 0xF0, 0x60};
+      static AnimationStore store;
+      AnimationStore::Scope scope(store);
+      const uint16_t overflows = store.getOverflows();
+      Texture small(4, 4, dot);
+      Texture large(4, 4, dot);
+      List<UIElement*, SIMPLEUI_MAX_ELEMENTS> created;
+      Scene scene;
+      #if SIMPLEUI_STATIC_MEMORY
+      count = std::min(count, static_cast<size_t>(SIMPLEUI_MAX_ELEMENTS));
+      #endif
+      //Every UIImage and AnimatedApp owns an animation and the UI two, an AnimatedApp briefly holds a second one while it's built
+      const size_t animations = count - (count + 2) / 3 + 3;
+      if (animations > static_cast<size_t>(AnimationStore::CAPACITY - store.getUsed())){
+        Serial.printf("%u elements: %u animations don't fit in SIMPLEUI_MAX_ANIMATIONS (%u), raise it to run this benchmark\n", static_cast<unsigned int>(count),
+                      static_cast<unsigned int>(animations), static_cast<unsigned int>(AnimationStore::CAPACITY));
+        return false;
+      }
+      for (size_t i = 0; i < count; i++){
+        const Point pos(static_cast<int16_t>((i * 4) % canvas->width()), static_cast<int16_t>(((i * 4) / canvas->width()) * 4 % canvas->height()));
+        UIElement* element;
+        switch (i % 3){
+          case 0:  element = new Checkbox(pos, false, 4, 4, Outline(1, 0, 1, 0xFFFF), 0xFFFF); break;
+          case 1:  element = new UIImage(&small, pos); break;
+          default: element = new AnimatedApp(pos, false, &small, &large); break;
+        }
+        created.push_back(element);
+        scene.addElement(element);
+      }
+
+      UI ui(&scene, canvas);
+      //Animations past the capacity would all share one slot and stop moving, which would make the scene cheaper than it looks
+      if (store.getOverflows() != overflows){
+        Serial.printf("%u elements: more animations than SIMPLEUI_MAX_ANIMATIONS (%u), raise it to run this benchmark\n",
+                      static_cast<unsigned int>(created.size()), static_cast<unsigned int>(AnimationStore::CAPACITY));
+        for (UIElement* element : created)
+          delete element;
+        return false;
+      }
+      //A small scene renders in less than a microsecond, the average is kept fractional so that it doesn't read as 0
+      float time[2];
+      for (int batched = 0; batched < 2; batched++){
+        scene.settings.batchRendering = batched;
+        ui.Render();
+        const uint32_t start = micros();
+        for (unsigned int i = 0; i < frames; i++)
+          ui.Render();
+        time[batched] = static_cast<float>(micros() - start) / (frames ? frames : 1);
+      }
+      Serial.printf("%u elements: virtual %.2fus, batched %.2fus per frame\n", static_cast<unsigned int>(created.size()), time[0], time[1]);
+
+      for (UIElement* element : created)
+        delete element;
+      return true;
+    }
+
+    /*!
+      @brief Compare drawing a screen of 20 numeric labels that change every frame with Label and with GFX print, the results are printed on the serial
+      @param canvas The canvas to draw on, it's left dirty
+      @param frames How many frames are averaged for each method
+    */
+    void benchmarkText(GFXcanvas16* canvas, unsigned int frames){
+      static const GlyphAtlas atlas;
+      static AnimationStore store;
+      AnimationStore::Scope scope(store);
+      constexpr size_t COUNT = 20;
+      Scene scene;
+      UI ui(&scene, canvas);
+      Label* labels[COUNT];
+      for (size_t i = 0; i < COUNT; i++){
+        labels[i] = new Label(Point((i % 4) * 32, (i / 4) * 12), false, &atlas);
+        labels[i]->setUiListener(&ui);
+      }
+
+      canvas->setTextSize(1);
+      canvas->setTextColor(0xFFFF);
+      canvas->setTextWrap(false);
+      uint32_t start = micros();
+      for (unsigned int f = 0; f < frames; f++){
+        for (size_t i = 0; i < COUNT; i++){
+          canvas->setCursor((i % 4) * 32, (i / 4) * 12);
+          canvas->print(static_cast<long>(f * 37 + i));
+        }
+      }
+      const uint32_t print_time = (micros() - start) / (frames ? frames : 1);
+
+      start = micros();
+      for (unsigned int f = 0; f < frames; f++){
+        for (size_t i = 0; i < COUNT; i++){
+          labels[i]->setNumber(f * 37 + i);
+          labels[i]->render();
+        }
+      }
+      const uint32_t label_time = (micros() - start) / (frames ? frames : 1);
+      Serial.printf("%u labels: print %uus, Label %uus per frame (atlas: %u spans)\n", static_cast<unsigned int>(COUNT),
+                    static_cast<unsigned int>(print_time), static_cast<unsigned int>(label_time), static_cast<unsigned int>(atlas.getSpanCount()));
+
+      for (Label* label : labels)
+        delete label;
+    }
+
+    /*!
+      @brief Time every scaling filter on a raw texture at a few factors, the results are printed on the serial. The arena is sized for
+      the largest output, a filter whose scalings still had to fall back to the heap is reported as invalid since it timed allocations
+      @param texture A Mono or RGB565 texture
+    */
+    void benchmarkScale(Texture& texture, unsigned int runs){
+      static constexpr float factors[] = {0.5f, 0.8f, 1.3f, 2.0f};
+      static const char* const names[] = {"nearest", "bilinear", "box"};
+      size_t largest = 0;
+      for (const float factor : factors){
+        //The pixels, a Mono alpha plane as large and the column table, with room to align each of them
+        const size_t pixels = static_cast<size_t>(Texture::getArrSize16(texture.width, texture.height, factor));
+        largest = std::max(largest, pixels * 3 + static_cast<size_t>(texture.width * factor) * 8 + 3 * alignof(max_align_t));
+      }
+      FrameArena arena(largest);
+      for (uint8_t filter = 0; filter < 3; filter++){
+        const size_t overflows = arena.getOverflows();
+        Serial.printf("%s:", names[filter]);
+        for (const float factor : factors){
+          const uint32_t start = micros();
+          for (unsigned int i = 0; i < runs; i++){
+            arena.reset();
+            scale(texture, factor, &arena, static_cast<ScaleFilter>(filter));
+          }
+          Serial.printf(" x%.1f %.2fus", factor, static_cast<float>(micros() - start) / (runs ? runs : 1));
+        }
+        if (arena.getOverflows() != overflows)
+          Serial.printf(" (invalid, %u scalings didn't fit in the arena)", static_cast<unsigned int>(arena.getOverflows() - overflows));
+        Serial.printf("\n");
+      }
+    }
+
+    /*!
+      @brief Time drawing a Mono texture as it is and compressed to RLEMono, at its size and stretched over the canvas. The results are
+      printed on the serial, RLEMono only pays off for bitmaps with few long runs
+      @param canvas  The canvas to draw on, it's left dirty
+      @param texture A Mono texture at most 255 pixels wide
+    */
+    void benchmarkTexture(GFXcanvas16* canvas, const Texture& texture, unsigned int runs){
+      const size_t size = encodeRLEMono(texture, nullptr, 0);
+      if (!size){
+        Serial.printf("Only Mono textures up to 255 pixels wide can be compressed to RLEMono\n");
+        return;
+      }
+      uint8_t* encoded = new uint8_t[size];
+      encodeRLEMono(texture, encoded, size);
+      const Texture compressed(texture.width, texture.height, PixelType::RLEMono, encoded);
+      const Texture* const textures[] = {&texture, &compressed};
+      const float stretched = std::max(static_cast<float>(canvas->width()) / texture.width, static_cast<float>(canvas->height()) / texture.height);
+      float time[2][2];
+      for (int format = 0; format < 2; format++){
+        for (int factor = 0; factor < 2; factor++){
+          const uint32_t start = micros();
+          for (unsigned int i = 0; i < runs; i++)
+            drawTexture(canvas, *textures[format], 0, 0, factor ? stretched : 1.0f);
+          time[format][factor] = static_cast<float>(micros() - start) / (runs ? runs : 1);
+        }
+      }
+      Serial.printf("Mono %u bytes: %.2fus, x%.1f %.2fus\n", static_cast<unsigned int>((texture.width + 7) / 8 * texture.height), time[0][0], stretched, time[0][1]);
+      Serial.printf("RLEMono %u bytes: %.2fus, x%.1f %.2fus\n", static_cast<unsigned int>(size), time[1][0], stretched, time[1][1]);
+      delete[] encoded;
+    }
+
+    /*!
+      @brief Time an anti-aliased 48x48 disc drawn raw, with a 1 bit mask and with 4 bit alpha, opaque and faded to half. Transparent spans
+      are skipped and opaque ones copied, so only the edge pays for blending: the alpha formats should stay within a small factor of the
+      raw copy. The results are printed on the serial
+      @param canvas The canvas to draw on, it's left dirty
+    */
+    void benchmarkAlpha(GFXcanvas16* canvas, unsigned int runs){
+      constexpr unsigned int SIZE = 48;
+      uint16_t* colors = new uint16_t[SIZE * SIZE];
+      uint8_t* alpha = new uint8_t[SIZE * SIZE];
+      for (unsigned int y = 0; y < SIZE; y++){
+        for (unsigned int x = 0; x < SIZE; x++){
+          const float distance = sqrtf((x - SIZE / 2.0f + 0.5f) * (x - SIZE / 2.0f + 0.5f) + (y - SIZE / 2.0f + 0.5f) * (y - SIZE / 2.0f + 0.5f));
+          colors[y * SIZE + x] = rgb565(x * 5, y * 5, 128);
+          alpha[y * SIZE + x] = static_cast<uint8_t>(255.0f * Animation::clamp(SIZE / 2.0f - distance, 0.0f, 1.0f));
+        }
+      }
+      const size_t a1_size = encodeAlpha(alpha, SIZE, SIZE, PixelType::RGB565A1, nullptr, 0);
+      const size_t a4_size = encodeAlpha(alpha, SIZE, SIZE, PixelType::RGB565A4, nullptr, 0);
+      uint8_t* a1 = new uint8_t[a1_size];
+      uint8_t* a4 = new uint8_t[a4_size];
+      encodeAlpha(alpha, SIZE, SIZE, PixelType::RGB565A1, a1, a1_size);
+      encodeAlpha(alpha, SIZE, SIZE, PixelType::RGB565A4, a4, a4_size);
+      const Texture raw(SIZE, SIZE, colors), masked(SIZE, SIZE, PixelType::RGB565A1, colors, a1), blended(SIZE, SIZE, PixelType::RGB565A4, colors, a4);
+      const Texture* const textures[] = {&raw, &masked, &blended};
+      static const char* const names[] = {"RGB565", "RGB565A1", "RGB565A4"};
+      for (int format = 0; format < 3; format++){
+        float time[2];
+        for (int faded = 0; faded < 2; faded++){
+          const uint32_t start = micros();
+          for (unsigned int i = 0; i < runs; i++)
+            drawTexture(canvas, *textures[format], 0, 0, 1.0f, 0xFFFF, faded ? 16 : 32);
+          time[faded] = static_cast<float>(micros() - start) / (runs ? runs : 1);
+        }
+        Serial.printf("%s: opaque %.2fus, half opacity %.2fus\n", names[format], time[0], time[1]);
+      }
+      delete[] a4;
+      delete[] a1;
+      delete[] alpha;
+      delete[] colors;
+    }
+
+    /*!
+      @brief Time a texture stretched over the whole canvas and a fade of the canvas, first serially and then on a worker pool.
+      The results are printed on the serial. The pool is one of its own started from the calling task, so run it on the core of the UI
+      while the UI is paused: the global pool is left untouched. Only the ESP32's numbers tell whether the pool is worth starting, on the
+      host the workers' synchronization costs more than the rows they take.
+      @param canvas The canvas to draw on, it's left dirty
+    */
+    void benchmarkParallel(GFXcanvas16* canvas, Texture& texture, unsigned int runs){
+      WorkerPool pool;
+      WorkerPool::Scope scope(pool);
+      const float factor = std::max(static_cast<float>(canvas->width()) / texture.width, static_cast<float>(canvas->height()) / texture.height);
+      const size_t pixels = static_cast<size_t>(canvas->width()) * canvas->height();
+      uint16_t* frame = canvas->getBuffer();
+      for (int parallel = 0; parallel < 2; parallel++){
+        if (parallel)
+          pool.start();
+        uint32_t start = micros();
+        for (unsigned int i = 0; i < runs; i++)
+          drawTexture(canvas, texture, 0, 0, factor);
+        const uint32_t draw_time = (micros() - start) / (runs ? runs : 1);
+        start = micros();
+        for (unsigned int i = 0; i < runs; i++){
+          parallelRows(canvas->height(), canvas->width(), [&](unsigned int begin, unsigned int end){
+            for (size_t p = begin * canvas->width(); p < end * canvas->width() && p < pixels; p++)
+              frame[p] = blend565(frame[p], 0x0000, 16);
+          });
+        }
+        const uint32_t fade_time = (micros() - start) / (runs ? runs : 1);
+        Serial.printf("%u workers: full screen texture %uus, fade %uus\n", static_cast<unsigned int>(pool.getWorkers()),
+                      static_cast<unsigned int>(draw_time), static_cast<unsigned int>(fade_time));
+      }
+    }
+
+    /*!
+      @brief Time the fixed point motion math against the float math it replaced: the glide of the focus outline from a ring to another,
+      and elements that follow an animation of their position while they're centered on a scaled size. The results are printed on the
+      serial, on the ESP32 the fixed point side is expected to be the faster one
+    */
+    void benchmarkFixed(unsigned int runs){
+      constexpr size_t COUNT = 32;
+      static AnimationStore store;
+      AnimationStore::Scope scope(store);
+      Animation motion[COUNT];
+      for (size_t i = 0; i < COUNT; i++){
+        motion[i] = Animation(0.0f, 40.0f + i * 3, 1000U, 2.0f);
+        motion[i].Start();
+      }
+      store.update(store.now() + 377000);   //Part of the way, the values have a fraction
+      const OutlineRing from(Outline(2, 1, 4, 0xF800), Rect(10, 10, 16, 16));
+      const OutlineRing to(Outline(2, 1, 4, 0x07FF), Rect(60, 20, 32, 24));
+      const auto floatLerp = [](const OutlineRing& from, const OutlineRing& to, float t){
+        auto mix = [t](int a, int b){ return static_cast<int>(lroundf(Animation::lerp(a, b, t))); };
+        OutlineRing ring;
+        ring.bounds = Rect(mix(from.bounds.x, to.bounds.x), mix(from.bounds.y, to.bounds.y), mix(from.bounds.w, to.bounds.w), mix(from.bounds.h, to.bounds.h));
+        ring.radius = mix(from.radius, to.radius);
+        ring.thickness = mix(from.thickness, to.thickness);
+        ring.hole_radius = mix(from.hole_radius, to.hole_radius);
+        ring.color = (mix(from.color >> 11, to.color >> 11) << 11) | (mix((from.color >> 5) & 0x3F, (to.color >> 5) & 0x3F) << 5) | mix(from.color & 0x1F, to.color & 0x1F);
+        return ring;
+      };
+
+      volatile int32_t sink = 0;    //Keeps the compiler from dropping the loops
+      float glide[2], follow[2];
+      for (int fixed = 0; fixed < 2; fixed++){
+        int32_t sum = 0;
+        uint32_t start = micros();
+        for (unsigned int r = 0; r < runs; r++){
+          for (size_t i = 0; i < COUNT; i++){
+            const float t = motion[i].getProgress() / (40.0f + i * 3);
+            const OutlineRing ring = fixed ? OutlineRing::lerp(from, to, t) : floatLerp(from, to, t);
+            sum += ring.bounds.x + ring.bounds.w + ring.color;
+          }
+        }
+        glide[fixed] = static_cast<float>(micros() - start) / (runs ? runs : 1);
+        start = micros();
+        for (unsigned int r = 0; r < runs; r++){
+          for (size_t i = 0; i < COUNT; i++){
+            const int diff = static_cast<int>(i % 7) - 3;     //Unscaled minus scaled width
+            sum += fixed ? (Fixed::of(motion[i]) + Fixed(diff).half()).round() : static_cast<int>(lroundf(motion[i].getProgress() + diff * 0.5f));
+          }
+        }
+        follow[fixed] = static_cast<float>(micros() - start) / (runs ? runs : 1);
+        sink = sink + sum;
+      }
+      Serial.printf("%u outline glides: float %.2fus, fixed %.2fus\n", static_cast<unsigned int>(COUNT), glide[0], glide[1]);
+      Serial.printf("%u animated positions: float %.2fus, fixed %.2fus\n", static_cast<unsigned int>(COUNT), follow[0], follow[1]);
+    }
+
+    const char* constraintToString(const Constraint constraint){
       switch (constraint){
         case Constraint::TopLeft:     return "TopLeft";
         case Constraint::Top:         return "Top";
@@ -1,15 +1,33 @@
 #pragma once
+#include "SimpleUIConfig.h"
 #include "Texture.h"
-#include "UUIDbuddy.h"
 #include "Animation.h"
+#include "Clock.h"
+#include "FrameStream.h"
+#include "Telemetry.h"
+#include "Arena.h"
+#include "Workers.h"
+#include "StaticContainers.h"
 #include <vector>
 #include <unordered_map>
 #include <Adafruit_GFX.h>
 #include <set>
 #include <queue>
 #include <functional>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#ifndef ESP32
+  #include <thread>
+#endif
 
-#define PERFORMANCE_PROFILING 0
+//Both can also be turned on from the build flags, e.g. -DLATENCY_PROFILING=1
+#ifndef PERFORMANCE_PROFILING
+  #define PERFORMANCE_PROFILING 0
+#endif
+#ifndef LATENCY_PROFILING
+  #define LATENCY_PROFILING 0
+#endif
 #define LOG(x) Serial.println(x)
 
 #define FPS30 33333
@@ -19,6 +37,10 @@
 #define FPS144 6944
 #define FPS_UNCAPPED 0
 
+#ifndef FRAME_ARENA_SIZE
+  #define FRAME_ARENA_SIZE 4096   //Bytes reserved for the per-frame scratch buffers, grow it with UI::getArena().reserve() if it overflows
+#endif
+
 #if PERFORMANCE_PROFILING
     #define INSTRUMENTATE(ui) Instrumentator timer(ui, __PRETTY_FUNCTION__);
 #else
@@ -32,87 +54,220 @@ namespace SimpleUI
   class UIElement;
   class AnimatedApp;
   class UIImage;
+  class Checkbox;
+  class ListView;
+  class Group;
+  class Label;
+  class GlyphAtlas;
   struct Point;
+  struct Fixed;
+  struct FixedPoint;
+  struct Rect;
   struct Cone;
   struct Ray;
   struct Scene;
   struct Focus;
   struct FocusingSettings;
   struct Outline;
+  struct OutlineRing;
+  struct LayoutEntry;
+  struct LayoutSlot;
+  template<size_t N> struct SceneLayout;
+  struct LatencyHistogram;
+  class LatencyTracker;
   enum class Quality;
   enum class Direction;
   enum class FocusingAlgorithm;
-  enum class FocusStyle;
-  enum class Constraint;
+  enum class FocusStyle : uint8_t;
+  enum class Constraint : uint8_t;
+  enum class Transition;
+  enum class LatencyStage;
 }
 
 
 namespace SimpleUI{
+
+  //The containers used across the library, their capacity is only meaningful in the static memory profile
+  #if SIMPLEUI_STATIC_MEMORY
+    template<typename T, size_t N> using List = StaticContainers::StaticVector<T, N>;
+    template<typename K, typename V, size_t N> using Map = StaticContainers::StaticMap<K, V, N>;
+    template<typename Signature> using Callback = StaticContainers::InplaceFunction<Signature, SIMPLEUI_CALLBACK_SIZE>;
+  #else
+    template<typename T, size_t N> using List = std::vector<T>;
+    template<typename K, typename V, size_t N> using Map = std::unordered_map<K, V>;
+    template<typename Signature> using Callback = std::function<Signature>;
+  #endif
+
+  //Unique identifier of an element, 0 means no element
+  using ElementID = uint16_t;
   
-  enum class ElementType{
+  enum class ElementType : uint8_t{
     UIElement,
     AnimatedApp,
     UIImage,
-    Checkbox
+    Checkbox,
+    ListView,
+    Group,
+    Label
   };
   enum class Quality{Low, Medium, High};
   enum class Direction{Up=90, Down=270, Left=180, Right=0};
   enum class FocusingAlgorithm{Linear, Cone};
-  enum class FocusStyle{None, Animation, Outline, Color};
-  enum class Constraint{
+  enum class FocusStyle : uint8_t{None, Animation, Outline, Color};
+  enum class Constraint : uint8_t{
     TopLeft,    Top,      TopRight,
 
     Left,       Center,   Right,
 
     BottomLeft, Bottom,   BottomRight
   };
+  enum class Transition{None, SlideLeft, SlideRight, SlideUp, SlideDown, Fade};
+  enum class LatencyStage{
+    Focus,  //From the input to the resolution of the new focus
+    Frame,  //From the focus resolution to the end of the first frame rendered with it
+    Blit,   //From the end of that frame to the completed transfer to the display
+    Total   //From the input to the completed transfer to the display
+  };
 
   struct Point{
-    int x;   //X coordinate of the point 
-    int y;   //Y coordinate of the point
+    int16_t x;   //X coordinate of the point 
+    int16_t y;   //Y coordinate of the point
     
     /*!
       @brief Represent a 2D point with integer coordinates.
       @param    x   X coordinate of the point
       @param    y   Y coordinate of the point
     */
-    Point(int posx=0, int posy=0) : x(posx), y(posy){};
+    constexpr Point(int posx=0, int posy=0) : x(posx), y(posy){};
 
-    bool operator<(const Point &other) const{
-      return std::tie(x, y) < std::tie(other.x, other.y);
+    constexpr bool operator<(const Point &other) const{
+      return x < other.x || (x == other.x && y < other.y);
+    }
+    constexpr bool operator==(const Point &other) const{
+      return x == other.x && y == other.y;
     }
-    Point& operator+=(int value) {
+    constexpr Point operator+(const Point& other) const {
+      return Point(x + other.x, y + other.y);
+    }
+    constexpr Point operator-(const Point& other) const {
+      return Point(x - other.x, y - other.y);
+    }
+    constexpr Point& operator+=(int value) {
       x += value;
       y += value;
       return *this;
     }
-    Point& operator+=(const Point& other) {
+    constexpr Point& operator+=(const Point& other) {
       x += other.x;
       y += other.y;
       return *this;
     }
-    Point& operator++(int) {
+    constexpr Point& operator++(int) {
       x++;
       y++;
       return *this;
     }
-    Point& operator--(int) {
+    constexpr Point& operator--(int) {
       x--;
       y--;
       return *this;
     }
-    Point& operator-=(int value) {
+    constexpr Point& operator-=(int value) {
       x -= value;
       y -= value;
       return *this;
     }
-    Point& operator-=(const Point& other) {
+    constexpr Point& operator-=(const Point& other) {
       x -= other.x;
       y -= other.y;
       return *this;
     }
   };
 
+  /*Fixed point number with 4 fractional bits, a sixteenth of a pixel, in 32 bits so that any Point coordinate and the sums of a few of
+  them fit. Element positions and the offsets applied to them stay in this format so that motion and centering don't lose the fraction on
+  every step, they are only snapped to whole pixels when something is drawn.*/
+  struct Fixed{
+    static constexpr int FRACTION_BITS = AnimationStore::FIXED_BITS;
+    static constexpr int ONE = 1 << FRACTION_BITS;
+    int32_t raw;
+
+    constexpr Fixed() : raw(0){}
+    constexpr Fixed(int value) : raw(value * ONE){}
+    static constexpr Fixed fromRaw(int32_t raw){ Fixed f; f.raw = raw; return f; }
+    static constexpr Fixed fromFloat(float value){ return fromRaw(static_cast<int32_t>(value * ONE + (value < 0.0f ? -0.5f : 0.5f))); }
+    //!@return The current value of an animation, converted when the store published it
+    static inline Fixed of(const Animation& animation){ return fromRaw(animation.getFixed()); }
+
+    //!@return The nearest whole pixel, halves are rounded up
+    constexpr int round() const { return (raw + ONE / 2) >> FRACTION_BITS; }
+    constexpr int floor() const { return raw >> FRACTION_BITS; }
+    constexpr float toFloat() const { return static_cast<float>(raw) / ONE; }
+    //!@return Half of the number, exact as long as the number has a free fractional bit
+    constexpr Fixed half() const { return fromRaw(raw / 2); }
+
+    constexpr Fixed operator+(const Fixed& other) const { return fromRaw(raw + other.raw); }
+    constexpr Fixed operator-(const Fixed& other) const { return fromRaw(raw - other.raw); }
+    constexpr Fixed operator-() const { return fromRaw(-raw); }
+    constexpr Fixed operator*(const Fixed& other) const { return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) * other.raw + ONE / 2) >> FRACTION_BITS)); }
+    constexpr Fixed operator*(int value) const { return fromRaw(raw * value); }
+    constexpr Fixed& operator+=(const Fixed& other) { raw += other.raw; return *this; }
+    constexpr Fixed& operator-=(const Fixed& other) { raw -= other.raw; return *this; }
+    constexpr bool operator==(const Fixed& other) const { return raw == other.raw; }
+    constexpr bool operator!=(const Fixed& other) const { return raw != other.raw; }
+    constexpr bool operator<(const Fixed& other) const { return raw < other.raw; }
+  };
+
+  //A point with fixed point coordinates, see Fixed
+  struct FixedPoint{
+    Fixed x;
+    Fixed y;
+
+    constexpr FixedPoint(Fixed posx = Fixed(), Fixed posy = Fixed()) : x(posx), y(posy){}
+    constexpr FixedPoint(Point point) : x(point.x), y(point.y){}
+    //!@return The nearest pixel
+    constexpr Point round() const { return Point(x.round(), y.round()); }
+
+    constexpr FixedPoint operator+(const FixedPoint& other) const { return FixedPoint(x + other.x, y + other.y); }
+    constexpr FixedPoint operator-(const FixedPoint& other) const { return FixedPoint(x - other.x, y - other.y); }
+    constexpr bool operator==(const FixedPoint& other) const { return x == other.x && y == other.y; }
+  };
+
+  // Axis aligned rectangle, used for bounding boxes and clipping regions
+  struct Rect{
+    int x, y;   //Top left corner
+    int w, h;   //Size in pixels, a rectangle with no area is empty
+
+    constexpr Rect(int posx=0, int posy=0, int width=0, int height=0) : x(posx), y(posy), w(width), h(height){};
+    constexpr Rect(Point pos, int width, int height) : x(pos.x), y(pos.y), w(width), h(height){};
+
+    constexpr bool isEmpty() const { return w <= 0 || h <= 0; }
+    constexpr bool intersects(const Rect& other) const {
+      return !isEmpty() && !other.isEmpty() && x < other.x + other.w && other.x < x + w && y < other.y + other.h && other.y < y + h;
+    }
+    //Grows the rectangle to contain the other one
+    Rect& merge(const Rect& other){
+      if (other.isEmpty())
+        return *this;
+      if (isEmpty())
+        return *this = other;
+      const int right = std::max(x + w, other.x + other.w);
+      const int bottom = std::max(y + h, other.y + other.h);
+      x = std::min(x, other.x);
+      y = std::min(y, other.y);
+      w = right - x;
+      h = bottom - y;
+      return *this;
+    }
+    Rect& inflate(int amount){
+      x -= amount;
+      y -= amount;
+      w += amount * 2;
+      h += amount * 2;
+      return *this;
+    }
+  };
+
   // Holds the parameters necessary for computing a 2D cone with whatever level of detail desired
   struct Cone{
     unsigned int bisector;        //The angle that indicates the bisector of its aperture (Degrees)
@@ -131,23 +286,23 @@ namespace SimpleUI{
   };
 
   struct Focus{
-    std::string focusedElementID;
-    std::string previousElementID;
+    ElementID focusedElementID;
+    ElementID previousElementID;
     Scene* previousScene;
     Scene* activeScene;
-    Focus(std::string ele = ""):focusedElementID(ele), activeScene(nullptr), previousScene(nullptr), previousElementID(""){};
-    inline void focus(std::string ele);
+    Focus(ElementID ele = 0):focusedElementID(ele), activeScene(nullptr), previousScene(nullptr), previousElementID(0){};
+    inline void focus(ElementID ele);
     inline void update();
     inline bool hasChanged() const;
-    inline bool isFocusing(std::string obj);
+    inline bool isFocusing(ElementID obj);
     inline bool isFocusing(UIElement *obj);
     void focusScene(Scene* scene);
   };
 
   struct Outline{
-    unsigned int thickness; 
-    unsigned int border_distance;
-    unsigned int radius;
+    uint8_t thickness; 
+    uint8_t border_distance;
+    uint8_t radius;
     uint16_t color;
     /*!
       @brief Represent any type of outline, used in different ways by each function.
@@ -156,99 +311,199 @@ namespace SimpleUI{
       @param radius     Radius in pixels of the corners
       @param color      RGB565 color of the outline
     */
-    Outline(unsigned int thickness=1, unsigned int distance=0, unsigned int radius = 0, uint16_t color=0xffff) : thickness(thickness), border_distance(distance), color(color), radius(radius){}
+    constexpr Outline(uint8_t thickness=1, uint8_t distance=0, uint8_t radius = 0, uint16_t color=0xffff) : thickness(thickness), border_distance(distance), color(color), radius(radius){}
+  };
+
+  //The pixels an outline actually covers around a rectangle: the outer rounded rectangle and the rounded hole left by the thickness
+  struct OutlineRing{
+    Rect bounds;    //The outer rectangle
+    uint16_t radius = 0;    //Grows with the thickness, so it can be past what an Outline holds
+    uint8_t thickness = 0;
+    uint8_t hole_radius = 0;
+    uint16_t color = 0;
+
+    OutlineRing() = default;
+    /*!
+      @param outline  The outline to place
+      @param around   The outlined rectangle, the innermost ring sits one pixel past the border distance and the others grow outwards
+    */
+    OutlineRing(const Outline& outline, const Rect& around);
+    //!@return A ring in between the two, every dimension is interpolated and rounded to the nearest pixel
+    static OutlineRing lerp(const OutlineRing& from, const OutlineRing& to, float t);
   };
 
   //Generic UI element, all interactable elements inherit from this
   class UIElement{
     public:
       
+      Outline focus_outline;
       Constraint scale_constraint;
-      Animation anim;
+      ScaleFilter scale_filter;   //How the element's textures are sampled when they're scaled
       FocusStyle focus_style;
-      Outline focus_outline;
 
-      bool custom_focus_outline = false;
-      bool focusable = true;
-      bool draw = true;          //If true, the element is drawn, if false it's kept hidden.
+      bool custom_focus_outline : 1;
+      bool focusable : 1;
+      bool draw : 1;          //If true, the element is drawn, if false it's kept hidden.
 
     public:
 
       UIElement(unsigned int w=0, unsigned int h=0, Point pos={0,0}, bool isCentered = false, ElementType element = ElementType::UIElement, Constraint constraint = Constraint::TopLeft, FocusStyle style = FocusStyle::None)
-      : m_type(element), m_width(w), m_height(h), focus_style(style), m_UUID(UUIDbuddy::generateUUID()), m_s_width(w), m_s_height(h), scale_constraint(constraint)
+      : scale_constraint(constraint), scale_filter(ScaleFilter::Nearest), focus_style(style), custom_focus_outline(false), focusable(true), draw(true), m_overrideAnimationScaling(false),
+        m_type(element), m_id(s_takeId()), m_width(w), m_height(h), m_s_width(w), m_s_height(h)
         {
           m_position = isCentered ? centerToCornerPos(pos.x, pos.y, w, h) : pos;
         };
 
       virtual ~UIElement(){};
 
-      inline void setPosX(unsigned int X) { m_position.x = X; }
-      inline void setPosY(unsigned int Y) { m_position.y = Y; }
-      inline void setPos(Point pos){m_position=pos;}
+      inline void setPosX(unsigned int X) { m_position.x = X; m_invalidateBounds(); }
+      inline void setPosY(unsigned int Y) { m_position.y = Y; m_invalidateBounds(); }
+      inline void setPos(Point pos){m_position=pos; m_invalidateBounds();}
+      //!@brief Place the element in between pixels, it's drawn at the nearest one but the fraction is kept for the next moves
+      inline void setSubPos(FixedPoint pos){ if (!(pos == m_position)){ m_position = pos; m_invalidateBounds(); } }
+      inline void setConstraint(Constraint constraint){ scale_constraint = constraint; m_invalidateBounds(); }
       /*!
         @brief Set the UI listener, this allows the element to access its parent UI's attributes and API
         @param listener A pointer to the UI object that "owns" the element
       */
       inline void setUiListener(UI *listener) { m_parent_ui = listener; }
 
-      //!@return The element's UUID
-      inline std::string getId() const { return m_UUID; }
+      //!@return The element's unique ID
+      inline ElementID getId() const { return m_id; }
       inline ElementType getType() const { return m_type; }
-      inline Point getPos() const { return m_position; }
+      inline Point getPos() const { return m_position.round(); }
+      inline FixedPoint getSubPos() const { return m_position; }
       inline unsigned int getWidth() const { return m_width; }
       inline unsigned int getHeight() const { return m_height; }
       inline UI* getParentUI() const { return m_parent_ui; }
+      //!@return A number that changes whenever the element is moved or resized, scenes compare it to know when their focus graph may be stale
+      inline uint32_t getGeometryVersion() const { return m_geometry_version; }
+      //!@return The group that contains the element, nullptr if it's at the root of its scene
+      inline Group* getGroup() const { return m_group; }
+      virtual Rect getBounds() const;
       Point getDrawPoint() const;
       Point getCenterPoint() const;
       Point getConstraintedPos() const;
+      //!@return Where a texture of the given size would be drawn given the element's constraint
+      Point getConstraintedPos(unsigned int scaled_w, unsigned int scaled_h) const;
       
       
       virtual void render();
       // Interact with the element
       virtual void click(){return;}
+      /*!
+        @brief Move the focus inside the element, used by containers that handle their own navigation
+        @param direction The direction in counter clockwise degrees (Right is 0)
+        @return False if the move leaves the element, in which case the focus searches the scene
+      */
+      virtual bool navigate(unsigned int direction){return false;}
+      /*Build whatever the element caches before its first frame. This may run on another core while a different scene is on screen, so it
+      only writes the element's own state, caches shared through the UI are handed over with their own locks like OutlineCache::warm()*/
+      virtual void prepare(){return;}
       
-      inline bool isAnimating() const {return anim.getState() == AnimState::Running;}
+      //!@return The element's animation, nullptr for the elements that never animate
+      virtual Animation* getAnimation() { return nullptr; }
+      inline bool isAnimating() {
+        const Animation* anim = getAnimation();
+        return anim && anim->getState() == AnimState::Running;
+      }
+      //!@return True if the last update of the element's animation changed its value enough to be drawn
+      inline bool hasAnimationChanged() {
+        const Animation* anim = getAnimation();
+        return anim && anim->isDirty();
+      }
+      //!@return The region the element covers before and after its animation's last update
+      virtual Rect getAnimationDamage() const { return getBounds(); }
       inline bool isFocused() const;
       
-      static Point centerToCornerPos(unsigned int x_pos, unsigned int y_pos, unsigned int w, unsigned int h);
+      /*!
+        @param x_pos  X coordinate of the center
+        @param y_pos  Y coordinate of the center
+        @param w      Width in pixels
+        @param h      Height in pixels
+        @return The top left corner of the described boundary, truncated towards zero
+      */
+      static constexpr Point centerToCornerPos(int x_pos, int y_pos, unsigned int w, unsigned int h){
+        return Point((2 * x_pos - static_cast<int>(w)) / 2, (2 * y_pos - static_cast<int>(h)) / 2);
+      }
       void drawFocusOutline(const Outline& outline = Outline()) const;
+      //!@return Where the focus outline of the element is drawn, the scene's outline is used unless the element has a custom one
+      OutlineRing getFocusRing(const Outline& outline = Outline()) const;
+
+      protected:
+      void m_strokeOutline(const Outline& outline, Point pos, unsigned int w, unsigned int h) const;
+      void m_setScaledSize(unsigned int w, unsigned int h);
+      void m_invalidateBounds();
+      void m_drawTexture(Texture& texture, float scale_fac, uint16_t mono_color, uint8_t opacity = 32);
 
       protected:
-      Point m_position;
-      bool m_overrideAnimationScaling = false;
-      unsigned int m_width, m_height;
-      unsigned int m_s_width, m_s_height; //With scaling applied
-      std::string m_UUID;
+      bool m_overrideAnimationScaling : 1;
       ElementType m_type;
-      UI* m_parent_ui;
+      ElementID m_id;
+      FixedPoint m_position;    //Top left corner, snapped to a pixel only when drawing
+      uint16_t m_width, m_height;
+      uint16_t m_s_width, m_s_height; //With scaling applied
+      UI* m_parent_ui = nullptr;
+      Group* m_group = nullptr;
+      uint32_t m_geometry_version = 0;
+      friend class Group;
+
+      private:
+      //!@return The next ID, 0 is skipped when the counter wraps around since it means "no element". Elements may be created by the preloader
+      static inline ElementID s_takeId(){
+        ElementID id;
+        do
+          id = s_next_id.fetch_add(1, std::memory_order_relaxed);
+        while (!id);
+        return id;
+      }
+      static inline std::atomic<ElementID> s_next_id{1};
   };
 
   //Used to represent any Image with the tools provided by the library
-  class UIImage : public UIElement{
+  class UIImage final : public UIElement{
   public:
     UIImage(Texture* img = nullptr, Point pos = {0,0}, bool isCentered=false, FocusStyle focus_style = FocusStyle::None)
     : UIElement(img->width, img->height, pos, isCentered, ElementType::UIImage, Constraint::TopLeft, focus_style), m_body(img), m_mono_color(0xffff), m_scale_fac(1.0f){}
 
     inline void setScale(float scale){m_scale_fac = scale;
                                       m_overrideAnimationScaling = (scale < 0) ? false : true;}
-    inline void setColor(uint16_t hue) { m_mono_color = hue; }
-    inline void setImg(Texture *img){m_body = img; m_width = img->width; m_height = img->height;}
+    inline void setColor(uint16_t hue) { m_mono_color = hue; m_prepared.reset(); }
+    //!@param opacity From 0 (invisible) to 32 (opaque), anything in between is blended with what's under the image
+    inline void setOpacity(uint8_t opacity) { m_opacity = opacity > 32 ? 32 : opacity; }
+    inline void setImg(Texture *img){m_body = img; m_width = img->width; m_height = img->height; m_prepared.reset(); m_invalidateBounds();}
 
     /// @param scale If negative, the scale is controlled by the animation.
     inline float getScale() const { return m_scale_fac; }
     inline Texture *getImg() const { return m_body; }
+    Animation* getAnimation() override { return &anim; }
     
 
     void render() override;
+    void prepare() override;
+
+  public:
+    Animation anim;
+    /*Keep the texture decoded at the size it's drawn at, trading the RAM of a raw copy for the decoding of every frame. Filtered scaling is
+    always kept, since it would otherwise be redone in the frame arena every frame. Neither is kept in the static memory profile.*/
+    bool keep_decoded = false;
 
   protected:
+    //!@return The scale the image is drawn at, the one set with setScale() unless it's negative
+    inline float m_currentScale() const { return m_overrideAnimationScaling ? m_scale_fac : anim.getProgress(); }
+    bool m_needsPrepared(float scale) const;
+    void m_prepare(float scale);
     Texture *m_body;
     float m_scale_fac;
     uint16_t m_mono_color;
+    uint8_t m_opacity = 32;
+    //What m_body looks like at m_prepared_scale, see keep_decoded
+    std::unique_ptr<Texture> m_prepared;
+    float m_prepared_scale = 0.0f;
   };
 
   // This is a heavily interactable element which animates from a Texture to another when focused/unfocused, and clicking it can trigger an event
-  class AnimatedApp : public UIElement{
+  class AnimatedApp final : public UIElement{
     public:
 
       AnimatedApp(Point pos = {0,0}, bool isCentered = false, Texture* unfocused = nullptr, Texture* focused = nullptr, Constraint constraint = Constraint::TopLeft, 
@@ -259,22 +514,31 @@ namespace SimpleUI{
         m_ratio(unfocused&&focused ? static_cast<float>(focused->width) / static_cast<float>(unfocused->width) : 0.0f)
       {
         anim = Animation(1.0f, m_ratio, duration, step);
+        //Scale changes that don't resize the texture by a pixel aren't published
+        if (unfocused)
+          anim.setThreshold(1.0f / static_cast<float>(std::max(unfocused->width, unfocused->height)));
         anim.Start();
         anim.Pause();
       }
       
       void render() override;
+      Animation* getAnimation() override { return &anim; }
+      Rect getAnimationDamage() const override;
       inline Texture* getActive() const {return m_showing;}
       inline void setColor(uint16_t hue){m_mono_color = hue;}
       void click() override{
         m_onClick();
       }
-      void bind(const std::function<void()>& func){m_onClick = func;}
+      void bind(const Callback<void()>& func){m_onClick = func;}
       
       
+    public:
+      Animation anim;
+
     protected:
       void m_computeAnimation();
-      std::function<void()> m_onClick = [](){return;};
+      void m_replaceAnimation(float start, float end);
+      Callback<void()> m_onClick = [](){return;};
     protected:
       unsigned int m_duration;
       uint16_t m_mono_color;  //Color used to draw the textures
@@ -285,7 +549,7 @@ namespace SimpleUI{
     };
 
   // Extremely customizable yet bare-bones, reliable and easy to work with.
-  class Checkbox : public UIElement{
+  class Checkbox final : public UIElement{
 
     public:
     Outline outline;           //The checkbox's outline.
@@ -305,9 +569,10 @@ namespace SimpleUI{
     Checkbox(Point pos = {0, 0}, bool isCentered=false, unsigned int width=0, unsigned int height=0, Outline style = Outline(),  uint16_t fillColor=0xFFFF, FocusStyle focus_style=FocusStyle::Outline)
       :UIElement(width, height, pos, isCentered, ElementType::Checkbox, Constraint::TopLeft, focus_style), outline(style), selection_color(fillColor){
         focus_outline.border_distance=0U;
-        outline.radius = std::clamp(outline.radius, 0U, static_cast<unsigned int>((width >= height ? height : width)*0.5f));
+        outline.radius = std::min(static_cast<unsigned int>(outline.radius), static_cast<unsigned int>((width >= height ? height : width)*0.5f));
       };
     void render();
+    void prepare() override;
     void click() override{m_state = !m_state;}
     /// @return The current state of the checkbox
     inline bool getState() const {return m_state;}
@@ -318,20 +583,287 @@ namespace SimpleUI{
     bool m_state = false;
   };
 
+  /*A scrollable list or grid that can hold any amount of items, but only ever instantiates the ones that fit in its viewport.
+  The items are created once by a factory, recycled while scrolling and filled by a data source callback with the index they represent.*/
+  class ListView : public UIElement{
+    public:
+    Outline selection_outline;  //Drawn around the selected item while the list is focused
+
+    public:
+    /*!
+      @brief Create a list, or a grid if it has more than one column.
+      @param pos          Top left corner coordinates
+      @param isCentered   Is the element centered around the provided coordinates?
+      @param width        Width of the viewport in pixels
+      @param height       Height of the viewport in pixels
+      @param item_height  Height of a row in pixels, the viewport shows as many whole rows as they fit
+      @param columns      How many items are in a row
+    */
+    ListView(Point pos = {0, 0}, bool isCentered = false, unsigned int width = 0, unsigned int height = 0, unsigned int item_height = 16, unsigned int columns = 1)
+      : UIElement(width, height, pos, isCentered, ElementType::ListView, Constraint::TopLeft, FocusStyle::None),
+        m_item_height(item_height ? item_height : 1), m_columns(columns ? columns : 1){}
+    ~ListView();
+
+    /*!
+      @brief Set how the recycled items are created, the list takes ownership of them.
+      @param factory Called once for every item that can be visible at the same time
+      @return False if the static memory profile couldn't keep every item, raise SIMPLEUI_MAX_LIST_ITEMS
+    */
+    bool setFactory(const Callback<UIElement*()>& factory);
+    /*!
+      @brief Set where the items' content comes from.
+      @param count  How many items the list holds
+      @param source Called with a recycled item and the index it has to represent, only when that changes
+    */
+    void setSource(size_t count, const Callback<void(UIElement* item, size_t index)>& source);
+    void setCount(size_t count);
+    //Forces every visible item to be filled again by the data source
+    inline void invalidate() { std::fill(m_bound.begin(), m_bound.end(), NONE); }
+    void select(size_t index);
+    void bind(const Callback<void(size_t index)>& func){m_onClick = func;}
+
+    inline size_t getSelected() const { return m_selected; }
+    inline size_t getPoolSize() const { return m_pool.size(); }
+    inline const UIElement* getItem(size_t slot) const { return m_pool[slot]; }
+    inline size_t getCount() const { return m_count; }
+    inline unsigned int getVisibleRows() const { return std::max(1U, m_height / m_item_height); }
+
+    void render() override;
+    void prepare() override;
+    void click() override;
+    bool navigate(unsigned int direction) override;
+
+    protected:
+    void m_scrollTo(size_t index);
+    static constexpr size_t NONE = static_cast<size_t>(-1);
+
+    unsigned int m_item_height;
+    unsigned int m_columns;
+    size_t m_count = 0;
+    size_t m_selected = 0;
+    size_t m_first_row = 0;             //The first row shown in the viewport
+    List<UIElement*, SIMPLEUI_MAX_LIST_ITEMS> m_pool;  //The recycled items, the item for index i lives in slot i % m_pool.size()
+    List<size_t, SIMPLEUI_MAX_LIST_ITEMS> m_bound;      //The index each slot currently represents
+    Callback<void(UIElement*, size_t)> m_source = [](UIElement*, size_t){return;};
+    Callback<void(size_t)> m_onClick = [](size_t){return;};
+  };
+
+  /*Groups elements together in a tree, the bounding box of every subtree is cached so that whole subtrees that are hidden, off canvas
+  or outside of the damaged region are skipped without visiting their elements. Children are positioned in absolute coordinates,
+  and a group has to be filled before being added to a scene.*/
+  class Group : public UIElement{
+    public:
+    Group(std::initializer_list<UIElement*> children = {});
+
+    //!@return False if the group already holds SIMPLEUI_MAX_CHILDREN children in the static memory profile, the child isn't added
+    bool add(UIElement* child);
+    inline const List<UIElement*, SIMPLEUI_MAX_CHILDREN>& getChildren() const { return m_children; }
+    //!@return The union of the children's bounds, only recomputed after a change in the subtree
+    Rect getBounds() const override;
+
+    void render() override;
+
+    protected:
+    List<UIElement*, SIMPLEUI_MAX_CHILDREN> m_children;
+    mutable Rect m_bounds;
+    mutable bool m_bounds_dirty = true;
+    friend class UIElement;
+  };
+
+  /*Every glyph of a font rasterized once into horizontal runs of pixels. Drawing a glyph is then a few row fills instead of reading
+  the font bit by bit, and laying out a string only needs the advances. Built when declared, it's shared by any number of labels.*/
+  class GlyphAtlas{
+    public:
+    //A horizontal run of lit pixels, relative to the top left corner of the line
+    struct Span{
+      int8_t x;
+      int8_t y;
+      uint8_t length;
+    };
+    struct Glyph{
+      uint16_t span_offset;
+      uint8_t span_count;
+      uint8_t x_advance;
+    };
+
+    /*!
+      @param font   An Adafruit GFX font, nullptr for the built in 5x7 one
+      @param first  The first character to rasterize
+      @param last   The last character to rasterize, the ones outside of the range are drawn as blanks
+    */
+    GlyphAtlas(const GFXfont* font = nullptr, uint8_t first = ' ', uint8_t last = '~');
+
+    //!@return The rasterized glyph of a character, nullptr if it isn't in the atlas
+    inline const Glyph* getGlyph(char c) const {
+      const uint8_t index = static_cast<uint8_t>(c) - m_first;
+      return static_cast<uint8_t>(c) >= m_first && index < m_glyphs.size() ? &m_glyphs[index] : nullptr;
+    }
+    inline const Span* getSpans(const Glyph& glyph) const { return &m_spans[glyph.span_offset]; }
+    inline uint8_t getLineHeight() const { return m_line_height; }
+    inline size_t getSpanCount() const { return m_spans.size(); }
+
+    private:
+    List<Glyph, SIMPLEUI_MAX_GLYPHS> m_glyphs;
+    List<Span, SIMPLEUI_MAX_GLYPH_SPANS> m_spans;
+    uint8_t m_first;
+    uint8_t m_line_height;
+  };
+
+  /*A line of text. The string is laid out against a GlyphAtlas only when it changes, rendering fills the cached runs of the atlas
+  straight into the canvas.*/
+  class Label final : public UIElement{
+    public:
+    /*!
+      @param pos        Top left corner coordinates
+      @param isCentered Is the text centered around the provided coordinates? It stays centered when the text changes
+      @param atlas      The rasterized font, it must outlive the label
+      @param color      RGB565 color of the text
+      @param size       Integer scaling of the glyphs
+    */
+    Label(Point pos = {0, 0}, bool isCentered = false, const GlyphAtlas* atlas = nullptr, uint16_t color = 0xFFFF, uint8_t size = 1);
+
+    /*!
+      @brief Change the text, nothing is laid out again if it's the same. Longer strings are cut to SIMPLEUI_MAX_LABEL_LENGTH characters.
+      The layout is done by prepare() or the next render(), getWidth() and getPos() only follow then while getBounds() already does
+    */
+    void setText(const char* text);
+    void setNumber(long number);
+    inline const char* getText() const { return m_text; }
+    inline void setColor(uint16_t color){ m_color = color; }
+    void setSize(uint8_t size);
+
+    void render() override;
+    void prepare() override;
+    Rect getBounds() const override;
+
+    protected:
+    void m_layout();
+    //!@return How wide the text is once laid out
+    int16_t m_measure() const;
+    const GlyphAtlas* m_atlas;
+    Point m_anchor;       //The position the label was placed at, the top left corner moves around it when the text is centered
+    uint16_t m_color;
+    uint8_t m_size;
+    bool m_centered;
+    uint8_t m_length = 0;
+    bool m_stale = false;   //The text or size changed since the last layout
+    char m_text[SIMPLEUI_MAX_LABEL_LENGTH + 1] = "";
+    int16_t m_glyph_x[SIMPLEUI_MAX_LABEL_LENGTH];   //Where every character starts, computed by m_layout()
+  };
+
   namespace UiUtils{
       constexpr float degToRadCoefficient = 0.01745329251;
-      const Point centerPos(int x_pos, int y_pos, const unsigned int w, const unsigned int h);
+
+      //!@return How many pixels a linear focus search jumps over at every step
+      constexpr uint8_t rayStep(const Quality accuracy){
+        return accuracy == Quality::Low ? 4 : accuracy == Quality::Medium ? 2 : 1;
+      }
+      /*!
+          @param x_pos  X coordinate of the top-left corner
+          @param y_pos  Y coordinate of the top-left corner
+          @param w      Width in pixels
+          @param h      Height in pixels
+          @return The center point of the described boundary, halves are rounded away from zero
+        */
+      constexpr Point centerPos(int x_pos, int y_pos, const unsigned int w, const unsigned int h){
+        const int x2 = 2 * x_pos + static_cast<int>(w);
+        const int y2 = 2 * y_pos + static_cast<int>(h);
+        return Point(x2 >= 0 ? (x2 + 1) / 2 : -((1 - x2) / 2), y2 >= 0 ? (y2 + 1) / 2 : -((1 - y2) / 2));
+      }
       
       Point polarToCartesian(const float radius, const float angle);
       bool isPointInElement(Point point, UIElement* element);
       UIElement* SignedDistance(const unsigned int direction, Scene* scene, UIElement* focused);
       UIElement* findElementInCone(UIElement* focused, Scene* currentScene, const Cone& cone);
       UIElement* findElementInRay(UIElement* focused, Scene* currentScene, const Ray& ray);
-      const std::string constraintToString(const Constraint constraint);
+      const char* constraintToString(const Constraint constraint);
 
-      std::set<Point> computeConePoints(Point vertex, Cone cone);
+      size_t getFootprint(const UIElement* element);
+      size_t getFootprint(const Scene* scene);
+      void printFootprint(const UI* ui);
+      bool benchmarkRender(GFXcanvas16* canvas, size_t count, unsigned int frames = 100U);
+      void benchmarkText(GFXcanvas16* canvas, unsigned int frames = 100U);
+      void benchmarkScale(Texture& texture, unsigned int runs = 100U);
+      void benchmarkTexture(GFXcanvas16* canvas, const Texture& texture, unsigned int runs = 100U);
+      void benchmarkAlpha(GFXcanvas16* canvas, unsigned int runs = 100U);
+      void benchmarkParallel(GFXcanvas16* canvas, Texture& texture, unsigned int runs = 50U);
+      void benchmarkFixed(unsigned int runs = 1000U);
     }
-  
+
+  //Compile time description of where an element is placed, see makeLayout()
+  struct LayoutEntry{
+    Point pos;
+    uint16_t width;
+    uint16_t height;
+    bool centered;    //Is the element centered around pos?
+  };
+
+  //Where an element sits and which element the focus reaches from it in every direction
+  struct LayoutSlot{
+    Point corner;
+    uint16_t width;
+    uint16_t height;
+    int8_t neighbours[4];   //Index of the element reached going Right, Up, Left and Down, -1 if there's none
+  };
+
+  /*!
+    @brief Find the neighbours of every slot with the same rays used by FocusingAlgorithm::Linear
+    @param step The ray step of the focus accuracy, see UiUtils::rayStep()
+  */
+  constexpr void linkLayout(LayoutSlot* slots, size_t count, unsigned int max_distance, uint8_t step){
+    constexpr int dx[4] = {1, 0, -1, 0};
+    constexpr int dy[4] = {0, -1, 0, 1};
+    for (size_t i = 0; i < count; i++){
+      const Point center = UiUtils::centerPos(slots[i].corner.x, slots[i].corner.y, slots[i].width, slots[i].height);
+      for (size_t d = 0; d < 4; d++){
+        slots[i].neighbours[d] = -1;
+        for (unsigned int r = 0; r < max_distance && slots[i].neighbours[d] < 0; r += step){
+          const int x = center.x + dx[d] * static_cast<int>(r);
+          const int y = center.y + dy[d] * static_cast<int>(r);
+          for (size_t j = 0; j < count; j++){
+            const Point corner = slots[j].corner;
+            if (j != i && x >= corner.x && x <= corner.x + slots[j].width && y >= corner.y && y <= corner.y + slots[j].height){
+              slots[i].neighbours[d] = static_cast<int8_t>(j);
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  //The layout of a whole scene, computed at compile time so that it can live in flash
+  template<size_t N>
+  struct SceneLayout{
+    LayoutSlot slots[N];
+    uint16_t max_distance;  //The focusing settings the neighbours have been computed with
+    uint8_t step;
+  };
+
+  /*!
+    @brief Compute the position of every element and the focus neighbour graph of a scene at compile time. The neighbours are found
+    with the same rays used by FocusingAlgorithm::Linear, the draw order is the declaration order.
+    @param entries      The elements' placements
+    @param max_distance How far the focus can reach, as in Scene::settings.focus.max_distance
+    @param accuracy     The accuracy of the focus search, as in Scene::settings.focus.accuracy
+  */
+  template<size_t N>
+  constexpr SceneLayout<N> makeLayout(const LayoutEntry (&entries)[N], unsigned int max_distance = 64U, Quality accuracy = Quality::Medium){
+    static_assert(N < 128, "A static scene can't have more than 127 elements");
+    SceneLayout<N> layout{};
+    layout.max_distance = max_distance;
+    layout.step = UiUtils::rayStep(accuracy);
+
+    for (size_t i = 0; i < N; i++){
+      const LayoutEntry& entry = entries[i];
+      layout.slots[i].corner = entry.centered ? UIElement::centerToCornerPos(entry.pos.x, entry.pos.y, entry.width, entry.height) : entry.pos;
+      layout.slots[i].width = entry.width;
+      layout.slots[i].height = entry.height;
+    }
+    linkLayout(layout.slots, N, max_distance, layout.step);
+    return layout;
+  }
+
 
   //This is one of the most fundamental blocks of the library, it groups together elements and allows for extreme versatility
   class Scene{
@@ -339,9 +871,9 @@ namespace SimpleUI{
     friend UIElement* UiUtils::SignedDistance(const unsigned int direction, Scene* scene, UIElement* focused);
     public:
     std::string name;
-    std::string primaryElementID;
-    std::unordered_map<std::string, UIElement*> elements;
-    std::vector<Scene*> parents;
+    ElementID primaryElementID;
+    Map<ElementID, UIElement*, SIMPLEUI_MAX_ELEMENTS> elements;
+    List<Scene*, SIMPLEUI_MAX_PARENTS> parents;
 
     struct SceneSettings
     {
@@ -351,62 +883,443 @@ namespace SimpleUI{
         Quality accuracy;
         FocusingAlgorithm algorithm;
         Outline outline;
+        //How long in milliseconds the outline takes to glide from the previous element to the focused one, 0 moves it at once
+        unsigned int glide_duration = 0U;
+        float glide_easing = 2.0f;   //Smoothing of the glide, see Animation
       }
       focus{64U, Quality::Medium, FocusingAlgorithm::Linear};
 
         //Add more stuff here
       bool scriptOnTop = false;
+      /*Render the elements grouped by type, each group of a final class in a loop of direct calls instead of virtual ones. Overlapping
+      elements keep their draw order, the classes that can be derived from are still rendered through the virtual call.*/
+      bool batchRendering = false;
     } 
     settings;
 
     public:
     Scene(std::initializer_list<UIElement*> elementGroup = {}, UIElement* first_focus = nullptr);
-    Scene(const std::function<void()>& script, bool on_top = false) : m_script(script), primaryElementID(""){ settings.scriptOnTop=on_top; }
+    /*!
+      @brief Create a scene from a layout computed at compile time, nothing is inserted in the element map and the focus uses the
+      precomputed neighbours instead of searching.
+      @param layout       The result of makeLayout(), it must outlive the scene
+      @param table        The elements in the same order as the layout's entries, it must outlive the scene
+      @param first_focus  The element focused when entering the scene
+    */
+    template<size_t N>
+    Scene(const SceneLayout<N>& layout, UIElement* const (&table)[N], UIElement* first_focus = nullptr)
+      : primaryElementID(first_focus ? first_focus->getId() : 0), m_table{table, layout.slots, static_cast<uint8_t>(N), layout.max_distance, layout.step}
+    {
+      for (size_t i = 0; i < N; i++)
+        table[i]->setPos(layout.slots[i].corner);
+      m_checkLayout();
+    }
+    Scene(const Callback<void()>& script, bool on_top = false) : m_script(script), primaryElementID(0){ settings.scriptOnTop=on_top; }
     void renderScene() const;
-    UIElement* getElementByUUID(std::string UUID) const;
+    void prepare();
+    //!@return True if the scene has been focused after being prepared and its first frame won't have to build anything
+    inline bool isReady() const { return m_state == SceneState::Ready; }
+    //!@return True if prepare() has been called, it may still be running on another thread
+    inline bool isPreparing() const { return m_state != SceneState::Cold; }
+    //!@return False if the element, or one of a group's children, didn't fit in SIMPLEUI_MAX_ELEMENTS in the static memory profile
+    bool addElement(UIElement* element);
+    UIElement* getElementByID(ElementID id) const;
+    bool findNeighbour(UIElement* from, unsigned int direction, UIElement*& neighbour) const;
+    //!@return How many elements the scene holds, both from its table and its element map
+    inline size_t size() const { return m_table.count + elements.size(); }
+    inline bool empty() const { return size() == 0; }
+    //!@return The first element for which the predicate returns true, the table is visited in order before the element map
+    template<typename F>
+    UIElement* findElement(F&& predicate) const {
+      for (uint8_t i = 0; i < m_table.count; i++){
+        if (predicate(m_table.elements[i]))
+          return m_table.elements[i];
+      }
+      for (const auto&[id, element] : elements){
+        if (predicate(element))
+          return element;
+      }
+      return nullptr;
+    }
+    template<typename F>
+    void forEachElement(F&& func) const {
+      findElement([&func](UIElement* element){ func(element); return false; });
+    }
+    /*!@brief Rebuild the render batches on the next frame. Moving or resizing an element already does, this is only needed when an
+    animation makes elements grow over each other while batchRendering is on*/
+    inline void invalidateBatches(){ m_batches_dirty = true; }
     void addParents(std::initializer_list<Scene*> scenes);
-    inline void Script(const std::function<void()>& script, bool on_top = false)  { m_script = script; settings.scriptOnTop = on_top;}
+    inline void Script(const Callback<void()>& script, bool on_top = false)  { m_script = script; settings.scriptOnTop = on_top;}
     inline void UnbindScript(){ m_script = [](){return;};}
     
     private:
-    UI* m_parent_ui;
-    std::function<void()> m_script = [](){return;};
+    //The elements of a scene created from a compile time layout
+    struct ElementTable{
+      UIElement* const* elements;
+      const LayoutSlot* slots;
+      uint8_t count;
+      uint16_t max_distance;
+      uint8_t step;
+    };
+    //The slots are swapped for m_graph once an element of the table moves or is resized
+    mutable ElementTable m_table{nullptr, nullptr, 0, 0, 0};
+    mutable List<LayoutSlot, SIMPLEUI_MAX_ELEMENTS> m_graph;
+    mutable uint32_t m_geometry_version = 0;   //m_geometryVersion() the graph was last checked at
+    //!@return The sum of the geometry versions of the scene's elements, it changes whenever one of them moves or is resized
+    uint32_t m_geometryVersion() const;
+    void m_refreshGraph() const;
+    void m_checkLayout();
+    //A run of elements of the same type inside m_batched
+    struct RenderBatch{
+      ElementType type;
+      uint16_t begin;
+      uint16_t end;
+    };
+    mutable List<UIElement*, SIMPLEUI_MAX_ELEMENTS> m_batched;
+    mutable List<RenderBatch, SIMPLEUI_MAX_ELEMENTS> m_batches;
+    mutable bool m_batches_dirty = true;
+    mutable uint32_t m_batches_version = 0;    //m_geometryVersion() the batches were built at
+    void m_buildBatches() const;
+    template<typename T>
+    void m_renderBatch(const RenderBatch& batch, const Rect& clip) const;
+    void m_renderElement(UIElement* element) const;
+    void m_activate();
+    /*Cold until prepare() is called, Prepared once the elements' caches are built and Ready once m_activate() has built the state the
+    frames read on the thread that renders*/
+    enum class SceneState : uint8_t {Cold, Preparing, Prepared, Ready};
+    UI* m_parent_ui = nullptr;
+    std::atomic<SceneState> m_state{SceneState::Cold};
+    Callback<void()> m_script = [](){return;};
+  };
+
+  /*Thick rounded rectangle outlines rasterized into rows of horizontal spans. An outline is a ring between an outer rounded rectangle and
+  the hole left by its thickness, both are computed once per geometry and later frames only fill the cached spans. The shape is symmetric,
+  so only the left insets of the top half are kept.*/
+  class OutlineCache{
+    public:
+    /*!
+      @brief Fill a rounded ring
+      @param canvas       Where the ring is drawn
+      @param pos          Top left corner of the outer rectangle
+      @param w            Width of the outer rectangle
+      @param h            Height of the outer rectangle
+      @param radius       Corner radius of the outer rectangle
+      @param thickness    How many pixels the ring is thick, measured inward
+      @param hole_radius  Corner radius of the hole
+      @param color        RGB565 color of the ring
+    */
+    void stroke(GFXcanvas16* canvas, Point pos, uint16_t w, uint16_t h, uint16_t radius, uint8_t thickness, uint8_t hole_radius, uint16_t color);
+    inline void stroke(GFXcanvas16* canvas, const OutlineRing& ring){
+      stroke(canvas, Point(ring.bounds.x, ring.bounds.y), ring.bounds.w, ring.bounds.h, ring.radius, ring.thickness, ring.hole_radius, ring.color);
+    }
+    /*!
+      @brief Rasterize a ring ahead of its first stroke, from any thread. The result is handed over under a lock and taken in by the next
+      stroke() on the thread that renders, so preparing a scene on the other core never touches the entries a frame is reading.
+      @param w            Width of the outer rectangle
+      @param h            Height of the outer rectangle
+      @param radius       Corner radius of the outer rectangle
+      @param thickness    How many pixels the ring is thick, measured inward
+      @param hole_radius  Corner radius of the hole
+    */
+    void warm(uint16_t w, uint16_t h, uint16_t radius, uint8_t thickness, uint8_t hole_radius);
+    inline void warm(const OutlineRing& ring){
+      warm(ring.bounds.w, ring.bounds.h, ring.radius, ring.thickness, ring.hole_radius);
+    }
+    //!@return How many times a geometry had to be rasterized
+    inline uint32_t getMisses() const { return m_misses; }
+
+    private:
+    static constexpr uint16_t NO_HOLE = 0xFFFF;
+    static constexpr uint16_t ROWS = (SIMPLEUI_MAX_OUTLINE_HEIGHT + 1) / 2;
+    struct Entry{
+      uint16_t w = 0, h = 0;
+      uint16_t radius = 0;
+      uint8_t thickness = 0, hole_radius = 0;
+      uint32_t last_used = 0;
+      uint16_t rows[ROWS][2];  //Left inset of the ring and of the hole for the top rows, NO_HOLE where the row is filled
+    };
+    static void m_rowInsets(const Entry& entry, int y, uint16_t* insets);
+    static void m_rasterize(Entry& entry);
+    static void m_fill(GFXcanvas16* canvas, Point pos, const Entry& entry, uint16_t color);
+    //!@return The entry with the given geometry, nullptr if it isn't cached. oldest is set to the entry to replace
+    Entry* m_find(uint16_t w, uint16_t h, uint16_t radius, uint8_t thickness, uint8_t hole_radius, Entry*& oldest);
+    void m_takeWarmed();
+    Entry m_entries[SIMPLEUI_OUTLINE_CACHE_SIZE];
+    uint32_t m_clock = 0;
+    uint32_t m_misses = 0;
+    //Rings rasterized by warm(), only touched while m_warm_lock is held
+    Entry m_warmed[SIMPLEUI_OUTLINE_WARMUPS];
+    uint8_t m_warmed_count = 0;
+    std::atomic_flag m_warm_lock = ATOMIC_FLAG_INIT;
+    std::atomic<bool> m_has_warmed{false};
+  };
+
+  #if LATENCY_PROFILING
+  // Log2-bucketed distribution of durations in microseconds, bucket i holds the values in [2^i, 2^(i+1))
+  struct LatencyHistogram{
+    static constexpr uint8_t BUCKETS = 18;
+    uint32_t buckets[BUCKETS] = {};
+    uint32_t count = 0;
+    uint32_t max = 0;
+    uint64_t sum = 0;
+
+    void add(uint32_t time);
+    void clear();
+    inline uint32_t mean() const { return count ? static_cast<uint32_t>(sum / count) : 0; }
+    uint32_t percentile(float p) const;
+  };
+
+  /*Follows a single input event from the moment it's registered, through the focus resolution and the first frame rendered with its result,
+  up to the completed blit of that frame. Every stamp takes the time explicitly so that it can be fed from any time source.*/
+  class LatencyTracker{
+    public:
+    void stampInput(uint32_t time);
+    void stampFocus(uint32_t time);
+    void stampFrame(uint32_t time);
+    void stampBlit(uint32_t time);
+    void clear();
+    void print() const;
+    /// @return True if an input is waiting for its result to reach the display
+    inline bool isPending() const { return m_stage != Pending::None; }
+    inline const LatencyHistogram& getHistogram(LatencyStage stage) const { return m_histograms[static_cast<uint8_t>(stage)]; }
+
+    private:
+    enum class Pending{None, Focus, Frame, Blit};
+    Pending m_stage = Pending::None;
+    uint32_t m_input = 0, m_focus = 0, m_frame = 0;
+    LatencyHistogram m_histograms[4];
   };
+  #endif
 
   /*This is the object that has the power over the final frame, this reads inputs, handles focusing, and is responsible for calling the rendering
   functions which modify the final buffer.*/
   class UI{
     public:
     Focus focus;
-    std::vector<Scene*> scenes;
+    List<Scene*, SIMPLEUI_MAX_SCENES> scenes;
     GFXcanvas16 *buffer;
     
     
     public:
     UI(Scene* first_scene = nullptr, GFXcanvas16* framebuffer = nullptr);
-    void AddScene(Scene* scene);
+    ~UI();
+    //!@return False if SIMPLEUI_MAX_SCENES scenes were already added in the static memory profile
+    bool AddScene(Scene* scene);
     void FocusScene(Scene* scene);
+    void PreloadScene(Scene* scene);
+    void TransitionTo(Scene* scene, Transition transition = Transition::SlideLeft, unsigned int duration = 250U);
+    /*!
+      @brief Set the canvas that holds the outgoing frame during a transition, without it transitions are instant.
+      @param snapshot A canvas with the same size as the framebuffer
+    */
+    inline void setTransitionBuffer(GFXcanvas16* snapshot) { m_snapshot = snapshot; }
+    inline bool isTransitioning() const { return m_transition != Transition::None; }
+    //!@return The arena that holds the scratch buffers of the current frame, it's reset at the beginning of every Render()
+    inline FrameArena& getArena() { return m_arena; }
+    inline OutlineCache& getOutlineCache() { return m_outlines; }
+    //!@brief Called by the elements that had to build a cache while rendering, which a prepared scene never does
+    inline void countCacheMiss() { m_cache_misses++; }
+    //!@return How many times a frame had to build a cache, outlines included
+    inline uint32_t getCacheMisses() const { return m_outlines.getMisses() + m_cache_misses; }
     inline const Scene* getActiveScene() const { return focus.activeScene; }
+    //!@brief Read the time from another clock, e.g. a VirtualClock in host tests. nullptr goes back to the hardware timer
+    inline void setClock(Clock* clock) { m_clock = clock ? clock : &SystemClock::global(); }
+    inline Clock& getClock() const { return *m_clock; }
+    //!@return The time the current frame was sampled at in microseconds, every animation of the frame advances to it
+    inline uint64_t getFrameTime() const { return m_frame_time; }
     void Render();
-    void FocusDirection(unsigned int direction);
-    void FocusDirection(Direction direction);
+    bool FocusDirection(unsigned int direction, uint32_t input_time);
+    bool FocusDirection(Direction direction, uint32_t input_time);
+    //!@brief Same as the other overload, the input is stamped with the current time
+    inline bool FocusDirection(unsigned int direction) { return FocusDirection(direction, m_clock->micros()); }
+    inline bool FocusDirection(Direction direction) { return FocusDirection(direction, m_clock->micros()); }
     void Back();
-    void Click();
-    inline bool isFocusingFree() const { return !m_focusing_busy; }
-    inline UIElement* getFocused() const { return focus.activeScene->getElementByUUID(focus.focusedElementID); }
+    void Click(uint32_t input_time);
+    //!@brief Same as the other overload, the input is stamped with the current time
+    inline void Click() { Click(m_clock->micros()); }
+    void Presented();
+    /// @return True if no focus request is waiting to be resolved by the next Render()
+    inline bool isFocusingFree() const { return m_focusQueue.empty(); }
+    /*!
+      @brief Restrict the rendering of the next frame to a region of the buffer, whatever is entirely outside of it is skipped.
+      The region goes back to the whole buffer after every Render().
+    */
+    inline void setDamage(const Rect& region) { m_damage = region; }
+    //!@return The region of the buffer that is being rendered, clipped to the buffer
+    Rect getClip() const;
+    //!@return True while the focus outline is gliding between two elements, the elements don't draw their own outline meanwhile
+    inline bool isFocusGliding() const { return m_gliding; }
+    Rect getFocusDamage();
+    Rect getAnimationDamage();
+    inline UIElement* getFocused() const { return focus.activeScene->getElementByID(focus.focusedElementID); }
     
     #if PERFORMANCE_PROFILING
     void printPerfStats();
+    //!@return The longest time measured at every profiled site, in microseconds
+    inline const std::unordered_map<std::string, uint32_t>& getPerfStats() const { return m_perfValues; }
     private:
     std::unordered_map<std::string, uint32_t> m_perfValues;
     void m_addPerf(std::string key, uint32_t time);
     friend class Instrumentator;
     #endif
 
+    #if LATENCY_PROFILING
+    public:
+    LatencyTracker latency;
+    inline void printLatencyStats() const { latency.print(); }
+    #endif
+
     private:
-    void m_focusDir(unsigned int direction);
+    // A run of consecutive focus requests in the same direction
+    struct FocusMove{
+      unsigned int direction;
+      unsigned int steps;
+    };
+    // A focus search that has already been done in the current cycle
+    struct FocusStep{
+      UIElement* from;
+      unsigned int direction;
+      UIElement* to;
+    };
+
+    bool m_focusDir(unsigned int direction);
+    void m_resolveFocus();
+    UIElement* m_focusStep(UIElement* from, unsigned int direction);
     void m_updateFocus();
-    bool m_focusing_busy = false; //You could see this as sort of a "mutex" to prevent multiple focuses from happening in the same cycle, which could break a UI
+    /*Every request made between two frames is queued here and resolved at once by the next Render(), so that no press gets lost and the focus
+    only changes once per cycle, which is what the elements' animations rely on*/
+    List<FocusMove, SIMPLEUI_MAX_FOCUS_MOVES> m_focusQueue;
+    List<FocusStep, SIMPLEUI_MAX_FOCUS_MOVES * 2> m_focusMemo;
+    Rect m_damage{0, 0, INT16_MAX, INT16_MAX};
+    void m_beginFrame();
+    Clock* m_clock = &SystemClock::global();
+    uint64_t m_frame_time = 0;
+    bool m_frame_begun = false;   //The time of the next frame has already been sampled by a damage query
+
+    void m_startGlide(UIElement* from, UIElement* to);
+    void m_drawGlide();
+    /*The focus outline moving between elements, drawn by the UI on top of the scene. The ring of the previous frame is kept to know which
+    region the glide has swept*/
+    bool m_gliding = false;
+    bool m_glide_pinned = false;  //getFocusDamage() has already chosen the ring of the next frame
+    OutlineRing m_glide_from, m_glide_to, m_glide_last, m_glide_next;
+    Animation m_glide_anim;
+
+    void m_compositeTransition();
+    Transition m_transition = Transition::None;
+    Animation m_transition_anim;
+    GFXcanvas16* m_snapshot = nullptr;
+    FrameArena m_arena{FRAME_ARENA_SIZE};
+    OutlineCache m_outlines;
+    uint32_t m_cache_misses = 0;
+    #if SIMPLEUI_ALLOC_GUARD
+    /*Frames after an input or a scene change that may still allocate, e.g. to grow the focus queue, start an animation or take in a
+    focus move that was resolved on the first of them. Every frame after them has to render without touching the heap.*/
+    static constexpr unsigned int SETTLING_FRAMES = 3;
+    unsigned int m_steady_frames = 0;  //Frames in a row without inputs or scene changes
+    #endif
+    #if !defined(ESP32) && !SIMPLEUI_STATIC_MEMORY
+    std::thread m_preloader;
+    #endif
+  };
+
+  //The inputs a replay can feed to a UI
+  enum class ReplayInput : uint8_t {Direction, Click, Back};
+
+  //An input of a recorded session
+  struct ReplayEvent{
+    uint32_t time;        //Microseconds from the start of the session
+    ReplayInput input;
+    uint16_t direction;   //Counter clockwise degrees, only used by ReplayInput::Direction
+  };
+
+  //What a replay recorded for a single frame
+  struct ReplayFrame{
+    uint32_t time;        //Virtual time of the frame in microseconds
+    uint32_t hash;        //Hash of the whole canvas after the frame was rendered
+    uint32_t render_time; //Real time spent in UI::Render() in microseconds
+  };
+
+  /*Plays a recorded session into a UI on a virtual clock, so that the same inputs always produce the same frames. Every frame is hashed
+  to be checked against golden hashes, and its real render time is measured to catch performance regressions. tools/replay_runner.cpp
+  plays scripted sessions into the demo's scenes on the host.*/
+  class Replay{
+    public:
+    /*!
+      @param ui             The UI to drive, it reads the replay's clock while it runs
+      @param events         The session, sorted by time, it must outlive the replay
+      @param count          How many events the session has
+      @param frame_interval Virtual microseconds between two frames
+    */
+    Replay(UI* ui, const ReplayEvent* events, size_t count, uint32_t frame_interval = FPS60)
+      : m_ui(ui), m_events(events), m_count(count), m_interval(frame_interval ? frame_interval : FPS60){}
+
+    /*!
+      @brief Render frames until the last event plus a settling time, the inputs are fed to the UI before the frame they fall in
+      @param frames   Where every frame is recorded, nullptr to only run the session
+      @param capacity How many frames fit in the output, the replay stops when it's full
+      @param settle   Virtual microseconds rendered after the last event, to let the animations finish
+      @return How many frames were rendered
+    */
+    size_t run(ReplayFrame* frames, size_t capacity, uint32_t settle = 500000U);
+    inline VirtualClock& getClock() { return m_clock; }
+    //!@param color The canvas is filled with it before every frame like the main loop does, -1 draws over the previous frame
+    inline void setBackground(int32_t color) { m_background = color; }
+
+    //!@return FNV-1a hash of every pixel of the canvas
+    static uint32_t hashFrame(const GFXcanvas16* canvas);
+    //!@return The first frame whose hash doesn't match the golden one, -1 if all of them do
+    static int compare(const ReplayFrame* frames, const uint32_t* golden, size_t count);
+    //!@brief Print the frames as CSV on the serial: frame, time, hash and render time
+    static void print(const ReplayFrame* frames, size_t count);
+
+    private:
+    UI* m_ui;
+    const ReplayEvent* m_events;
+    size_t m_count;
+    uint32_t m_interval;
+    int32_t m_background = 0x0000;
+    VirtualClock m_clock;
+  };
+
+  /*Streams the state of a UI as binary records instead of formatted text: a Frame record after every frame, a Focus record whenever
+  the focus moves, and every few frames the heap, the animations and the profiler sites (PERFORMANCE_PROFILING builds). The slow records
+  take turns so no frame pays for all of them. tools/telemetry_decoder.cpp turns the stream into CSV or JSON.*/
+  class Telemetry{
+    public:
+    /*!
+      @param ui       The UI to report on
+      @param sink     Where the records are written, it must outlive the telemetry
+      @param interval Frames between two records of each slow kind
+    */
+    Telemetry(UI* ui, ByteSink* sink, uint16_t interval = 30U) : m_ui(ui), m_writer(sink), m_interval(interval ? interval : 1){}
+
+    /*!
+      @brief Record the frame that was just rendered, meant to be called once after every UI::Render()
+      @param render_time Microseconds the frame took to render
+    */
+    void sample(uint32_t render_time);
+    inline void setInterval(uint16_t frames) { m_interval = frames ? frames : 1; }
+    //!@return How many bytes were sent so far
+    inline size_t getWritten() const { return m_writer.getWritten(); }
+
+    private:
+    void m_sendFocus();
+    void m_sendHeap();
+    void m_sendAnimations();
+    void m_sendProfile();
+
+    UI* m_ui;
+    TelemetryWriter m_writer;
+    uint16_t m_interval;
+    uint32_t m_frame = 0;
+    uint64_t m_last_time = 0;
+    ElementID m_last_element = 0;
+    const Scene* m_last_scene = nullptr;
+    #if PERFORMANCE_PROFILING
+    std::vector<std::string> m_sites;   //The index of a name is its id
+    uint32_t m_profile_rounds = 0;
+    #endif
   };
 
   #if PERFORMANCE_PROFILING
@@ -415,9 +1328,9 @@ namespace SimpleUI{
     const std::string funcName;
     const uint32_t start;
     public:
-    Instrumentator(UI* target, std::string func) : target(target), funcName(func), start(micros()){}
+    Instrumentator(UI* target, std::string func) : target(target), funcName(func), start(target->getClock().micros()){}
     ~Instrumentator(){
-      target->m_addPerf(funcName, micros()-start);
+      target->m_addPerf(funcName, target->getClock().micros()-start);
     }
   };
   #endif
@@ -0,0 +1,49 @@
+#pragma once
+
+/*Build profile of the library. With SIMPLEUI_STATIC_MEMORY every container, string and callback is replaced by a fixed capacity
+equivalent with inline storage, so no allocation happens after the UI has been declared and the memory usage is fully known at link time.
+The capacities below are only used by the static profile. Every value can be set from the build flags instead, e.g. -DSIMPLEUI_STATIC_MEMORY=1.*/
+#ifndef SIMPLEUI_STATIC_MEMORY
+  #define SIMPLEUI_STATIC_MEMORY 0
+#endif
+
+#ifndef SIMPLEUI_MAX_ELEMENTS
+  #define SIMPLEUI_MAX_ELEMENTS     32    //Elements in a single scene, including the children of its groups
+#endif
+#ifndef SIMPLEUI_MAX_SCENES
+  #define SIMPLEUI_MAX_SCENES       8     //Scenes added to a UI
+#endif
+#ifndef SIMPLEUI_MAX_PARENTS
+  #define SIMPLEUI_MAX_PARENTS      4     //Parents of a single scene
+#endif
+#ifndef SIMPLEUI_MAX_CHILDREN
+  #define SIMPLEUI_MAX_CHILDREN     16    //Children of a single group
+#endif
+#ifndef SIMPLEUI_MAX_LIST_ITEMS
+  #define SIMPLEUI_MAX_LIST_ITEMS   32    //Recycled items of a single ListView
+#endif
+#ifndef SIMPLEUI_MAX_FOCUS_MOVES
+  #define SIMPLEUI_MAX_FOCUS_MOVES  8     //Focus requests queued in a single frame, consecutive ones in the same direction only count once
+#endif
+#ifndef SIMPLEUI_CALLBACK_SIZE
+  #define SIMPLEUI_CALLBACK_SIZE    32    //Bytes available for the captures of a callback
+#endif
+#ifndef SIMPLEUI_MAX_GLYPHS
+  #define SIMPLEUI_MAX_GLYPHS       96    //Characters in a single GlyphAtlas
+#endif
+#ifndef SIMPLEUI_MAX_GLYPH_SPANS
+  #define SIMPLEUI_MAX_GLYPH_SPANS  1024  //Pixel runs of all the glyphs of a single GlyphAtlas
+#endif
+
+#ifndef SIMPLEUI_MAX_LABEL_LENGTH
+  #define SIMPLEUI_MAX_LABEL_LENGTH 24    //Characters of a Label, used by every profile since the text is stored inline
+#endif
+#ifndef SIMPLEUI_OUTLINE_CACHE_SIZE
+  #define SIMPLEUI_OUTLINE_CACHE_SIZE 8   //Outline geometries kept rasterized by a UI, used by every profile
+#endif
+#ifndef SIMPLEUI_OUTLINE_WARMUPS
+  #define SIMPLEUI_OUTLINE_WARMUPS 4      //Outlines a scene being prepared can hand over to the UI before its next frame, used by every profile
+#endif
+#ifndef SIMPLEUI_MAX_OUTLINE_HEIGHT
+  #define SIMPLEUI_MAX_OUTLINE_HEIGHT 128 //Taller outlines are rasterized again on every frame, used by every profile
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+#include <SimpleUI.h>
+#include "images/home_images.h"
+
+/*The scenes of the demo: the home screen with its three apps and the test scene with its three checkboxes. src/main.cpp shows them on
+the device and tools/replay_runner.cpp replays recorded sessions into them, both build them from here so a replay runs the scenes the
+device shows. What only the device does, like the script of the test scene that draws on the canvas, is added by main.cpp.*/
+
+//The positions and the focus graph of the static scenes are computed by the compiler and stored in flash
+constexpr SimpleUI::LayoutEntry homeEntries[] = {
+  {{64, 32},  HOME_SMALL_TEST_SIZE,     HOME_SMALL_TEST_SIZE,     true},
+  {{25, 32},  HOME_SMALL_SETTINGS_SIZE, HOME_SMALL_SETTINGS_SIZE, true},
+  {{103, 32}, HOME_SMALL_GALLERY_SIZE,  HOME_SMALL_GALLERY_SIZE,  true},
+};
+constexpr auto homeLayout = SimpleUI::makeLayout(homeEntries);
+
+constexpr SimpleUI::LayoutEntry testEntries[] = {
+  {{44, 32}, 16, 16, true},
+  {{64, 32}, 16, 16, true},
+  {{84, 32}, 16, 16, true},
+};
+constexpr auto testLayout = SimpleUI::makeLayout(testEntries);
+
+struct DemoScenes{
+  Texture playTest{HOME_LARGE_TEST_SIZE, HOME_LARGE_TEST_SIZE, home_large_test};
+  Texture smallPlayTest{HOME_SMALL_TEST_SIZE, HOME_SMALL_TEST_SIZE, home_small_test};
+  Texture largeGallery{HOME_LARGE_GALLERY_SIZE, HOME_LARGE_GALLERY_SIZE, home_large_gallery};
+  Texture smallGallery{HOME_SMALL_GALLERY_SIZE, HOME_SMALL_GALLERY_SIZE, home_small_gallery};
+  Texture largeSettings{HOME_LARGE_SETTINGS_SIZE, HOME_LARGE_SETTINGS_SIZE, home_large_settings};
+  Texture smallSettings{HOME_SMALL_SETTINGS_SIZE, HOME_SMALL_SETTINGS_SIZE, home_small_settings};
+
+  SimpleUI::AnimatedApp play    {{}, false, &smallPlayTest, &playTest,      SimpleUI::Constraint::Center, 80U, 2.5f};
+  SimpleUI::AnimatedApp settings{{}, false, &smallSettings, &largeSettings, SimpleUI::Constraint::Center, 80U, 2.5f};
+  SimpleUI::AnimatedApp gallery {{}, false, &smallGallery , &largeGallery,  SimpleUI::Constraint::Center, 80U, 2.5f};
+  SimpleUI::UIElement* const homeElements[3] = {&play, &settings, &gallery};
+  SimpleUI::Scene home{homeLayout, homeElements, nullptr};
+
+  SimpleUI::Checkbox check1{{}, false, 16, 16, SimpleUI::Outline(2, 2, 7, 0xFFFF), 0xFFFF};
+  SimpleUI::Checkbox check2{{}, false, 16, 16, SimpleUI::Outline(2, 2, 7, 0xFFFF), 0xFFFF};
+  SimpleUI::Checkbox check3{{}, false, 16, 16, SimpleUI::Outline(2, 2, 7, 0xFFFF), 0xFFFF};
+  SimpleUI::UIElement* const testElements[3] = {&check1, &check2, &check3};
+  SimpleUI::Scene test{testLayout, testElements, &check1};
+
+  /*!
+    @brief Set the focus outlines and link the scenes to the UI, which has to show the home scene
+    @param ui     The UI the scenes are shown on
+    @param onPlay Called when the play app is clicked, it's expected to focus the test scene
+  */
+  void attach(SimpleUI::UI& ui, const SimpleUI::Callback<void()>& onPlay){
+    using namespace SimpleUI;
+    home.settings.focus.outline = Outline(2, 2, 3);
+    test.settings.focus.outline = Outline(1, 1, 7, "#6b6b6b"_rgb565);
+    test.settings.focus.glide_duration = 120;
+    ui.AddScene(&test);
+    play.bind(onPlay);
+    test.addParents({&home});
+  }
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include <pgmspace.h>
-// 'logo', 28x30px
+// 'logo', 28x30px, the source of splash_logo_rle, only the tools read it
+#define SPLASH_LOGO_WIDTH 28
+#define SPLASH_LOGO_HEIGHT 30
 const unsigned char splash_logo [] PROGMEM = {
 	0xc0, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xe0, 0xff, 0xff, 0xff, 0xe0, 0xff, 0xff, 0xff, 0xc0, 
 	0xff, 0xff, 0xff, 0xc0, 0xff, 0xff, 0xff, 0x00, 0xc0, 0x01, 0xff, 0x00, 0x80, 0x01, 0xff, 0x00, 
@@ -10,4 +12,14 @@ const unsigned char splash_logo [] PROGMEM = {
 	0x07, 0xfc, 0x00, 0x00, 0x0f, 0xfc, 0x00, 0x00, 0x0f, 0xf0, 0x00, 0x30, 0x1f, 0xf0, 0x00, 0x30, 
 	0x1f, 0xff, 0xff, 0xf0, 0x3f, 0xff, 0xff, 0xf0, 0x7f, 0xff, 0xff, 0xf0, 0xff, 0xff, 0xff, 0xf0, 
 	0xff, 0xff, 0xff, 0xf0, 0x00, 0x00, 0x00, 0x30
-};
\ No newline at end of file
+};
+// 'logo' compressed by tools/encode_images.cpp, this is what the splash screen draws
+const unsigned char splash_logo_rle [] PROGMEM = {
+	0x01, 0x00, 0x02, 0x01, 0x00, 0x1b, 0x01, 0x00, 0x1b, 0x01, 0x00, 0x1a, 0x01, 0x00, 0x1a, 0x01,
+	0x00, 0x18, 0x02, 0x00, 0x02, 0x0d, 0x09, 0x02, 0x00, 0x01, 0x0e, 0x09, 0x01, 0x0e, 0x09, 0x01,
+	0x0e, 0x07, 0x01, 0x0c, 0x09, 0x01, 0x0c, 0x08, 0x01, 0x0c, 0x08, 0x01, 0x0a, 0x09, 0x01, 0x09,
+	0x09, 0x01, 0x09, 0x08, 0x01, 0x08, 0x08, 0x01, 0x07, 0x09, 0x01, 0x07, 0x08, 0x01, 0x06, 0x09,
+	0x01, 0x05, 0x09, 0x01, 0x04, 0x0a, 0x02, 0x04, 0x08, 0x0e, 0x02, 0x02, 0x03, 0x09, 0x0e, 0x02,
+	0x01, 0x03, 0x19, 0x01, 0x02, 0x1a, 0x01, 0x01, 0x1b, 0x01, 0x00, 0x1c, 0x01, 0x00, 0x1c, 0x01,
+	0x1a, 0x02
+};
@@ -2,11 +2,11 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_ST7735.h>
 #include <SPI.h>
-#include <images/home_images.h>
 #include <SimpleUI.h>
 #include <HardwareAid.h>
 #include <Animation.h>
 #include "images/splash_screen.h"
+#include "demo_scenes.h"
 
 #define SDA 21
 #define SCL 22
@@ -31,26 +31,65 @@ Button button3(27);
 std::vector<Button*> buttons = {&button1, &button2, &button3};
 
 
-Texture playTest(HOME_LARGE_TEST_SIZE, HOME_LARGE_TEST_SIZE, home_large_test);
-Texture smallPlayTest(HOME_SMALL_TEST_SIZE, HOME_SMALL_TEST_SIZE, home_small_test);
-Texture largeGallery(HOME_LARGE_GALLERY_SIZE, HOME_LARGE_GALLERY_SIZE, home_large_gallery);
-Texture smallGallery(HOME_SMALL_GALLERY_SIZE, HOME_SMALL_GALLERY_SIZE, home_small_gallery);
-Texture largeSettings(HOME_LARGE_SETTINGS_SIZE, HOME_LARGE_SETTINGS_SIZE, home_large_settings);
-Texture smallSettings(HOME_SMALL_SETTINGS_SIZE, HOME_SMALL_SETTINGS_SIZE, home_small_settings);
+DemoScenes demo;
+UI ui(&demo.home, &canvas);
 
+//--------------------------UI SETUP-----------------------------//
 
-AnimatedApp play    ({64, 32},  true, &smallPlayTest, &playTest,      Constraint::Center, 80U, 2.5f);
-AnimatedApp settings({25, 32},  true, &smallSettings, &largeSettings, Constraint::Center, 80U, 2.5f);
-AnimatedApp gallery ({103, 32}, true, &smallGallery , &largeGallery,  Constraint::Center, 80U, 2.5f);
-Scene home({&play, &settings, &gallery}, nullptr);
+//Toggled by the "stream" command, every frame then goes out on the serial as the tiles that changed, see tools/framestream_viewer.cpp
+PrintSink streamSink(Serial);
+FrameStreamer streamer(&streamSink, SCREENWIDTH, SCREENHEIGHT);
+std::atomic<bool> streaming{false};
+//Toggled by the "telemetry" command, frame timings, heap, focus and profiler records as binary, see tools/telemetry_decoder.cpp
+Telemetry telemetry(&ui, &streamSink);
+std::atomic<bool> telemetryOn{false};
+
+//Requested by the bench commands. loop() pauses the UI and runs them on a task of their own, the comms stack can't fit a UI
+enum class Benchmark : uint8_t {None, Render, Text, Scale, Texture, Parallel, Fixed};
+std::atomic<Benchmark> pendingBenchmark{Benchmark::None};
+#define BENCHMARK_STACK 16384
+/*The worker pool is slower than the serial kernels on the host, whether it pays off on the dual-core ESP32 has to come from
+parallelbench on the device. Until it does the kernels stay serial, build with -DUSE_WORKER_POOL=1 to run the UI with it*/
+#ifndef USE_WORKER_POOL
+  #define USE_WORKER_POOL 0
+#endif
+
+void benchmarkTask(void* loopTask){
+  GFXcanvas16 scratch(SCREENWIDTH, SCREENHEIGHT);
+  switch (pendingBenchmark.load()){
+    case Benchmark::Render:
+      for (const size_t count : {10, 100, 1000})
+        UiUtils::benchmarkRender(&scratch, count);
+      break;
+    case Benchmark::Text:     UiUtils::benchmarkText(&scratch); break;
+    case Benchmark::Scale:    UiUtils::benchmarkScale(demo.largeGallery); break;
+    case Benchmark::Texture:
+      UiUtils::benchmarkTexture(&scratch, Texture(SPLASH_LOGO_WIDTH, SPLASH_LOGO_HEIGHT, splash_logo));
+      UiUtils::benchmarkAlpha(&scratch);
+      break;
+    case Benchmark::Parallel: UiUtils::benchmarkParallel(&scratch, demo.largeGallery); break;
+    case Benchmark::Fixed:    UiUtils::benchmarkFixed(); break;
+    case Benchmark::None:     break;
+  }
+  xTaskNotifyGive(static_cast<TaskHandle_t>(loopTask));
+  vTaskDelete(nullptr);
+}
 
-Checkbox check1({44, 32}, true, 16, 16, Outline(2, 2, 7, 0xFFFF), 0xFFFF);
-Checkbox check2({64, 32}, true, 16, 16, Outline(2, 2, 7, 0xFFFF), 0xFFFF);
-Checkbox check3({84, 32}, true, 16, 16, Outline(2, 2, 7, 0xFFFF), 0xFFFF);
-Scene test({&check1, &check2, &check3}, &check1);
-UI ui(&home, &canvas);
+//Called from loop(), which waits for the benchmark so no frame is rendered meanwhile. It runs on the core of the UI to time it like a frame
+void runBenchmark(){
+  if (xTaskCreatePinnedToCore(benchmarkTask, "Bench", BENCHMARK_STACK, xTaskGetCurrentTaskHandle(), uxTaskPriorityGet(nullptr), nullptr, xPortGetCoreID()) == pdPASS)
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+  else
+    Serial.println("Not enough memory for the benchmark task!");
+  pendingBenchmark = Benchmark::None;
+}
 
-//--------------------------UI SETUP-----------------------------//
+//The comms task waits as well, so no command reaches the UI while it's paused
+void requestBenchmark(Benchmark benchmark){
+  pendingBenchmark = benchmark;
+  while (pendingBenchmark != Benchmark::None)
+    vTaskDelay(pdMS_TO_TICKS(10));
+}
 
 TaskHandle_t serialComms;
 void handleComms( void *pvParameters){
@@ -58,7 +97,7 @@ void handleComms( void *pvParameters){
 
   while(true){
     if (Serial.available()){
-      String input = Serial.readString();
+      String input = Serial.readStringUntil('\n');
       input.trim();
       if (input == "freemem")
       {
@@ -83,14 +122,16 @@ void handleComms( void *pvParameters){
       else if (input == "debugui")
       {
         UIElement *obj = ui.getFocused();
-        Serial.printf("ID: %s\n", ui.focus.focusedElementID.c_str());
+        Serial.printf("ID: %u\n", ui.focus.focusedElementID);
         Serial.printf("Position: (%d, %d)\n", obj->getPos().x, obj->getPos().y);
-        switch(obj->anim.getState()){
-          case AnimState::Start: Serial.println("AnimState: Start"); break;
-          case AnimState::Running: Serial.println("AnimState: Running"); break;
-          case AnimState::Finished: Serial.println("AnimState: Finished"); break;
+        if (const Animation* anim = obj->getAnimation()){
+          switch(anim->getState()){
+            case AnimState::Start: Serial.println("AnimState: Start"); break;
+            case AnimState::Running: Serial.println("AnimState: Running"); break;
+            case AnimState::Finished: Serial.println("AnimState: Finished"); break;
+          }
+          Serial.printf("Direction: %s\n", anim->getDirection() ? "Forward" : "Reverse");
         }
-        Serial.printf("Direction: %s\n", obj->anim.getDirection() ? "Forward" : "Reverse");
         Serial.printf("Draw: %s\n", obj->draw ? "true" : "false");
         if(obj->getType() == ElementType::UIElement)
           Serial.println("Type: UIElement");
@@ -98,11 +139,15 @@ void handleComms( void *pvParameters){
           Serial.println("Type: UIImage");
         else if (obj->getType() == ElementType::Checkbox)
           Serial.println("Type: Checkbox");
+        else if (obj->getType() == ElementType::ListView)
+          Serial.println("Type: ListView");
+        else if (obj->getType() == ElementType::Label)
+          Serial.println("Type: Label");
         else 
           Serial.println("Type: AnimatedApp");
         Serial.printf("Focusable: %s\n", obj->focusable ? "true" : "false");
         Serial.printf("Custom outline: %s\n", obj->custom_focus_outline ? "true" : "false");
-        Serial.printf("Constraint: %s\n", UiUtils::constraintToString(obj->scale_constraint).c_str());
+        Serial.printf("Constraint: %s\n", UiUtils::constraintToString(obj->scale_constraint));
         Serial.println("----Scene----");
         Serial.printf("Max focusing distance: %d\n", ui.getActiveScene()->settings.focus.max_distance);
         Serial.printf("Focusing algorithm: %s\n", ui.getActiveScene()->settings.focus.algorithm == FocusingAlgorithm::Linear ? "Linear" : "Cone");
@@ -117,10 +162,58 @@ void handleComms( void *pvParameters){
           Serial.println("Performance profiling is turned off!");
         #endif
       }
+      else if (input == "latency")
+      {
+        #if LATENCY_PROFILING
+          ui.printLatencyStats();
+        #else
+          Serial.println("Latency profiling is turned off!");
+        #endif
+      }
+      else if (input == "footprint")
+      {
+        UiUtils::printFootprint(&ui);
+      }
+      else if (input == "renderbench")
+      {
+        requestBenchmark(Benchmark::Render);
+      }
+      else if (input == "textbench")
+      {
+        requestBenchmark(Benchmark::Text);
+      }
+      else if (input == "scalebench")
+      {
+        requestBenchmark(Benchmark::Scale);
+      }
+      else if (input == "texturebench")
+      {
+        requestBenchmark(Benchmark::Texture);
+      }
+      else if (input == "parallelbench")
+      {
+        requestBenchmark(Benchmark::Parallel);
+      }
+      else if (input == "fixedbench")
+      {
+        requestBenchmark(Benchmark::Fixed);
+      }
       else if (input == "back")
       {
         ui.Back();
       }
+      else if (input == "stream")
+      {
+        if (!streaming)
+          streamer.requestKeyframe();
+        Serial.printf("Streaming: %s\n", streaming ? "off" : "on");
+        streaming = !streaming;
+      }
+      else if (input == "telemetry")
+      {
+        Serial.printf("Telemetry: %s\n", telemetryOn ? "off" : "on");
+        telemetryOn = !telemetryOn;
+      }
     }
     vTaskDelay(pdMS_TO_TICKS(100));
   }
@@ -128,7 +221,7 @@ void handleComms( void *pvParameters){
 
 
 Animation myAnimation(0.0f, 118.0f, 1000U, 2.4f);
-uint32_t calcStart = micros(), lastFrame = micros(), deltaTime = 0;
+uint32_t calcStart = 0, lastFrame = 0, deltaTime = 0;
 
 
 
@@ -136,10 +229,14 @@ uint32_t calcStart = micros(), lastFrame = micros(), deltaTime = 0;
 bool render_frametime = true;
 unsigned int fpsTarget = FPS90;
 unsigned int calculationsTime=0;
-uint16_t debugColor = hex("#ff8e00");
+constexpr uint16_t debugColor = "#ff8e00"_rgb565;
+const GlyphAtlas systemFont;
+Label fpsLabel({0, 50}, false, &systemFont, ST7735_GREEN, 2);
+Label fpsUnit({0, 57}, false, &systemFont, ST7735_GREEN);
+Label computeLabel({60, 50}, false, &systemFont, ST7735_RED, 2);
 
 auto loadTest = [&](){
-  ui.FocusScene(&test);
+  ui.FocusScene(&demo.test);
   myAnimation.Reset();
   myAnimation.Start();
 
@@ -147,7 +244,7 @@ auto loadTest = [&](){
 
 auto testSceneScript = [&](){
   static uint8_t count=1;
-  canvas.fillRect(round(myAnimation.getProgress()), 0, 10, 10, ST7735_ORANGE);
+  canvas.fillRect(Fixed::of(myAnimation).round(), 0, 10, 10, ST7735_ORANGE);
   canvas.fillRect(56, 8, 16, 16, ST7735_ORANGE);
   myAnimation.Update();
     if(myAnimation == AnimState::Finished){
@@ -155,7 +252,7 @@ auto testSceneScript = [&](){
       myAnimation.Flip();
       myAnimation.Reset();
       if (count==2){
-        test.settings.scriptOnTop = !test.settings.scriptOnTop;
+        demo.test.settings.scriptOnTop = !demo.test.settings.scriptOnTop;
         count = 0;
       }
     }
@@ -170,23 +267,17 @@ void blit()
 }
 void framerate(bool render){
   if(render){
-    canvas.setCursor(0,50);
-    canvas.setTextSize(2);
-    canvas.setTextColor(ST7735_GREEN);
-    canvas.setTextWrap(false);
-    canvas.print(1000000/deltaTime);
-    canvas.setCursor(canvas.getCursorX(),57);
-    canvas.setTextSize(1);
-    canvas.print("FPS");
+    fpsLabel.setNumber(1000000/deltaTime);
+    fpsLabel.render();
+    const Rect bounds = fpsLabel.getBounds();
+    fpsUnit.setPosX(bounds.x + bounds.w);
+    fpsUnit.render();
   }
 }
 void computeTime(bool render){
   if(render){
-    canvas.setCursor(60,50);
-    canvas.setTextSize(2);
-    canvas.setTextColor(ST7735_RED);
-    canvas.setTextWrap(false);
-    canvas.print(calculationsTime);
+    computeLabel.setNumber(calculationsTime);
+    computeLabel.render();
   }
 }
 void initLCD(){
@@ -198,8 +289,10 @@ void initLCD(){
   canvas.fillScreen(ST7735_BLACK);
   blit();
   delay(10);
-  Point pos = UIElement::centerToCornerPos(64, 32, 28, 30);
-  tft.drawBitmap(pos.x, pos.y, splash_logo, 28, 30, 0xffff);
+  constexpr Point pos = UIElement::centerToCornerPos(64, 32, SPLASH_LOGO_WIDTH, SPLASH_LOGO_HEIGHT);
+  const Texture logo(SPLASH_LOGO_WIDTH, SPLASH_LOGO_HEIGHT, PixelType::RLEMono, splash_logo_rle);
+  drawTexture(&canvas, logo, pos.x, pos.y);
+  blit();
 
   Serial.begin(115200);
   analogWrite(BACKLIGHT, 50);
@@ -215,36 +308,44 @@ void setup() {
   setupButtons(buttons);
 
   xTaskCreatePinnedToCore(handleComms, "Comms", 2000, NULL, 1, &serialComms, 0);
-
-  home.settings.focus.outline = Outline(2, 2, 3);
-  test.settings.focus.outline = Outline(1, 1, 7, hex("#6b6b6b"));
-  ui.AddScene(&test);
-  play.bind(loadTest);
-  test.addParents({&home});
-  test.Script(testSceneScript, true);
+  #if USE_WORKER_POOL
+  WorkerPool::global().start();  //Full screen textures and transitions share their rows with the other core
+  #endif
+
+  demo.attach(ui, loadTest);
+  demo.test.Script(testSceneScript, true);
+  ui.PreloadScene(&demo.test);
+  fpsUnit.setText("FPS");
+  for (Label* label : {&fpsLabel, &fpsUnit, &computeLabel})
+    label->setUiListener(&ui);
   delay(1000);
 }
 
 
 void loop() {
-  deltaTime = micros() - lastFrame;
+  if (pendingBenchmark != Benchmark::None){
+    runBenchmark();
+    return;
+  }
+  const uint32_t now = ui.getClock().micros();  //Shared by the buttons and the frame pacing, the UI samples its own time in Render()
+  deltaTime = now - lastFrame;
 
-  updateButtons(buttons);  //Update button states for every button
+  updateButtons(buttons, now);  //Update button states for every button
   
   if (button1.clickedOnce && !button2.clickedOnce ) {
-    ui.FocusDirection(Direction::Right);
+    ui.FocusDirection(Direction::Right, button1.press_time);
   }
   if (button2.clickedOnce&& !button1.clickedOnce ) {
     
-    ui.FocusDirection(Direction::Left);
+    ui.FocusDirection(Direction::Left, button2.press_time);
   }
   
   if(button3.clickedOnce){
-    ui.Click();
+    ui.Click(button3.press_time);
   }
 
   if (deltaTime >= fpsTarget){
-    lastFrame = micros();
+    lastFrame = now;
     
     canvas.fillScreen(0x0000); //Fill the background with a black frame
     
@@ -257,6 +358,11 @@ void loop() {
     framerate(render_frametime);  //Render the framerate in the bottom-left corner on top of everything
 
     blit(); //RENDER THE FRAME
+    ui.Presented();
+    if (streaming)
+      streamer.send(canvas.getBuffer());
+    if (telemetryOn)
+      telemetry.sample(calculationsTime);
 
     //TEMPORAL VARIABLES AND FUNCTIONS
     
@@ -0,0 +1,66 @@
+/*
+  Host tool that compresses the Mono bitmaps of src/images to RLEMono. It prints how big every bitmap is raw and compressed, and the
+  C array of the ones named on the command line so it can be pasted in its header. RLEMono only pays off for bitmaps made of long runs:
+  the outlined icons of the home screen grow, the filled splash logo shrinks.
+
+  Build:  tools/host/build.sh tools/encode_images.cpp encode_images
+  Usage:  encode_images               Prints the raw and RLEMono size of every bitmap
+          encode_images <name>...     Prints the RLEMono array of the named bitmaps, exits with 1 if one isn't known
+*/
+#include "SimpleUI.h"
+#include "../src/images/home_images.h"
+#include "../src/images/splash_screen.h"
+#include <vector>
+
+struct Bitmap{
+    const char* name;
+    unsigned int width, height;
+    const uint8_t* bits;
+};
+
+static const Bitmap bitmaps[] = {
+    {"home_large_gallery",  HOME_LARGE_GALLERY_SIZE,  HOME_LARGE_GALLERY_SIZE,  home_large_gallery},
+    {"home_large_settings", HOME_LARGE_SETTINGS_SIZE, HOME_LARGE_SETTINGS_SIZE, home_large_settings},
+    {"home_large_test",     HOME_LARGE_TEST_SIZE,     HOME_LARGE_TEST_SIZE,     home_large_test},
+    {"home_small_gallery",  HOME_SMALL_GALLERY_SIZE,  HOME_SMALL_GALLERY_SIZE,  home_small_gallery},
+    {"home_small_settings", HOME_SMALL_SETTINGS_SIZE, HOME_SMALL_SETTINGS_SIZE, home_small_settings},
+    {"home_small_test",     HOME_SMALL_TEST_SIZE,     HOME_SMALL_TEST_SIZE,     home_small_test},
+    {"splash_logo",         SPLASH_LOGO_WIDTH,        SPLASH_LOGO_HEIGHT,       splash_logo},
+};
+
+static void printArray(const Bitmap& bitmap){
+    const Texture texture(bitmap.width, bitmap.height, bitmap.bits);
+    std::vector<uint8_t> encoded(encodeRLEMono(texture, nullptr, 0));
+    encodeRLEMono(texture, encoded.data(), encoded.size());
+    printf("// '%s', %ux%upx, RLEMono\n", bitmap.name, bitmap.width, bitmap.height);
+    printf("const unsigned char %s_rle [] PROGMEM = {", bitmap.name);
+    for (size_t i = 0; i < encoded.size(); i++)
+        printf("%s0x%02x%s", i % 16 ? " " : "\n\t", encoded[i], i + 1 < encoded.size() ? "," : "");
+    printf("\n};\n");
+}
+
+int main(int argc, char** argv){
+    if (argc < 2){
+        printf("bitmap,raw,rle\n");
+        for (const Bitmap& bitmap : bitmaps){
+            const Texture texture(bitmap.width, bitmap.height, bitmap.bits);
+            printf("%s,%u,%u\n", bitmap.name, (bitmap.width + 7) / 8 * bitmap.height, static_cast<unsigned int>(encodeRLEMono(texture, nullptr, 0)));
+        }
+        return 0;
+    }
+    int unknown = 0;
+    for (int i = 1; i < argc; i++){
+        const Bitmap* found = nullptr;
+        for (const Bitmap& bitmap : bitmaps){
+            if (!strcmp(bitmap.name, argv[i]))
+                found = &bitmap;
+        }
+        if (found)
+            printArray(*found);
+        else{
+            fprintf(stderr, "unknown bitmap \"%s\"\n", argv[i]);
+            unknown = 1;
+        }
+    }
+    return unknown;
+}
@@ -0,0 +1,85 @@
+/*
+  Host build of the footprint report, the same numbers UiUtils::printFootprint() prints on the serial, as CSV so memory regressions can
+  be tracked across commits. The scenes are built like the demo's. Pointers are 8 bytes on most hosts and 4 on the ESP32, so compare
+  reports of the same host with each other, not with the device.
+
+  Build:  tools/host/build.sh tools/footprint_report.cpp footprint_report [-DSIMPLEUI_STATIC_MEMORY=1]
+  Usage:  footprint_report > footprint.csv
+          footprint_report footprint.csv      Prints the report and exits with 1 if anything grew compared to an earlier one
+*/
+#include "SimpleUI.h"
+#include <map>
+#include <string>
+
+using namespace SimpleUI;
+
+static const uint8_t dot[] = {0x60, 0xF0, 0xF0, 0x60, 0x3C, 0x7E, 0xFF, 0xFF};
+
+static std::string profileLine(){
+    char line[64];
+    snprintf(line, sizeof(line), "# profile %s, %u byte pointers\n", SIMPLEUI_STATIC_MEMORY ? "static" : "dynamic", static_cast<unsigned int>(sizeof(void*)));
+    return line;
+}
+
+static std::map<std::string, size_t> readReport(const char* path){
+    std::map<std::string, size_t> report;
+    FILE* file = fopen(path, "r");
+    if (!file){
+        perror(path);
+        return report;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), file)){
+        if (line[0] == '#' && line != profileLine())
+            fprintf(stderr, "%s was made by another build: %s", path, line + 2);
+        char* comma = strchr(line, ',');
+        if (line[0] == '#' || !comma)
+            continue;
+        *comma = '\0';
+        report[line] = strtoul(comma + 1, nullptr, 10);
+    }
+    fclose(file);
+    return report;
+}
+
+int main(int argc, char** argv){
+    GFXcanvas16 canvas(128, 64);
+    Texture small(8, 4, dot), big(8, 8, dot);
+    AnimatedApp play({20, 32}, true, &small, &big), settings({64, 32}, true, &small, &big), gallery({108, 32}, true, &small, &big);
+    Scene home({&play, &settings, &gallery}, &play);
+    Checkbox check1({10, 10}, false, 12, 12), check2({30, 10}, false, 12, 12), check3({50, 10}, false, 12, 12);
+    Group checks({&check1, &check2, &check3});
+    GlyphAtlas atlas;
+    Label title({70, 10}, false, &atlas);
+    title.setText("Footprint");
+    ListView list({0, 28}, false, 128, 36, 12);
+    list.setFactory([](){ return static_cast<UIElement*>(new Checkbox({0, 0}, false, 10, 10)); });
+    list.setSource(40, [](UIElement*, size_t){});
+    Scene test({&checks, &title, &list}, &check1);
+    UI ui(&home, &canvas);
+    ui.AddScene(&test);
+    ui.Render();
+
+    std::map<std::string, size_t> report = {
+        {"UIElement", sizeof(UIElement)}, {"UIImage", sizeof(UIImage)}, {"AnimatedApp", sizeof(AnimatedApp)}, {"Checkbox", sizeof(Checkbox)},
+        {"ListView", sizeof(ListView)}, {"Group", sizeof(Group)}, {"Label", sizeof(Label)}, {"GlyphAtlas", sizeof(GlyphAtlas)},
+        {"Scene", sizeof(Scene)}, {"UI", sizeof(UI)}, {"AnimationStore", sizeof(AnimationStore)}, {"Texture", sizeof(Texture)},
+        {"scene.home", UiUtils::getFootprint(&home)}, {"scene.test", UiUtils::getFootprint(&test)},
+        {"animations.used", AnimationStore::global().getUsed()},
+    };
+    fputs(profileLine().c_str(), stdout);
+    for (const auto& [name, bytes] : report)
+        printf("%s,%zu\n", name.c_str(), bytes);
+
+    if (argc < 2)
+        return 0;
+    int grown = 0;
+    for (const auto& [name, bytes] : readReport(argv[1])){
+        const auto now = report.find(name);
+        if (now != report.end() && now->second > bytes){
+            fprintf(stderr, "%s grew from %zu to %zu bytes\n", name.c_str(), bytes, now->second);
+            grown++;
+        }
+    }
+    return grown ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+/*
+  Host side of the framebuffer stream sent by the "stream" serial command. It reads the stream from a serial port, a pipe or stdin,
+  rebuilds the frames and writes the latest one as a PPM image, optionally keeping every frame.
+
+  Build:  g++ -std=c++17 -O2 -I lib/SimpleUI/deps -I lib/SimpleUI/deps/FrameStream tools/framestream_viewer.cpp lib/SimpleUI/deps/FrameStream/FrameStream.cpp -o framestream_viewer
+  Usage:  framestream_viewer <input|-> [output directory] [--all]
+          stty -F /dev/ttyUSB0 115200 raw && framestream_viewer /dev/ttyUSB0 frames
+          nc -l 5555 | framestream_viewer - frames --all
+*/
+#include "FrameStream.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace SimpleUI;
+
+struct Viewer{
+    std::string directory;
+    bool keep_all = false;
+    size_t bytes = 0;
+    uint32_t frames = 0;
+};
+
+//RGB565 to 8 bit channels, the low bits are filled from the high ones so white stays white
+static void writePPM(const std::string& path, const FrameStreamDecoder& decoder){
+    FILE* file = fopen((path + ".tmp").c_str(), "wb");
+    if (!file)
+        return;
+    const uint16_t w = decoder.getWidth();
+    const uint16_t h = decoder.getHeight();
+    fprintf(file, "P6\n%u %u\n255\n", w, h);
+    std::vector<uint8_t> row(w * 3);
+    for (uint16_t y = 0; y < h; y++){
+        const uint16_t* pixels = decoder.getPixels() + static_cast<size_t>(y) * w;
+        for (uint16_t x = 0; x < w; x++){
+            const uint8_t r = pixels[x] >> 11, g = (pixels[x] >> 5) & 0x3F, b = pixels[x] & 0x1F;
+            row[x * 3] = (r << 3) | (r >> 2);
+            row[x * 3 + 1] = (g << 2) | (g >> 4);
+            row[x * 3 + 2] = (b << 3) | (b >> 2);
+        }
+        fwrite(row.data(), 1, row.size(), file);
+    }
+    fclose(file);
+    //Replaced at once so an image viewer watching the file never reads half a frame
+    rename((path + ".tmp").c_str(), path.c_str());
+}
+
+static void onFrame(const FrameStreamDecoder& decoder, void* context){
+    Viewer& viewer = *static_cast<Viewer*>(context);
+    viewer.frames++;
+    viewer.bytes += decoder.getFrameSize();
+    writePPM(viewer.directory + "/latest.ppm", decoder);
+    if (viewer.keep_all){
+        char name[32];
+        snprintf(name, sizeof(name), "/frame_%06u.ppm", static_cast<unsigned int>(decoder.getFrame()));
+        writePPM(viewer.directory + name, decoder);
+    }
+    fprintf(stderr, "frame %u: %u tiles, %zu bytes, %zu bytes per frame on average, %u dropped\n", static_cast<unsigned int>(decoder.getFrame()),
+            decoder.getFrameTiles(), decoder.getFrameSize(), viewer.bytes / viewer.frames, static_cast<unsigned int>(decoder.getErrors()));
+}
+
+int main(int argc, char** argv){
+    if (argc < 2){
+        fprintf(stderr, "usage: %s <input|-> [output directory] [--all]\n", argv[0]);
+        return 1;
+    }
+    Viewer viewer;
+    viewer.directory = argc > 2 ? argv[2] : ".";
+    viewer.keep_all = argc > 3 && !strcmp(argv[3], "--all");
+
+    const int fd = strcmp(argv[1], "-") ? open(argv[1], O_RDONLY) : STDIN_FILENO;
+    if (fd < 0){
+        perror(argv[1]);
+        return 1;
+    }
+    FrameStreamDecoder decoder;
+    decoder.onFrame(onFrame, &viewer);
+    uint8_t buffer[4096];
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+        decoder.feed(buffer, static_cast<size_t>(length));
+    return 0;
+}
@@ -0,0 +1,151 @@
+#pragma once
+/*
+  Stand-in for the parts of Adafruit GFX the library uses on the host. GFXcanvas16 really draws, so frames rendered on the host can be
+  hashed and compared. The built-in font is not the classic 5x7 one, its glyphs are a fixed pattern per character: the host output is
+  only meant to be compared with other host runs.
+*/
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include "Arduino.h"
+
+typedef struct{
+    uint16_t bitmapOffset;
+    uint8_t width;
+    uint8_t height;
+    uint8_t xAdvance;
+    int8_t xOffset;
+    int8_t yOffset;
+} GFXglyph;
+
+typedef struct{
+    uint8_t* bitmap;
+    GFXglyph* glyph;
+    uint16_t first;
+    uint16_t last;
+    uint8_t yAdvance;
+} GFXfont;
+
+class Adafruit_GFX{
+    public:
+    Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h){}
+    virtual ~Adafruit_GFX(){}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+        for (int16_t j = y; j < y + h; j++)
+            for (int16_t i = x; i < x + w; i++)
+                drawPixel(i, j, color);
+    }
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color){ fillRect(x, y, w, 1, color); }
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color){ fillRect(x, y, 1, h, color); }
+    virtual void fillScreen(uint16_t color){ fillRect(0, 0, _width, _height, color); }
+
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color){
+        drawFastHLine(x, y, w, color);
+        drawFastHLine(x, y + h - 1, w, color);
+        drawFastVLine(x, y, h, color);
+        drawFastVLine(x + w - 1, y, h, color);
+    }
+    //The corners are cut along the circle of the radius
+    void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color){
+        r = std::min<int16_t>(r, std::min(w, h) / 2);
+        for (int16_t j = 0; j < h; j++){
+            const int16_t dy = j < r ? r - j : (j >= h - r ? j - (h - r - 1) : 0);
+            const int16_t inset = dy ? r - static_cast<int16_t>(sqrtf(static_cast<float>(r * r - dy * dy))) : 0;
+            drawFastHLine(x + inset, y + j, w - 2 * inset, color);
+        }
+    }
+    void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color){
+        const int16_t stride = (w + 7) / 8;
+        for (int16_t j = 0; j < h; j++)
+            for (int16_t i = 0; i < w; i++)
+                if (bitmap[j * stride + i / 8] & (0x80 >> (i & 7)))
+                    drawPixel(x + i, y + j, color);
+    }
+    void drawRGBBitmap(int16_t x, int16_t y, const uint16_t* bitmap, int16_t w, int16_t h){
+        for (int16_t j = 0; j < h; j++)
+            for (int16_t i = 0; i < w; i++)
+                drawPixel(x + i, y + j, bitmap[j * w + i]);
+    }
+
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t, uint8_t size){
+        if (!gfxFont){
+            //A 5x7 cell with a pattern that only depends on the character
+            for (int16_t i = 0; i < 5; i++)
+                for (int16_t j = 0; j < 7; j++)
+                    if ((c * 7 + i * 3 + j * 5) % 4 == 0)
+                        fillRect(x + i * size, y + j * size, size, size, color);
+            return;
+        }
+        if (c < gfxFont->first || c > gfxFont->last)
+            return;
+        const GFXglyph& glyph = gfxFont->glyph[c - gfxFont->first];
+        const uint8_t* bitmap = gfxFont->bitmap + glyph.bitmapOffset;
+        uint8_t bits = 0, bit = 0;
+        for (int16_t j = 0; j < glyph.height; j++){
+            for (int16_t i = 0; i < glyph.width; i++){
+                if (!(bit++ & 7))
+                    bits = *bitmap++;
+                if (bits & 0x80)
+                    fillRect(x + (glyph.xOffset + i) * size, y + (glyph.yOffset + j) * size, size, size, color);
+                bits <<= 1;
+            }
+        }
+    }
+    void setFont(const GFXfont* font = nullptr){ gfxFont = font; }
+    void setCursor(int16_t x, int16_t y){ cursor_x = x; cursor_y = y; }
+    void setTextSize(uint8_t size){ textsize = size ? size : 1; }
+    void setTextColor(uint16_t color){ textcolor = color; }
+    void setTextWrap(bool){}
+    int16_t getCursorX() const { return cursor_x; }
+    int16_t getCursorY() const { return cursor_y; }
+    size_t print(const char* text){
+        size_t count = 0;
+        for (; *text; text++, count++){
+            drawChar(cursor_x, cursor_y, static_cast<unsigned char>(*text), textcolor, textcolor, textsize);
+            cursor_x += (gfxFont && *text >= gfxFont->first && *text <= gfxFont->last ? gfxFont->glyph[*text - gfxFont->first].xAdvance : 6) * textsize;
+        }
+        return count;
+    }
+    size_t print(int value){ char text[12]; snprintf(text, sizeof(text), "%d", value); return print(text); }
+    size_t print(unsigned int value){ char text[12]; snprintf(text, sizeof(text), "%u", value); return print(text); }
+    size_t print(long value){ return print(static_cast<int>(value)); }
+    size_t print(unsigned long value){ return print(static_cast<unsigned int>(value)); }
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+    protected:
+    int16_t _width, _height;
+    int16_t cursor_x = 0, cursor_y = 0;
+    uint16_t textcolor = 0xFFFF;
+    uint8_t textsize = 1;
+    const GFXfont* gfxFont = nullptr;
+};
+
+class GFXcanvas16 : public Adafruit_GFX{
+    public:
+    GFXcanvas16(uint16_t w, uint16_t h) : Adafruit_GFX(w, h), buffer(static_cast<uint16_t*>(calloc(static_cast<size_t>(w) * h, sizeof(uint16_t)))){}
+    ~GFXcanvas16(){ free(buffer); }
+    GFXcanvas16(const GFXcanvas16&) = delete;
+    GFXcanvas16& operator=(const GFXcanvas16&) = delete;
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (x >= 0 && y >= 0 && x < _width && y < _height)
+            buffer[y * _width + x] = color;
+    }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+        const int16_t left = std::max<int16_t>(x, 0), top = std::max<int16_t>(y, 0);
+        const int16_t right = std::min<int16_t>(x + w, _width), bottom = std::min<int16_t>(y + h, _height);
+        for (int16_t j = top; j < bottom; j++)
+            for (int16_t i = left; i < right; i++)
+                buffer[j * _width + i] = color;
+    }
+    void fillScreen(uint16_t color) override { fillRect(0, 0, _width, _height, color); }
+    uint16_t getPixel(int16_t x, int16_t y) const { return (x >= 0 && y >= 0 && x < _width && y < _height) ? buffer[y * _width + x] : 0; }
+    uint16_t* getBuffer() const { return buffer; }
+
+    private:
+    uint16_t* buffer;
+};
@@ -0,0 +1,48 @@
+#pragma once
+/*
+  Stand-in for the parts of the Arduino core the library uses, so it can be built on a desktop for the host tools and tests under
+  tools/. Time comes from the steady clock, Serial prints to stdout and never receives anything.
+*/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+
+#define PROGMEM
+#define pgm_read_byte(address) (*reinterpret_cast<const uint8_t*>(address))
+#define pgm_read_word(address) (*reinterpret_cast<const uint16_t*>(address))
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+inline uint32_t micros(){
+    static const auto boot = std::chrono::steady_clock::now();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - boot).count());
+}
+inline uint32_t millis(){ return micros() / 1000UL; }
+inline void delay(uint32_t){}
+inline void pinMode(uint8_t, uint8_t){}
+inline int digitalRead(uint8_t){ return 0; }
+
+class HostSerial{
+    public:
+    void begin(unsigned long){}
+    template<typename... Args>
+    size_t printf(const char* format, Args... args){ return static_cast<size_t>(::printf(format, args...)); }
+    size_t print(const char* text){ return static_cast<size_t>(fputs(text, stdout)); }
+    size_t print(char c){ return static_cast<size_t>(putchar(c) != EOF); }
+    size_t print(int value){ return static_cast<size_t>(::printf("%d", value)); }
+    size_t print(unsigned int value){ return static_cast<size_t>(::printf("%u", value)); }
+    size_t print(double value){ return static_cast<size_t>(::printf("%.2f", value)); }
+    size_t println(){ return static_cast<size_t>(putchar('\n') != EOF); }
+    template<typename T>
+    size_t println(T value){ const size_t written = print(value); return written + println(); }
+    size_t write(uint8_t byte){ return static_cast<size_t>(putchar(byte) != EOF); }
+    size_t write(const uint8_t* data, size_t length){ return fwrite(data, 1, length, stdout); }
+    int available(){ return 0; }
+    int read(){ return -1; }
+    void flush(){ fflush(stdout); }
+};
+inline HostSerial Serial;
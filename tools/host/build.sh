@@ -0,0 +1,19 @@
+#!/bin/sh
+# Builds a host program of tools/ against the whole library, with the stand-ins of this directory in place of the Arduino core.
+#   tools/host/build.sh <program.cpp> [output] [compiler flags...]
+#   tools/host/build.sh tools/test_latency.cpp /tmp/test_latency -DLATENCY_PROFILING=1 && /tmp/test_latency
+# Run it from the root of the repository. Every test exits with a non-zero status when a check fails.
+set -e
+if [ $# -lt 1 ]; then
+    echo "usage: $0 <program.cpp> [output] [compiler flags...]" >&2
+    exit 1
+fi
+program=$1
+output=${2:-$(basename "$program" .cpp)}
+[ $# -ge 2 ] && shift 2 || shift 1
+includes="-I tools/host -I lib/SimpleUI/src -I lib/SimpleUI/deps"
+for dep in lib/SimpleUI/deps/*/; do
+    includes="$includes -I $dep"
+done
+# The reorder and sign-compare warnings of the library predate the host build
+${CXX:-g++} -std=gnu++17 -O2 -pthread -Wall -Wno-reorder -Wno-sign-compare $includes "$@" "$program" lib/SimpleUI/src/*.cpp lib/SimpleUI/deps/*/*.cpp -o "$output"
@@ -0,0 +1,3 @@
+#pragma once
+//Stand-in for the AVR flash helpers, on the host they're the ones of Arduino.h so the images of the demo can be included as they are
+#include "Arduino.h"
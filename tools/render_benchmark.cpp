@@ -0,0 +1,52 @@
+/*
+  Host runner of the benchmarks behind the renderbench, textbench, scalebench, texturebench, parallelbench and fixedbench commands,
+  on a 128x64 canvas like the demo's. The timings are the host's, they're only meant to compare commits with each other. The animation store is
+  sized for the 1000 elements scene, larger counts whose animations don't fit in SIMPLEUI_MAX_ANIMATIONS are reported and skipped.
+
+  Build:  tools/host/build.sh tools/render_benchmark.cpp render_benchmark -DSIMPLEUI_MAX_ANIMATIONS=1024
+  Usage:  render_benchmark [element counts...]     10, 100 and 1000 elements by default
+          The exit status is the number of scenes that were skipped
+*/
+#include "SimpleUI.h"
+#include <vector>
+#if SIMPLEUI_MAX_ANIMATIONS < 1024
+  #error "Build with -DSIMPLEUI_MAX_ANIMATIONS=1024, the default counts don't fit in a smaller animation store"
+#endif
+
+using namespace SimpleUI;
+
+int main(int argc, char** argv){
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; i++)
+        counts.push_back(strtoul(argv[i], nullptr, 10));
+    if (counts.empty())
+        counts = {10, 100, 1000};
+
+    GFXcanvas16 canvas(128, 64);
+    int skipped = 0;
+    for (const size_t count : counts)
+        skipped += !UiUtils::benchmarkRender(&canvas, count);
+    UiUtils::benchmarkText(&canvas);
+
+    //A 32x32 RGB565 gradient, the largest texture of the demo
+    static uint16_t pixels[32 * 32];
+    for (int i = 0; i < 32 * 32; i++)
+        pixels[i] = static_cast<uint16_t>(((i % 32) << 11) | ((i / 32) << 6) | (i % 31));
+    Texture texture(32, 32, pixels);
+    UiUtils::benchmarkScale(texture);
+
+    //A sparse 36x36 icon like the ones of the home screen: a thin ring and a dot, the case RLEMono is meant for
+    static uint8_t icon[5 * 36];
+    for (int y = 0; y < 36; y++){
+        for (int x = 0; x < 36; x++){
+            const int distance = (x - 18) * (x - 18) + (y - 18) * (y - 18);
+            if ((distance >= 14 * 14 && distance < 16 * 16) || distance < 3 * 3)
+                icon[y * 5 + x / 8] |= 0x80 >> (x % 8);
+        }
+    }
+    UiUtils::benchmarkTexture(&canvas, Texture(36, 36, icon));
+    UiUtils::benchmarkAlpha(&canvas);
+    UiUtils::benchmarkParallel(&canvas, texture);
+    UiUtils::benchmarkFixed();
+    return skipped;
+}
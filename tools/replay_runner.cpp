@@ -0,0 +1,143 @@
+/*
+  Host runner of Replay. Plays a recorded session into the scenes of the demo on a virtual clock, hashes every frame and checks the
+  hashes against a golden file, so a change that alters what's on screen fails it, and reports how long the frames took to render.
+  The host canvas doesn't draw text like the device does, golden files are only meant to be compared with other host runs.
+
+  Build:  tools/host/build.sh tools/replay_runner.cpp replay_runner
+  Usage:  replay_runner <script>                           Prints every frame as CSV: frame, time, hash and render time
+          replay_runner <script> <golden>                  Exits with 1 if a frame differs from the golden one
+          replay_runner <script> <golden> --update         Writes the golden file from this run
+
+  A script has one input per line: the time in microseconds from the start of the session, then "direction <degrees>", "click" or
+  "back". Empty lines and the ones starting with # are skipped, any other line that isn't an input fails the run before it starts.
+  See tools/replay/ for a sample session and its golden file.
+*/
+#include "SimpleUI.h"
+#include "../src/demo_scenes.h"
+#include <vector>
+
+using namespace SimpleUI;
+
+static bool readScript(const char* path, std::vector<ReplayEvent>& events){
+    FILE* file = fopen(path, "r");
+    if (!file){
+        perror(path);
+        return false;
+    }
+    char line[128];
+    unsigned int number = 0;
+    bool valid = true;
+    while (fgets(line, sizeof(line), file)){
+        number++;
+        unsigned long time;
+        char input[16];
+        unsigned int direction = 0;
+        char blank;
+        if (line[0] == '#' || sscanf(line, " %c", &blank) < 1)
+            continue;
+        const int fields = sscanf(line, "%lu %15s %u", &time, input, &direction);
+        if (fields < 2 || time > UINT32_MAX){
+            fprintf(stderr, "%s:%u: expected \"<time> <input>\", got \"%s\"\n", path, number, strtok(line, "\r\n"));
+            valid = false;
+            continue;
+        }
+        if (!strcmp(input, "direction") && fields < 3){
+            fprintf(stderr, "%s:%u: a direction needs its angle in degrees\n", path, number);
+            valid = false;
+            continue;
+        }
+        ReplayEvent event{static_cast<uint32_t>(time), ReplayInput::Click, static_cast<uint16_t>(direction)};
+        if (!strcmp(input, "direction"))
+            event.input = ReplayInput::Direction;
+        else if (!strcmp(input, "back"))
+            event.input = ReplayInput::Back;
+        else if (strcmp(input, "click")){
+            fprintf(stderr, "%s:%u: unknown input \"%s\"\n", path, number, input);
+            valid = false;
+        }
+        if (!events.empty() && events.back().time > event.time){
+            fprintf(stderr, "%s:%u: the inputs must be sorted by time\n", path, number);
+            valid = false;
+        }
+        events.push_back(event);
+    }
+    fclose(file);
+    return valid;
+}
+
+//A golden file has a line per frame with its time and hash, as written by --update
+static std::vector<ReplayFrame> readGolden(const char* path){
+    std::vector<ReplayFrame> golden;
+    FILE* file = fopen(path, "r");
+    if (!file){
+        perror(path);
+        return golden;
+    }
+    char line[64];
+    ReplayFrame frame{};
+    while (fgets(line, sizeof(line), file)){
+        if (line[0] != '#' && sscanf(line, "%u %x", &frame.time, &frame.hash) == 2)
+            golden.push_back(frame);
+    }
+    fclose(file);
+    return golden;
+}
+
+int main(int argc, char** argv){
+    if (argc < 2){
+        fprintf(stderr, "usage: %s <script> [golden] [--update]\n", argv[0]);
+        return 2;
+    }
+    std::vector<ReplayEvent> events;
+    if (!readScript(argv[1], events))
+        return 2;
+
+    //The scenes of src/main.cpp, without the script of the test scene that draws on the canvas directly
+    GFXcanvas16 canvas(128, 64);
+    DemoScenes demo;
+    UI ui(&demo.home, &canvas);
+    demo.attach(ui, [&](){ ui.FocusScene(&demo.test); });
+
+    Replay replay(&ui, events.data(), events.size(), FPS60);
+    std::vector<ReplayFrame> frames((events.empty() ? 0 : events.back().time) / FPS60 + 500000U / FPS60 + 2);
+    frames.resize(replay.run(frames.data(), frames.size()));
+    if (argc < 3){
+        Replay::print(frames.data(), frames.size());
+        return 0;
+    }
+
+    if (argc > 3 && !strcmp(argv[3], "--update")){
+        FILE* file = fopen(argv[2], "w");
+        if (!file){
+            perror(argv[2]);
+            return 2;
+        }
+        fprintf(file, "# Golden frames of %s: time in microseconds and hash of the canvas\n", argv[1]);
+        for (const ReplayFrame& frame : frames)
+            fprintf(file, "%u %08x\n", static_cast<unsigned int>(frame.time), static_cast<unsigned int>(frame.hash));
+        fclose(file);
+        printf("%zu frames written to %s\n", frames.size(), argv[2]);
+        return 0;
+    }
+
+    const std::vector<ReplayFrame> golden = readGolden(argv[2]);
+    std::vector<uint32_t> hashes;
+    for (const ReplayFrame& frame : golden)
+        hashes.push_back(frame.hash);
+    uint32_t total = 0, slowest = 0;
+    for (const ReplayFrame& frame : frames){
+        total += frame.render_time;
+        slowest = std::max(slowest, frame.render_time);
+    }
+    const int differs = Replay::compare(frames.data(), hashes.data(), std::min(frames.size(), hashes.size()));
+    if (differs >= 0)
+        printf("Frame %d at %uus differs: %08x instead of %08x\n", differs, static_cast<unsigned int>(frames[differs].time),
+               static_cast<unsigned int>(frames[differs].hash), static_cast<unsigned int>(hashes[differs]));
+    else if (frames.size() != hashes.size())
+        printf("%zu frames rendered, the golden file has %zu\n", frames.size(), hashes.size());
+    else
+        printf("%zu frames match\n", frames.size());
+    printf("Render time: %uus per frame, %uus at most\n", static_cast<unsigned int>(frames.empty() ? 0 : total / frames.size()),
+           static_cast<unsigned int>(slowest));
+    return differs >= 0 || frames.size() != hashes.size() ? 1 : 0;
+}
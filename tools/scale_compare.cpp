@@ -0,0 +1,94 @@
+/*
+  Host comparison of nearest neighbor scale() with the float implementation it replaced, which sampled the source pixel
+  static_cast<unsigned int>(dst * (1.0f / factor)) for every scaled pixel. It prints a CSV line per format and factor: how long both take,
+  how many scaled pixels sample a different source pixel and the largest distance between the two, in source pixels. The table driven path
+  walks a 16.16 step rounded up, at factors whose inverse isn't exact in 16.16 a few columns or rows land on the neighboring source pixel.
+
+  Build:  tools/host/build.sh tools/scale_compare.cpp scale_compare
+  Usage:  scale_compare [runs]      100 runs by default. The exit status is 1 if a pixel is more than one source pixel away
+*/
+#include "SimpleUI.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+static constexpr unsigned int SIZE = 64;
+
+//The float path as it was, both formats. The source pixel of every scaled one is returned through sources, for the comparison
+static void floatScale(const Texture& input, float factor, std::vector<uint16_t>& out, std::vector<unsigned int>& sources){
+    const unsigned int scaled_width = static_cast<unsigned int>(input.width * factor);
+    const unsigned int scaled_height = static_cast<unsigned int>(input.height * factor);
+    const float inv_scaling = 1.0f / factor;
+    const int in_row_bytes = (input.width + 7) / 8;
+    out.assign(static_cast<size_t>(scaled_width) * scaled_height, 0);
+    sources.assign(out.size() * 2, 0);
+    for (unsigned int y = 0; y < scaled_height; y++){
+        const unsigned int src_y = static_cast<unsigned int>(y * inv_scaling);
+        for (unsigned int x = 0; x < scaled_width; x++){
+            const unsigned int src_x = static_cast<unsigned int>(x * inv_scaling);
+            const size_t i = y * scaled_width + x;
+            if (input.data.colorspace == PixelType::Mono)
+                out[i] = (input.data.mono[src_y * in_row_bytes + src_x / 8] & (0x80 >> (src_x % 8))) ? 0xFFFF : 0;
+            else
+                out[i] = input.data.rgb565[src_y * input.width + src_x];
+            sources[i * 2] = src_x;
+            sources[i * 2 + 1] = src_y;
+        }
+    }
+}
+
+static uint16_t pixelAt(const Texture& texture, unsigned int x, unsigned int y){
+    if (texture.data.colorspace == PixelType::Mono)
+        return (texture.data.mono[y * ((texture.width + 7) / 8) + x / 8] & (0x80 >> (x % 8))) ? 0xFFFF : 0;
+    return texture.data.rgb565[y * texture.width + x];
+}
+
+template<typename F>
+static double time(unsigned int runs, F&& run){
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < runs; i++)
+        run();
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / runs;
+}
+
+int main(int argc, char** argv){
+    const unsigned int runs = argc > 1 ? std::max(1ul, strtoul(argv[1], nullptr, 10)) : 100;
+    //Every pixel of the sources has its own color, so a pixel sampled from the wrong place can't go unnoticed
+    static uint16_t colors[SIZE * SIZE];
+    static uint8_t bits[SIZE / 8 * SIZE];
+    for (unsigned int i = 0; i < SIZE * SIZE; i++){
+        colors[i] = static_cast<uint16_t>(i);
+        if ((i * 2654435761u) >> 31)
+            bits[i / 8] |= 0x80 >> (i % 8);
+    }
+    Texture sources[] = {Texture(SIZE, SIZE, colors), Texture(SIZE, SIZE, bits)};
+    static const float factors[] = {0.3f, 0.5f, 0.7f, 0.8f, 1.3f, 1.5f, 1.7f, 2.0f, 2.3f, 3.0f, 3.1f};
+
+    printf("format,factor,float_us,table_us,different,max_offset\n");
+    int far = 0;
+    std::vector<uint16_t> reference;
+    std::vector<unsigned int> reference_sources;
+    for (Texture& source : sources){
+        const bool mono = source.data.colorspace == PixelType::Mono;
+        for (const float factor : factors){
+            const double float_time = time(runs, [&]{ floatScale(source, factor, reference, reference_sources); });
+            const double table_time = time(runs, [&]{ scale(source, factor); });
+            const Texture scaled = scale(source, factor);
+            const ScaleStep step(factor);
+            unsigned int different = 0, max_offset = 0;
+            for (unsigned int y = 0; y < scaled.height; y++){
+                for (unsigned int x = 0; x < scaled.width; x++){
+                    const size_t i = y * scaled.width + x;
+                    different += pixelAt(scaled, x, y) != reference[i];
+                    const unsigned int src_x = std::min(step.source(x), source.width - 1);
+                    const unsigned int src_y = std::min(step.source(y), source.height - 1);
+                    max_offset = std::max({max_offset, static_cast<unsigned int>(abs(static_cast<int>(src_x - reference_sources[i * 2]))),
+                                           static_cast<unsigned int>(abs(static_cast<int>(src_y - reference_sources[i * 2 + 1])))});
+                }
+            }
+            far |= max_offset > 1;
+            printf("%s,%.1f,%.2f,%.2f,%u,%u\n", mono ? "Mono" : "RGB565", factor, float_time, table_time, different, max_offset);
+        }
+    }
+    return far;
+}
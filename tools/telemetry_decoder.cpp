@@ -0,0 +1,144 @@
+/*
+  Host side of the telemetry sent by the "telemetry" serial command. It reads the records from a serial port, a pipe or stdin and
+  writes one CSV file per kind of record, or prints every record as a line of JSON.
+
+  Build:  g++ -std=c++17 -O2 -I lib/SimpleUI/deps -I lib/SimpleUI/deps/Telemetry tools/telemetry_decoder.cpp lib/SimpleUI/deps/Telemetry/Telemetry.cpp -o telemetry_decoder
+  Usage:  telemetry_decoder <input|-> [output directory | --json]
+          stty -F /dev/ttyUSB0 115200 raw && telemetry_decoder /dev/ttyUSB0 logs
+          nc -l 5555 | telemetry_decoder - --json
+*/
+#include "Telemetry.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace SimpleUI;
+
+struct Output{
+    bool json = false;
+    FILE* frames = nullptr;
+    FILE* heap = nullptr;
+    FILE* profile = nullptr;
+    FILE* focus = nullptr;
+    FILE* animations = nullptr;
+    std::unordered_map<uint16_t, std::string> sites;
+    uint32_t frame = 0;     //Last frame seen, the slow records are stamped with it
+    uint32_t records = 0;
+};
+
+static FILE* openCSV(const std::string& path, const char* header){
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file){
+        perror(path.c_str());
+        return nullptr;
+    }
+    fprintf(file, "%s\n", header);
+    return file;
+}
+
+static const char* siteName(Output& out, uint16_t id){
+    const auto site = out.sites.find(id);
+    return site != out.sites.end() ? site->second.c_str() : "?";
+}
+
+static void onRecord(const TelemetryRecord& record, void* context){
+    Output& out = *static_cast<Output*>(context);
+    out.records++;
+    switch (record.type){
+        case TelemetryType::Frame:{
+            const FrameRecord& r = record.frame;
+            out.frame = r.frame;
+            if (out.json)
+                printf("{\"type\":\"frame\",\"frame\":%u,\"time\":%u,\"interval\":%u,\"render\":%u}\n", r.frame, r.time, r.interval, r.render);
+            else if (out.frames)
+                fprintf(out.frames, "%u,%u,%u,%u\n", r.frame, r.time, r.interval, r.render);
+            break;
+        }
+        case TelemetryType::Heap:{
+            const HeapRecord& r = record.heap;
+            if (out.json)
+                printf("{\"type\":\"heap\",\"frame\":%u,\"free\":%u,\"min_free\":%u,\"largest_block\":%u,\"arena_peak\":%u}\n",
+                       out.frame, r.free, r.min_free, r.largest_block, r.arena_peak);
+            else if (out.heap)
+                fprintf(out.heap, "%u,%u,%u,%u,%u\n", out.frame, r.free, r.min_free, r.largest_block, r.arena_peak);
+            break;
+        }
+        case TelemetryType::Site:
+            out.sites[record.site.id] = record.site.name;
+            break;
+        case TelemetryType::Profile:{
+            const ProfileRecord& r = record.profile;
+            //Site names are plain identifiers and paths, nothing that needs escaping
+            if (out.json)
+                printf("{\"type\":\"profile\",\"frame\":%u,\"site\":\"%s\",\"max_time\":%u}\n", out.frame, siteName(out, r.id), r.max_time);
+            else if (out.profile)
+                fprintf(out.profile, "%u,\"%s\",%u\n", out.frame, siteName(out, r.id), r.max_time);
+            break;
+        }
+        case TelemetryType::Focus:{
+            const FocusRecord& r = record.focus;
+            const bool gliding = r.flags & FocusRecord::GLIDING, transitioning = r.flags & FocusRecord::TRANSITIONING, pending = r.flags & FocusRecord::PENDING;
+            if (out.json)
+                printf("{\"type\":\"focus\",\"frame\":%u,\"element\":%u,\"scene\":%u,\"gliding\":%s,\"transitioning\":%s,\"pending\":%s}\n", r.frame, r.element,
+                       r.scene, gliding ? "true" : "false", transitioning ? "true" : "false", pending ? "true" : "false");
+            else if (out.focus)
+                fprintf(out.focus, "%u,%u,%u,%d,%d,%d\n", r.frame, r.element, r.scene, gliding, transitioning, pending);
+            break;
+        }
+        case TelemetryType::Animations:{
+            const AnimationRecord& r = record.animations;
+            if (out.json)
+                printf("{\"type\":\"animations\",\"frame\":%u,\"used\":%u,\"overflows\":%u,\"running\":%u,\"dirty\":%u,\"state\":%d,\"progress\":%.4f}\n",
+                       out.frame, r.used, r.overflows, r.running, r.dirty, r.state == 0xFF ? -1 : r.state, r.progress);
+            else if (out.animations)
+                fprintf(out.animations, "%u,%u,%u,%u,%u,%d,%.4f\n", out.frame, r.used, r.overflows, r.running, r.dirty, r.state == 0xFF ? -1 : r.state, r.progress);
+            break;
+        }
+    }
+}
+
+int main(int argc, char** argv){
+    if (argc < 2){
+        fprintf(stderr, "usage: %s <input|-> [output directory | --json]\n", argv[0]);
+        return 1;
+    }
+    Output out;
+    out.json = argc > 2 && !strcmp(argv[2], "--json");
+    if (!out.json){
+        const std::string directory = argc > 2 ? argv[2] : ".";
+        out.frames = openCSV(directory + "/frames.csv", "frame,time_us,interval_us,render_us");
+        out.heap = openCSV(directory + "/heap.csv", "frame,free,min_free,largest_block,arena_peak");
+        out.profile = openCSV(directory + "/profile.csv", "frame,site,max_time_us");
+        out.focus = openCSV(directory + "/focus.csv", "frame,element,scene,gliding,transitioning,pending");
+        out.animations = openCSV(directory + "/animations.csv", "frame,used,overflows,running,dirty,state,progress");
+        if (!out.frames || !out.heap || !out.profile || !out.focus || !out.animations)
+            return 1;
+    }
+
+    const int fd = strcmp(argv[1], "-") ? open(argv[1], O_RDONLY) : STDIN_FILENO;
+    if (fd < 0){
+        perror(argv[1]);
+        return 1;
+    }
+    TelemetryDecoder decoder;
+    decoder.onRecord(onRecord, &out);
+    uint8_t buffer[4096];
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0){
+        decoder.feed(buffer, static_cast<size_t>(length));
+        //Flushed as it goes so the files can be followed while the device runs
+        for (FILE* file : {out.frames, out.heap, out.profile, out.focus, out.animations})
+            if (file)
+                fflush(file);
+        fflush(stdout);
+    }
+    fprintf(stderr, "%u records, %u dropped, %u of unknown types\n", static_cast<unsigned int>(out.records),
+            static_cast<unsigned int>(decoder.getErrors()), static_cast<unsigned int>(decoder.getSkipped()));
+    for (FILE* file : {out.frames, out.heap, out.profile, out.focus, out.animations})
+        if (file)
+            fclose(file);
+    return 0;
+}
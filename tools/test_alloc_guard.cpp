@@ -0,0 +1,73 @@
+/*
+  Host test of the allocation guard. The frames right after an input may allocate, once the UI has settled a single heap allocation
+  during a frame must trip the guard's assert. Every case runs in a child process so that the abort can be observed.
+
+  Build:  tools/host/build.sh tools/test_alloc_guard.cpp test_alloc_guard -DSIMPLEUI_ALLOC_GUARD=1
+  Run:    ./test_alloc_guard, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+#include <sys/wait.h>
+#include <unistd.h>
+#if !SIMPLEUI_ALLOC_GUARD
+  #error "Build with -DSIMPLEUI_ALLOC_GUARD=1"
+#endif
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+static int* volatile sink;
+
+/*!
+  @brief Render a scene whose script allocates in a single frame, followed by more steady frames
+  @param settled    How many frames are rendered after the input before the one that allocates
+  @param allocates  False to render the same frames without allocating
+  @return True if the guard aborted the process
+*/
+static bool allocatesAfter(int settled, bool allocates = true){
+    fflush(stdout);
+    const pid_t child = fork();
+    if (!child){
+        freopen("/dev/null", "w", stderr);     //The assert message is expected
+        GFXcanvas16 canvas(64, 64);
+        Checkbox a({4, 4}, false, 10, 10), b({24, 4}, false, 10, 10);
+        Scene scene({&a, &b}, &a);
+        UI ui(&scene, &canvas);
+        VirtualClock clock(1000);
+        ui.setClock(&clock);
+        bool allocate = false;
+        scene.Script([&](){
+            if (allocate){
+                sink = new int(1);
+                delete sink;
+            }
+        });
+        for (int i = 0; i < 10; i++){
+            clock.advance(16667);
+            ui.Render();
+        }
+        ui.FocusDirection(Direction::Right);
+        for (int frame = 0; frame <= settled + 10; frame++){
+            allocate = allocates && frame == settled;
+            clock.advance(16667);
+            ui.Render();
+        }
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+int main(){
+    CHECK(!allocatesAfter(20, false));
+    //The frame that resolves the input and the ones that follow it are still settling
+    CHECK(!allocatesAfter(0));
+    CHECK(!allocatesAfter(1));
+    //Past them a steady state frame that allocates is caught
+    CHECK(allocatesAfter(4));
+    CHECK(allocatesAfter(20));
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
@@ -0,0 +1,170 @@
+/*
+  Host test of the animation modes and the damage queries built on them. An animation with a fixed timestep must take the value the
+  continuous one has at the start of the current step whenever its frames come, and a late frame must only catch up the steps it's allowed
+  to. One with a threshold must only publish changes at least that large and its last value, and be dirty in exactly those updates, while
+  reading as running in the ones it holds back. The damage queries of the UI must resolve the queued focus moves before advancing time.
+
+  Build:  tools/host/build.sh tools/test_animation.cpp test_animation
+  Run:    ./test_animation, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+//The value a continuous animation has after running for the given time, evaluated in a store of its own
+static float valueAt(float start, float end, unsigned int length, float factor, uint32_t elapsed){
+    static AnimationStore store;
+    AnimationStore::Scope scope(store);
+    Animation reference(start, end, length, factor);
+    store.setTime(0);
+    reference.Start();
+    store.setTime(elapsed);
+    reference.Update();
+    return reference.getProgress();
+}
+
+static void testFixedStep(){
+    static constexpr uint32_t STEP = 10000;
+    AnimationStore store;
+    AnimationStore::Scope scope(store);
+    Animation stepped(0.0f, 100.0f, 1000U, 2.0f);
+    stepped.setFixedStep(STEP);
+    store.setTime(0);
+    stepped.Start();
+
+    //Frames at uneven intervals all land on the value of the last whole step
+    float last = stepped.getProgress();
+    int dirty = 0;
+    for (uint64_t now = 1000; now <= 1100000; now += 7000 + (now * 3919) % 9000){
+        store.update(now);
+        const uint32_t step_start = static_cast<uint32_t>(std::min<uint64_t>(now - now % STEP, 1000000));
+        CHECK(stepped.getProgress() == valueAt(0.0f, 100.0f, 1000U, 2.0f, step_start));
+        CHECK(stepped.isDirty() == (stepped.getProgress() != last));
+        dirty += stepped.isDirty();
+        last = stepped.getProgress();
+    }
+    CHECK(dirty > 0 && dirty <= 100);
+    CHECK(stepped.getProgress() == 100.0f && stepped.getState() == AnimState::Finished);
+
+    //After a late frame only two steps are caught up, the rest of the timeline is pushed back by the time that was skipped
+    Animation late(0.0f, 100.0f, 1000U, 1.0f);
+    late.setFixedStep(STEP, 2);
+    store.setTime(2000000);
+    late.Start();
+    store.update(2010000);
+    CHECK(late.getProgress() == valueAt(0.0f, 100.0f, 1000U, 1.0f, STEP));
+    store.update(2200000);
+    CHECK(late.getProgress() == valueAt(0.0f, 100.0f, 1000U, 1.0f, 3 * STEP));
+    store.update(2215000);
+    CHECK(late.getProgress() == valueAt(0.0f, 100.0f, 1000U, 1.0f, 4 * STEP));
+    //Steady frames from there on finish it the 170ms it lost late
+    for (uint64_t now = 2225000; now < 3170000; now += STEP){
+        store.update(now);
+        CHECK(late.getState() == AnimState::Running);
+    }
+    store.update(3170000);
+    CHECK(late.getProgress() == 100.0f && late.getState() == AnimState::Finished);
+}
+
+static void testThreshold(){
+    AnimationStore store;
+    AnimationStore::Scope scope(store);
+    Animation coarse(0.0f, 100.0f, 1000U, 1.5f), fine(0.0f, 100.0f, 1000U, 1.5f);
+    coarse.setThreshold(10.0f);
+    store.setTime(0);
+    coarse.Start();
+    fine.Start();
+    CHECK(coarse.getState() == AnimState::Start && fine.getState() == AnimState::Start);
+
+    float last = 0.0f;
+    int coarse_dirty = 0, fine_dirty = 0;
+    for (uint64_t now = 1000; now <= 1000000; now += 1000){
+        store.update(now);
+        const float value = coarse.getProgress();
+        CHECK(coarse.isDirty() == (value != last));
+        if (value != last && value != 100.0f)
+            CHECK(value - last >= 10.0f);
+        //A value held back at its start is still a running animation, AnimatedApp flips it rather than resuming it on a focus change
+        if (now < 1000000)
+            CHECK(coarse.getState() == AnimState::Running);
+        coarse_dirty += coarse.isDirty();
+        fine_dirty += fine.isDirty();
+        last = value;
+    }
+    CHECK(coarse.getProgress() == 100.0f && coarse.getState() == AnimState::Finished);
+    CHECK(coarse_dirty >= 2 && coarse_dirty <= 11);
+    CHECK(fine_dirty > 900);
+    //Once finished nothing changes anymore
+    store.update(1001000);
+    CHECK(!coarse.isDirty() && !fine.isDirty());
+}
+
+static uint8_t pixels[32 * 32 / 8];
+
+static void testDamage(){
+    GFXcanvas16 canvas(128, 64);
+    Texture small(16, 16, pixels), big(32, 32, pixels);
+    Checkbox left({4, 20}, false, 10, 10, Outline(1, 0, 2, 0xFFFF), 0xFFFF);
+    Checkbox right({30, 20}, false, 10, 10, Outline(1, 0, 2, 0xFFFF), 0xFFFF);
+    AnimatedApp app({70, 16}, false, &small, &big, Constraint::Center, 100U, 2.0f);
+    Scene scene({&left, &right, &app}, &left);
+    scene.settings.focus.glide_duration = 80;
+    UI ui(&scene, &canvas);
+    VirtualClock clock(1000);
+    ui.setClock(&clock);
+    for (int i = 0; i < 10; i++){
+        clock.advance(16667);
+        ui.Render();
+    }
+    CHECK(ui.getFocusDamage().isEmpty() && ui.getAnimationDamage().isEmpty());
+    ui.Render();
+
+    //A move queued for the next frame is resolved by the damage query, its glide is part of the damage
+    CHECK(ui.FocusDirection(Direction::Right));
+    clock.advance(16667);
+    CHECK(ui.getFocusDamage().intersects(left.getBounds()));
+    CHECK(ui.getFocused() == &right && ui.isFocusGliding());
+    ui.Render();
+    bool reached = false;
+    while (ui.isFocusGliding()){
+        clock.advance(16667);
+        reached = ui.getFocusDamage().intersects(right.getBounds());
+        ui.Render();
+    }
+    CHECK(reached);
+
+    //The app grows once focused, each frame it's dirty in covers its old and new size, and once it has grown nothing is left to redraw
+    CHECK(ui.FocusDirection(Direction::Right));
+    clock.advance(16667);
+    ui.getAnimationDamage();
+    CHECK(ui.getFocused() == &app);
+    ui.Render();
+    int changed = 0, width = 0;
+    for (int i = 0; i < 20; i++){
+        clock.advance(16667);
+        const Rect damage = ui.getAnimationDamage();
+        CHECK(damage.isEmpty() == !app.hasAnimationChanged());
+        if (!damage.isEmpty()){
+            CHECK(damage.x <= app.getPos().x && damage.x + damage.w >= app.getPos().x + 16 && damage.w >= width);
+            width = damage.w;
+            changed++;
+        }
+        ui.Render();
+    }
+    CHECK(changed > 1 && width == 32);
+    CHECK(app.getActive() == &big);
+    clock.advance(16667);
+    CHECK(ui.getAnimationDamage().isEmpty());
+    ui.Render();
+}
+
+int main(){
+    testFixedStep();
+    testThreshold();
+    testDamage();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
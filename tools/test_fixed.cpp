@@ -0,0 +1,65 @@
+/*
+  Host test of fixed point positions. Coordinates anywhere in the range of a Point must survive the trip through Fixed, an element moved
+  a sixteenth of a pixel at a time must land on the pixel the float math rounds to, and the fixed point value of an animation must be its
+  float value rounded to a sixteenth.
+
+  Build:  tools/host/build.sh tools/test_fixed.cpp test_fixed
+  Run:    ./test_fixed, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+static void testRange(){
+    for (const int value : {0, 1, -1, 2047, 2048, 3000, 32767, -32768}){
+        CHECK(Fixed(value).round() == value);
+        CHECK(Fixed(value).floor() == value);
+        CHECK((Fixed(value) + Fixed(value)).round() == 2 * value);
+    }
+    CHECK(Fixed::fromFloat(2500.5f).round() == 2501);
+    CHECK((Fixed(3000) * Fixed::fromFloat(0.5f)).round() == 1500);
+
+    UIElement element;
+    element.setPosX(3000);
+    element.setPosY(2100);
+    CHECK(element.getPos().x == 3000 && element.getPos().y == 2100);
+}
+
+static void testSubPixel(){
+    UIElement element;
+    FixedPoint pos(Point(100, 7));
+    for (int step = 0; step < 64; step++){
+        element.setSubPos(pos);
+        const float x = 100.0f + step / 16.0f;
+        CHECK(element.getPos().x == static_cast<int>(floorf(x + 0.5f)));
+        CHECK(element.getSubPos() == pos);
+        pos = pos + FixedPoint(Fixed::fromRaw(1), Fixed());
+    }
+}
+
+static void testAnimation(){
+    AnimationStore store;
+    AnimationStore::Scope scope(store);
+    Animation motion(-20.0f, 300.0f, 1000U, 2.0f);
+    store.setTime(0);
+    motion.Start();
+    for (uint64_t now = 0; now <= 1000000; now += 12345){
+        store.update(now);
+        CHECK(Fixed::of(motion).raw == lroundf(motion.getProgress() * Fixed::ONE));
+    }
+    store.update(2000000);
+    CHECK(Fixed::of(motion) == Fixed(300));
+    motion.Reset();
+    CHECK(Fixed::of(motion) == Fixed(-20));
+}
+
+int main(){
+    testRange();
+    testSubPixel();
+    testAnimation();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
@@ -0,0 +1,141 @@
+/*
+  Host test of the framebuffer stream. Every frame the decoder completes must be the framebuffer that was sent, whatever the chunks the
+  bytes arrive in and whatever text is printed between the frames. A frame the transport cuts short, in its tiles or in its header, must
+  be dropped and the keyframe sent right after it must be decoded, as must the one asked for with requestKeyframe().
+
+  Build:  tools/host/build.sh tools/test_framestream.cpp test_framestream
+  Run:    ./test_framestream, the exit status is the number of failed checks
+*/
+#include "FrameStream.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+static constexpr uint16_t WIDTH = 70, HEIGHT = 40;
+
+//Keeps what was written, and once told to cut a frame short accepts only that many more bytes of it
+struct MemorySink : ByteSink{
+    std::vector<uint8_t> bytes;
+    size_t budget = SIZE_MAX;
+    size_t write(const uint8_t* data, size_t length) override {
+        const size_t accepted = length < budget ? length : budget;
+        bytes.insert(bytes.end(), data, data + accepted);
+        budget -= budget == SIZE_MAX ? 0 : accepted;
+        return accepted;
+    }
+};
+
+struct Received{
+    std::vector<uint32_t> frames;
+    std::vector<std::vector<uint16_t>> pixels;
+};
+
+static void onFrame(const FrameStreamDecoder& decoder, void* context){
+    Received& received = *static_cast<Received*>(context);
+    received.frames.push_back(decoder.getFrame());
+    received.pixels.emplace_back(decoder.getPixels(), decoder.getPixels() + WIDTH * HEIGHT);
+}
+
+//A background with a square that moves a little every frame, so the deltas only hold a few tiles
+static void paint(std::vector<uint16_t>& pixels, uint32_t frame){
+    for (uint16_t y = 0; y < HEIGHT; y++)
+        for (uint16_t x = 0; x < WIDTH; x++)
+            pixels[y * WIDTH + x] = static_cast<uint16_t>((x / 8) * 0x0841 + y);
+    const uint16_t left = (frame * 3) % (WIDTH - 10);
+    for (uint16_t y = 12; y < 22; y++)
+        for (uint16_t x = left; x < left + 10; x++)
+            pixels[y * WIDTH + x] = static_cast<uint16_t>(0xF800 ^ (x * 31 + y * frame));
+}
+
+static void feed(FrameStreamDecoder& decoder, const std::vector<uint8_t>& bytes, size_t chunk){
+    for (size_t at = 0; at < bytes.size(); at += chunk)
+        decoder.feed(bytes.data() + at, std::min(chunk, bytes.size() - at));
+}
+
+static void testRoundTrip(){
+    static const char text[] = "SimpleUI: SUI is not a frame\n";
+    for (const size_t chunk : {size_t(1), size_t(7), size_t(4096)}){
+        MemorySink sink;
+        FrameStreamer streamer(&sink, WIDTH, HEIGHT);
+        std::vector<std::vector<uint16_t>> sent;
+        std::vector<uint16_t> pixels(WIDTH * HEIGHT);
+        for (uint32_t frame = 0; frame < 8; frame++){
+            paint(pixels, frame);
+            CHECK(streamer.send(pixels.data()) > 0);
+            sent.push_back(pixels);
+            sink.bytes.insert(sink.bytes.end(), text, text + sizeof(text) - 1);
+        }
+        FrameStreamDecoder decoder;
+        Received received;
+        decoder.onFrame(onFrame, &received);
+        feed(decoder, sink.bytes, chunk);
+        CHECK(received.frames.size() == sent.size() && decoder.getErrors() == 0);
+        for (size_t i = 0; i < received.frames.size() && i < sent.size(); i++)
+            CHECK(received.frames[i] == i && received.pixels[i] == sent[i]);
+        CHECK(decoder.getFrameTiles() < streamer.getTileCount());
+    }
+}
+
+//The frame at index 2 is cut after the given number of bytes, the keyframe that follows it must be decoded
+static void testTruncated(size_t cut){
+    for (const size_t chunk : {size_t(1), size_t(64), size_t(4096)}){
+        MemorySink sink;
+        FrameStreamer streamer(&sink, WIDTH, HEIGHT);
+        std::vector<std::vector<uint16_t>> sent;
+        std::vector<uint16_t> pixels(WIDTH * HEIGHT);
+        for (uint32_t frame = 0; frame < 6; frame++){
+            paint(pixels, frame);
+            sink.budget = frame == 2 ? cut : SIZE_MAX;
+            const size_t size = streamer.send(pixels.data());
+            CHECK((size == 0) == (frame == 2));
+            sent.push_back(pixels);
+        }
+        FrameStreamDecoder decoder;
+        Received received;
+        decoder.onFrame(onFrame, &received);
+        feed(decoder, sink.bytes, chunk);
+        CHECK(decoder.getErrors() >= 1);
+        CHECK((received.frames == std::vector<uint32_t>{0, 1, 3, 4, 5}));
+        for (size_t i = 0; i < received.frames.size(); i++)
+            CHECK(received.pixels[i] == sent[received.frames[i]]);
+    }
+}
+
+static void testRequestKeyframe(){
+    MemorySink sink;
+    FrameStreamer streamer(&sink, WIDTH, HEIGHT);
+    FrameStreamDecoder decoder;
+    std::vector<uint16_t> pixels(WIDTH * HEIGHT);
+    paint(pixels, 0);
+    streamer.send(pixels.data());
+    streamer.send(pixels.data());
+    feed(decoder, sink.bytes, sink.bytes.size());
+    CHECK(decoder.getFrame() == 1 && decoder.getFrameTiles() == 0);
+
+    //A viewer that joins now only has the keyframe asked for to start from
+    sink.bytes.clear();
+    streamer.requestKeyframe();
+    streamer.send(pixels.data());
+    streamer.send(pixels.data());
+    FrameStreamDecoder late;
+    Received received;
+    late.onFrame(onFrame, &received);
+    feed(late, sink.bytes, sink.bytes.size());
+    CHECK((received.frames == std::vector<uint32_t>{2, 3}));
+    CHECK(!received.pixels.empty() && received.pixels[0] == pixels);
+}
+
+int main(){
+    testRoundTrip();
+    testTruncated(300);     //In the middle of a tile
+    testTruncated(10);      //In the middle of the header
+    testTruncated(FrameStreamFormat::HEADER_SIZE + 2);     //Between the header and the first tile
+    testRequestKeyframe();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
@@ -0,0 +1,77 @@
+/*
+  Host test of Label. The glyphs the atlas rasterizes must light up the same pixels GFX print does at every size, and a label only
+  draws inside the damaged region of the frame, the rest of the canvas keeps what was there.
+
+  Build:  tools/host/build.sh tools/test_label.cpp test_label
+  Run:    ./test_label, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+static constexpr uint16_t BACKGROUND = 0x1234;
+static const char TEXT[] = "Ab3!~";
+
+static void fill(GFXcanvas16& canvas){
+    for (int i = 0; i < canvas.width() * canvas.height(); i++)
+        canvas.getBuffer()[i] = BACKGROUND;
+}
+
+static void testPrint(){
+    const GlyphAtlas atlas;
+    for (const uint8_t size : {1, 2, 3}){
+        GFXcanvas16 canvas(128, 64), printed(128, 64);
+        Label label({5, 7}, false, &atlas, 0xF81F, size);
+        label.setText(TEXT);
+        Scene scene({&label});
+        UI ui(&scene, &canvas);
+        fill(canvas);
+        ui.Render();
+
+        fill(printed);
+        printed.setTextSize(size);
+        printed.setTextColor(0xF81F);
+        printed.setCursor(5, 7);
+        printed.print(TEXT);
+        CHECK(!memcmp(canvas.getBuffer(), printed.getBuffer(), 128 * 64 * sizeof(uint16_t)));
+    }
+}
+
+static void testClip(){
+    const GlyphAtlas atlas;
+    GFXcanvas16 canvas(128, 64), full(128, 64);
+    Label label({0, 0}, false, &atlas, 0xFFFF, 2);
+    label.setText(TEXT);
+    Scene scene({&label});
+    UI ui(&scene, &full);
+    fill(full);
+    ui.Render();
+
+    UI clipped(&scene, &canvas);
+    const Rect damage(7, 3, 20, 6);
+    fill(canvas);
+    clipped.setDamage(damage);
+    clipped.Render();
+    int outside = 0, inside = 0;
+    for (int y = 0; y < 64; y++){
+        for (int x = 0; x < 128; x++){
+            const uint16_t pixel = canvas.getBuffer()[y * 128 + x];
+            if (x >= damage.x && x < damage.x + damage.w && y >= damage.y && y < damage.y + damage.h)
+                inside += pixel == full.getBuffer()[y * 128 + x] && pixel != BACKGROUND;
+            else
+                outside += pixel != BACKGROUND;
+        }
+    }
+    CHECK(inside > 0);
+    CHECK(outside == 0);
+}
+
+int main(){
+    testPrint();
+    testClip();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
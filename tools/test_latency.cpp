@@ -0,0 +1,128 @@
+/*
+  Host test of the input-to-photon latency profiler. Inputs are stamped through a VirtualClock so every stage takes a known time,
+  then the histogram buckets, the percentiles and the handling of inputs that arrive while one is pending are checked.
+
+  Build:  tools/host/build.sh tools/test_latency.cpp test_latency -DLATENCY_PROFILING=1
+  Run:    ./test_latency, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+#if !LATENCY_PROFILING
+  #error "Build with -DLATENCY_PROFILING=1"
+#endif
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+//Bucket i of the histogram holds [2^i, 2^(i+1)), 0 goes in the first one
+static uint8_t bucketOf(uint32_t time){
+    uint8_t bucket = 0;
+    while (bucket < LatencyHistogram::BUCKETS - 1 && (time >> (bucket + 1)))
+        bucket++;
+    return bucket;
+}
+
+static void testHistogram(){
+    LatencyHistogram histogram;
+    CHECK(histogram.percentile(0.5f) == 0);
+    const uint32_t times[] = {0, 1, 2, 3, 255, 256, 1000, 5000, 5000, 200000};
+    for (uint32_t time : times)
+        histogram.add(time);
+    CHECK(histogram.count == 10);
+    CHECK(histogram.max == 200000);
+    CHECK(histogram.mean() == 211517 / 10);
+    CHECK(histogram.buckets[0] == 2);   //0 and 1
+    CHECK(histogram.buckets[1] == 2);   //2 and 3
+    CHECK(histogram.buckets[7] == 1);   //255
+    CHECK(histogram.buckets[8] == 1);   //256
+    CHECK(histogram.buckets[9] == 1);   //1000
+    CHECK(histogram.buckets[12] == 2);  //5000 twice
+    CHECK(histogram.buckets[17] == 1);  //200000
+    //The 5th value is 255, the median is reported as the upper bound of its bucket
+    CHECK(histogram.percentile(0.5f) == 255);
+    CHECK(histogram.percentile(0.9f) == 8191);
+    CHECK(histogram.percentile(1.0f) == 200000);
+    //Values past the last bucket are clamped into it
+    histogram.add(UINT32_MAX);
+    CHECK(histogram.buckets[LatencyHistogram::BUCKETS - 1] == 2);
+    histogram.clear();
+    CHECK(histogram.count == 0 && histogram.max == 0);
+}
+
+static void testPipeline(){
+    GFXcanvas16 canvas(96, 48);
+    Checkbox a({10, 10}, false, 10, 10, Outline(1, 0, 2, 0xFFFF), 0xFFFF);
+    Checkbox b({40, 10}, false, 10, 10, Outline(1, 0, 2, 0xFFFF), 0xFFFF);
+    Checkbox c({70, 10}, false, 10, 10, Outline(1, 0, 2, 0xFFFF), 0xFFFF);
+    Scene scene({&a, &b, &c}, &a);
+    UI ui(&scene, &canvas);
+    VirtualClock clock(1000000);
+    ui.setClock(&clock);
+    //The scene's script runs in the middle of Render(), it's where the frame spends its render time
+    uint32_t render_cost = 0;
+    scene.Script([&](){ clock.advance(render_cost); });
+    ui.Render();
+    ui.Presented();
+    CHECK(!ui.latency.isPending());
+
+    //Registered 300us before it's handed to the UI, the frame takes 2ms to render and 5ms to reach the display
+    struct Case{ uint32_t input_age, render, blit; };
+    const Case cases[] = {{300, 2000, 5000}, {40, 600, 9000}, {3000, 16000, 500}};
+    uint32_t focus_buckets[LatencyHistogram::BUCKETS] = {}, frame_buckets[LatencyHistogram::BUCKETS] = {};
+    uint32_t total_buckets[LatencyHistogram::BUCKETS] = {};
+    unsigned int direction = 0;
+    for (const Case& test : cases){
+        const uint32_t input = clock.micros() - test.input_age;
+        ui.FocusDirection(direction, input);
+        direction = direction ? 0 : 180;
+        CHECK(ui.latency.isPending());
+        //A second input before the first is on screen shares its frame and isn't measured
+        ui.FocusDirection(direction, clock.micros());
+        render_cost = test.render;
+        ui.Render();
+        render_cost = 0;
+        clock.advance(test.blit);
+        ui.Presented();
+        CHECK(!ui.latency.isPending());
+        focus_buckets[bucketOf(test.input_age)]++;
+        frame_buckets[bucketOf(test.render)]++;
+        total_buckets[bucketOf(test.input_age + test.render + test.blit)]++;
+    }
+
+    const LatencyHistogram& focus = ui.latency.getHistogram(LatencyStage::Focus);
+    const LatencyHistogram& frame = ui.latency.getHistogram(LatencyStage::Frame);
+    const LatencyHistogram& blit = ui.latency.getHistogram(LatencyStage::Blit);
+    const LatencyHistogram& total = ui.latency.getHistogram(LatencyStage::Total);
+    CHECK(focus.count == 3 && frame.count == 3 && blit.count == 3 && total.count == 3);
+    CHECK(!memcmp(focus.buckets, focus_buckets, sizeof(focus_buckets)));
+    CHECK(!memcmp(frame.buckets, frame_buckets, sizeof(frame_buckets)));
+    CHECK(!memcmp(total.buckets, total_buckets, sizeof(total_buckets)));
+    CHECK(frame.max == 16000 && frame.mean() == (2000 + 600 + 16000) / 3);
+    CHECK(blit.max == 9000 && total.max == 19500);
+    CHECK(focus.max == 3000 && focus.mean() == (300 + 40 + 3000) / 3);
+
+    //A frame without an input measures nothing
+    ui.Render();
+    ui.Presented();
+    CHECK(total.count == 3);
+    ui.latency.clear();
+    CHECK(total.count == 0 && !ui.latency.isPending());
+
+    //0 is a time like any other, an input registered when the clock started is measured from it. A click is handled right away
+    clock.set(0);
+    ui.Click(0);
+    CHECK(ui.latency.isPending());
+    clock.advance(700);
+    ui.Render();
+    clock.advance(1300);
+    ui.Presented();
+    CHECK(total.count == 1 && total.max == 2000 && focus.max == 0 && frame.max == 700);
+}
+
+int main(){
+    testHistogram();
+    testPipeline();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
@@ -0,0 +1,84 @@
+/*
+  Host test of compile time layouts. The precomputed focus graph must follow the real size of the elements when an entry is wrong,
+  and only the moves of a scene's own elements may make it compare the layout again. Moving an element over another one of a different
+  type has to sort the render batches again.
+
+  Build:  tools/host/build.sh tools/test_layout.cpp test_layout
+  Run:    ./test_layout, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+#include <algorithm>
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+//a is declared 16x16 but is 16x40, its center is lower than the layout says and a ray going right reaches c instead of b
+constexpr LayoutEntry entries[] = {
+    {{0, 0},   16, 16, false},
+    {{30, 0},  16, 16, false},
+    {{30, 18}, 16, 16, false},
+};
+constexpr auto layout = makeLayout(entries);
+
+static void testWrongEntry(){
+    GFXcanvas16 canvas(64, 64);
+    Checkbox a({}, false, 16, 40), b({}, false, 16, 16), c({}, false, 16, 16);
+    UIElement* const table[] = {&a, &b, &c};
+    static_assert(layout.slots[0].neighbours[0] == 1, "the layout alone links a to b");
+    Scene scene(layout, table, &a);
+    UI ui(&scene, &canvas);
+    ui.FocusDirection(Direction::Right);
+    ui.Render();
+    CHECK(ui.getFocused() == &c);
+}
+
+static void testVersions(){
+    Checkbox a({0, 0}, false, 10, 10), b({20, 0}, false, 10, 10);
+    const uint32_t a_version = a.getGeometryVersion();
+    const uint32_t b_version = b.getGeometryVersion();
+    b.setPos({20, 5});
+    CHECK(a.getGeometryVersion() == a_version);
+    CHECK(b.getGeometryVersion() != b_version);
+    a.setConstraint(Constraint::Center);
+    CHECK(a.getGeometryVersion() != a_version);
+}
+
+//The image is drawn after the checkbox, once it's moved over it the batches have to keep it on top like the plain rendering does
+constexpr LayoutEntry overlapEntries[] = {
+    {{0, 0},   12, 12, false},
+    {{30, 30}, 8,  8,  false},
+};
+constexpr auto overlapLayout = makeLayout(overlapEntries);
+
+static void testBatches(){
+    static uint16_t red[8 * 8];
+    std::fill(std::begin(red), std::end(red), 0xF800);
+    Texture texture(8, 8, red);
+    GFXcanvas16 canvas(64, 64), batched(64, 64);
+    Checkbox box({}, false, 12, 12, Outline(1, 0, 0, 0xFFFF), 0x001F);
+    UIImage image(&texture);
+    image.setScale(1.0f);
+    box.click();    //Filled, it covers whatever is drawn before it
+    UIElement* const table[] = {&box, &image};
+    Scene scene(overlapLayout, table, &box);
+    UI ui(&scene, &canvas);
+    scene.settings.batchRendering = true;
+    ui.Render();
+    image.setPos({2, 2});
+    ui.Render();
+    memcpy(batched.getBuffer(), canvas.getBuffer(), 64 * 64 * sizeof(uint16_t));
+    CHECK(canvas.getBuffer()[4 * 64 + 4] == 0xF800);
+    scene.settings.batchRendering = false;
+    ui.Render();
+    CHECK(!memcmp(canvas.getBuffer(), batched.getBuffer(), 64 * 64 * sizeof(uint16_t)));
+}
+
+int main(){
+    testWrongEntry();
+    testVersions();
+    testBatches();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
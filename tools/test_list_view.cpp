@@ -0,0 +1,149 @@
+/*
+  Host test of ListView. Items must only be created by the factory and filled by the data source when the index they show changes,
+  the selection has to follow the directions up to the edges of the list and the viewport has to scroll by whole rows to keep it visible.
+
+  Build:  tools/host/build.sh tools/test_list_view.cpp test_list_view
+  Run:    ./test_list_view, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+#include <map>
+#include <vector>
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+//Records which index every item was last filled with and how many times the data source ran
+struct Source{
+    std::map<const UIElement*, size_t> shown;
+    size_t calls = 0;
+    void operator()(UIElement* item, size_t index){
+        shown[item] = index;
+        calls++;
+    }
+    //!@return The y of the item that shows the index, -1 if none does
+    int rowOf(const ListView& list, size_t index) const {
+        for (size_t slot = 0; slot < list.getPoolSize(); slot++){
+            const auto found = shown.find(list.getItem(slot));
+            if (found != shown.end() && found->second == index)
+                return list.getItem(slot)->getPos().y;
+        }
+        return -1;
+    }
+};
+
+static void testScrolling(){
+    GFXcanvas16 canvas(128, 64);
+    //3 rows of 12 pixels fit in the viewport
+    ListView list({0, 10}, false, 100, 40, 12);
+    Checkbox other({110, 10}, false, 10, 10);
+    Scene scene({&list, &other}, &list);
+    UI ui(&scene, &canvas);
+    size_t created = 0;
+    CHECK(list.setFactory([&](){ created++; return static_cast<UIElement*>(new Checkbox({0, 0}, false, 10, 10)); }));
+    CHECK(created == 3 && list.getPoolSize() == 3);
+    Source source;
+    list.setSource(40, [&](UIElement* item, size_t index){ source(item, index); });
+    std::vector<size_t> clicked;
+    list.bind([&](size_t index){ clicked.push_back(index); });
+
+    ui.Render();
+    CHECK(source.calls == 3);
+    CHECK(source.rowOf(list, 0) == 10 && source.rowOf(list, 1) == 22 && source.rowOf(list, 2) == 34);
+    ui.Render();
+    CHECK(source.calls == 3);     //Nothing moved, nothing is filled again
+
+    //Moving inside the viewport doesn't scroll
+    ui.FocusDirection(Direction::Down);
+    ui.FocusDirection(Direction::Down);
+    ui.Render();
+    CHECK(list.getSelected() == 2 && source.calls == 3);
+    //Past the last visible row the viewport moves by one row, only the item that comes in is filled
+    ui.FocusDirection(Direction::Down);
+    ui.Render();
+    CHECK(list.getSelected() == 3 && source.calls == 4);
+    CHECK(source.rowOf(list, 1) == 10 && source.rowOf(list, 3) == 34 && source.rowOf(list, 0) == -1);
+    ui.Click();
+    CHECK(clicked.size() == 1 && clicked[0] == 3);
+
+    //Selecting far away scrolls straight there, the items are filled once each
+    list.select(30);
+    ui.Render();
+    CHECK(source.rowOf(list, 28) == 10 && source.rowOf(list, 30) == 34 && source.calls == 7);
+    list.select(1000);
+    CHECK(list.getSelected() == 39);
+    //Up at the top and down at the bottom leave the list, the focus moves to the closest element if there's one
+    ui.FocusDirection(Direction::Down);
+    ui.Render();
+    CHECK(list.getSelected() == 39);
+    list.select(0);
+    ui.Render();
+    CHECK(source.rowOf(list, 0) == 10);
+    ui.FocusDirection(Direction::Up);
+    ui.Render();
+    CHECK(list.getSelected() == 0);
+
+    //A shorter list clamps the selection and forgets the items past its end
+    list.select(20);
+    list.setCount(5);
+    CHECK(list.getSelected() == 4);
+    ui.Render();
+    CHECK(source.rowOf(list, 4) == 34 && source.rowOf(list, 2) == 10);
+    list.setCount(0);
+    ui.Click();
+    CHECK(clicked.size() == 1);
+}
+
+static void testGrid(){
+    GFXcanvas16 canvas(128, 64);
+    //2 rows of 3 columns
+    ListView grid({0, 0}, false, 96, 32, 16, 3);
+    Scene scene({&grid}, &grid);
+    UI ui(&scene, &canvas);
+    CHECK(grid.setFactory([](){ return static_cast<UIElement*>(new Checkbox({0, 0}, false, 10, 10)); }));
+    CHECK(grid.getPoolSize() == 6);
+    Source source;
+    grid.setSource(8, [&](UIElement* item, size_t index){ source(item, index); });
+    ui.Render();
+    CHECK(source.calls == 6);
+
+    ui.FocusDirection(Direction::Right);
+    ui.FocusDirection(Direction::Right);
+    ui.Render();
+    CHECK(grid.getSelected() == 2);
+    ui.FocusDirection(Direction::Right);    //The last column doesn't wrap into the next row
+    ui.Render();
+    CHECK(grid.getSelected() == 2);
+    ui.FocusDirection(Direction::Down);
+    ui.Render();
+    CHECK(grid.getSelected() == 5);
+    //The last row only has 2 items, there's nothing under 5
+    ui.FocusDirection(Direction::Down);
+    ui.Render();
+    CHECK(grid.getSelected() == 5);
+    ui.FocusDirection(Direction::Left);
+    ui.FocusDirection(Direction::Down);
+    ui.Render();
+    CHECK(grid.getSelected() == 7);
+    //The third row came in, the first one went out
+    CHECK(source.calls == 8 && source.rowOf(grid, 7) == 16 && source.rowOf(grid, 0) == -1);
+}
+
+//IDs wrap around after 65535 elements, 0 means "no element" so it's never handed out
+static void testIds(){
+    bool zero = false;
+    for (uint32_t i = 0; i <= UINT16_MAX + 1U; i++){
+        UIElement element;
+        zero |= element.getId() == 0;
+    }
+    CHECK(!zero);
+}
+
+int main(){
+    testScrolling();
+    testGrid();
+    testIds();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
@@ -0,0 +1,113 @@
+/*
+  Host test of OutlineCache. Every ring the cache fills must light up exactly the pixels whose center is inside the outer rounded
+  rectangle and outside the hole, for thin, thick, tall and very round rings alike. A geometry is rasterized once, strokes of one already
+  cached or warmed don't count as misses.
+
+  Build:  tools/host/build.sh tools/test_outline.cpp test_outline
+  Run:    ./test_outline, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+#include <algorithm>
+#include <vector>
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+static constexpr uint16_t BACKGROUND = 0x1234;
+static constexpr uint16_t COLOR = 0xF81F;
+
+//Whether the center of a pixel is inside a rounded rectangle, in integers so the reference has no rounding of its own
+static bool inside(int w, int h, int radius, int x, int y){
+    if (x < 0 || y < 0 || x >= w || y >= h)
+        return false;
+    radius = std::min(radius, std::min(w, h) / 2);
+    x = std::min(x, w - 1 - x);
+    y = std::min(y, h - 1 - y);
+    if (x >= radius || y >= radius)
+        return true;
+    const int dx = 2 * (radius - x) - 1, dy = 2 * (radius - y) - 1;
+    return dx * dx + dy * dy <= 4 * radius * radius;
+}
+
+static bool ring(int w, int h, int radius, int thickness, int hole_radius, int x, int y){
+    return inside(w, h, radius, x, y) && !inside(w - 2 * thickness, h - 2 * thickness, hole_radius, x - thickness, y - thickness);
+}
+
+struct Geometry{
+    uint16_t w, h;
+    uint16_t radius;
+    uint8_t thickness, hole_radius;
+};
+
+static void testFill(){
+    static const Geometry geometries[] = {
+        {20, 12, 0, 1, 0},          //Square corners
+        {20, 12, 4, 1, 3},
+        {31, 17, 6, 2, 4},          //Odd sizes keep a middle row and column
+        {16, 16, 8, 3, 5},          //A circle
+        {40, 10, 30, 2, 30},        //Radii larger than half the rectangle
+        {12, 12, 3, 6, 0},          //No hole left
+        {30, 300, 10, 4, 6},        //Taller than the rows the cache keeps
+        {700, 600, 300, 250, 50},   //The hole sits past 255 pixels from the edge
+    };
+    OutlineCache cache;
+    for (const Geometry& g : geometries){
+        const int width = g.w + 20, height = g.h + 20;
+        GFXcanvas16 canvas(width, height);
+        std::fill(canvas.getBuffer(), canvas.getBuffer() + width * height, BACKGROUND);
+        cache.stroke(&canvas, {10, 10}, g.w, g.h, g.radius, g.thickness, g.hole_radius, COLOR);
+        int wrong = 0;
+        for (int y = 0; y < height; y++){
+            for (int x = 0; x < width; x++){
+                const bool lit = ring(g.w, g.h, g.radius, g.thickness, g.hole_radius, x - 10, y - 10);
+                wrong += canvas.getBuffer()[y * width + x] != (lit ? COLOR : BACKGROUND);
+            }
+        }
+        if (wrong)
+            printf("%ux%u radius %u thickness %u hole radius %u: %d pixels differ\n", g.w, g.h, g.radius, g.thickness, g.hole_radius, wrong);
+        CHECK(wrong == 0);
+    }
+}
+
+//The corners of a thick ring keep their radius, it doesn't wrap around past 255
+static void testRing(){
+    const OutlineRing ring(Outline(200, 0, 100), Rect(0, 0, 300, 300));
+    CHECK(ring.radius == 299);
+    CHECK(ring.hole_radius == 99);
+    CHECK(ring.bounds.w == 700);
+}
+
+static void testMisses(){
+    GFXcanvas16 canvas(64, 64);
+    OutlineCache cache;
+    CHECK(cache.getMisses() == 0);
+    cache.stroke(&canvas, {0, 0}, 20, 20, 4, 1, 3, COLOR);
+    CHECK(cache.getMisses() == 1);
+    cache.stroke(&canvas, {5, 5}, 20, 20, 4, 1, 3, 0x07E0);   //Same geometry elsewhere and in another color
+    CHECK(cache.getMisses() == 1);
+    cache.stroke(&canvas, {0, 0}, 20, 20, 4, 2, 3, COLOR);
+    CHECK(cache.getMisses() == 2);
+    cache.warm(30, 10, 2, 1, 1);
+    cache.stroke(&canvas, {0, 0}, 30, 10, 2, 1, 1, COLOR);
+    CHECK(cache.getMisses() == 2);
+    cache.stroke(&canvas, {0, 0}, 0, 10, 2, 1, 1, COLOR);    //Empty rings draw nothing and build nothing
+    CHECK(cache.getMisses() == 2);
+
+    //Once more geometries than the cache holds were drawn, the first one is rasterized again
+    for (int i = 0; i < SIMPLEUI_OUTLINE_CACHE_SIZE; i++)
+        cache.stroke(&canvas, {0, 0}, 40, 10 + i, 2, 1, 1, COLOR);
+    const uint32_t misses = cache.getMisses();
+    CHECK(misses == 2 + SIMPLEUI_OUTLINE_CACHE_SIZE);
+    cache.stroke(&canvas, {0, 0}, 20, 20, 4, 1, 3, COLOR);
+    CHECK(cache.getMisses() == misses + 1);
+}
+
+int main(){
+    testFill();
+    testRing();
+    testMisses();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
@@ -0,0 +1,179 @@
+/*
+  Host test of scene preparation. A scene preloaded on the worker thread must show its first frame after a transition without building
+  any cache, while a scene shown before being prepared has to. The copies UIImage keeps must draw exactly like their source texture does,
+  and elements created on two threads at once must never share an ID.
+
+  Build:  tools/host/build.sh tools/test_preload.cpp test_preload
+  Run:    ./test_preload, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+static uint16_t gradient[16 * 16];
+static const uint8_t ring[] = {0x3C, 0x7E, 0xE7, 0xC3, 0xC3, 0xE7, 0x7E, 0x3C};
+
+//Every kind of cache a scene has: a filtered and an encoded image, a label, an outlined checkbox and the focus outline around it
+struct NextScene{
+    Texture source{16, 16, gradient};
+    uint8_t encoded[64];
+    Texture icon{8, 8, PixelType::RLEMono, encoded};
+    Checkbox box{{4, 4}, false, 20, 20, Outline(2, 0, 4, 0xFFFF), 0xF800};
+    UIImage filtered{&source, {30, 4}};
+    UIImage decoded{&icon, {60, 4}};
+    Label label;
+    Scene scene{{&box, &filtered, &decoded, &label}, &box};
+
+    NextScene(const GlyphAtlas* atlas) : label({90, 40}, false, atlas){
+        encodeRLEMono(Texture(8, 8, ring), encoded, sizeof(encoded));
+        filtered.scale_filter = ScaleFilter::Bilinear;
+        filtered.setScale(1.5f);
+        decoded.keep_decoded = true;
+        decoded.setScale(2.0f);
+        label.setText("42");
+        scene.settings.focus.outline = Outline(1, 1, 3, 0x07E0);
+    }
+};
+
+static void testFirstFrame(){
+    GFXcanvas16 canvas(128, 64), snapshot(128, 64);
+    GlyphAtlas atlas;
+    Checkbox home_box({10, 10}, false, 12, 12, Outline(1, 0, 2, 0xFFFF));
+    Scene home({&home_box}, &home_box);
+    NextScene warm(&atlas), cold(&atlas);
+    UI ui(&home, &canvas);
+    ui.setTransitionBuffer(&snapshot);
+    VirtualClock clock(1000);
+    ui.setClock(&clock);
+    CHECK(ui.AddScene(&cold.scene));
+    const auto frames = [&](int count){
+        for (int i = 0; i < count; i++){
+            clock.advance(16667);
+            ui.Render();
+        }
+    };
+    frames(3);
+
+    ui.PreloadScene(&warm.scene);
+    frames(3);      //The home scene keeps rendering while the other one is prepared
+    ui.TransitionTo(&warm.scene, Transition::SlideLeft, 100);
+    CHECK(warm.scene.isReady());
+    uint32_t misses = ui.getCacheMisses();
+    frames(1);
+    CHECK(ui.getCacheMisses() == misses);
+    frames(20);
+    CHECK(ui.getCacheMisses() == misses);
+
+    //A scene focused without being preloaded is prepared on the spot, its first frame doesn't build anything either
+    ui.TransitionTo(&home, Transition::None);
+    frames(2);
+    ui.TransitionTo(&cold.scene, Transition::SlideLeft, 100);
+    misses = ui.getCacheMisses();
+    frames(1);
+    CHECK(ui.getCacheMisses() == misses);
+
+    //A label whose text changes lays it out again in the next frame, unless it's prepared first
+    misses = ui.getCacheMisses();
+    cold.label.setText("1234");
+    CHECK(cold.label.getBounds().w == warm.label.getBounds().w * 2);
+    frames(1);
+    CHECK(ui.getCacheMisses() == misses + 1);
+    cold.label.setText("5678");
+    cold.label.prepare();
+    frames(1);
+    CHECK(ui.getCacheMisses() == misses + 1);
+}
+
+//The first scene of a UI is on screen before anything prepares it, its first frame builds every cache
+static void testUnprepared(){
+    GFXcanvas16 canvas(128, 64);
+    GlyphAtlas atlas;
+    NextScene next(&atlas);
+    UI ui(&next.scene, &canvas);
+    CHECK(ui.getCacheMisses() == 0);
+    ui.Render();
+    //The checkbox and the focus outlines, the two images and the label
+    CHECK(ui.getCacheMisses() == 5);
+    ui.Render();
+    CHECK(ui.getCacheMisses() == 5);
+}
+
+//A decoded copy drawn at its own size covers the same pixels with the same colors as its source drawn at the same factor
+static void testDecode(){
+    uint16_t colors[12 * 10];
+    uint8_t alpha[12 * 10];
+    for (int i = 0; i < 12 * 10; i++){
+        colors[i] = static_cast<uint16_t>(i * 2749);
+        alpha[i] = static_cast<uint8_t>((i * 37) % 256);
+        if (i % 7 == 0)
+            colors[i] = 0x0000;     //Runs of a color the RLE encoder can make transparent
+    }
+    const Texture raw(12, 10, colors);
+    uint8_t a1[32], a4[64], rle[512], palette_bits[64], mono_bits[20];
+    uint16_t palette[16];
+    uint16_t quantized[12 * 10];
+    for (int i = 0; i < 12 * 10; i++)
+        quantized[i] = static_cast<uint16_t>((i % 5) * 0x1111);
+    CHECK(encodeAlpha(alpha, 12, 10, PixelType::RGB565A1, a1, sizeof(a1)));
+    CHECK(encodeAlpha(alpha, 12, 10, PixelType::RGB565A4, a4, sizeof(a4)));
+    CHECK(encodeRLE565(raw, rle, sizeof(rle), 0x0000));
+    CHECK(encodePalette(Texture(12, 10, quantized), PixelType::Palette4, palette, palette_bits, sizeof(palette_bits)));
+    for (int i = 0; i < 20; i++)
+        mono_bits[i] = static_cast<uint8_t>(i * 73);
+    const Texture textures[] = {
+        Texture(12, 10, mono_bits), raw, Texture(12, 10, PixelType::RLE565, rle), Texture(12, 10, PixelType::Palette4, palette_bits, palette),
+        Texture(12, 10, PixelType::RGB565A1, colors, a1), Texture(12, 10, PixelType::RGB565A4, colors, a4),
+    };
+
+    GFXcanvas16 direct(48, 48), copied(48, 48);
+    for (const Texture& texture : textures){
+        for (const float factor : {1.0f, 0.5f, 0.7f, 1.5f, 2.0f, 3.3f}){
+            for (const uint8_t opacity : {32, 20}){
+                for (int i = 0; i < 48 * 48; i++)
+                    direct.getBuffer()[i] = copied.getBuffer()[i] = static_cast<uint16_t>(i * 31);
+                const Texture copy = decode(texture, factor, 0x07FF);
+                drawTexture(&direct, texture, 3, 2, factor, 0x07FF, opacity);
+                drawTexture(&copied, copy, 3, 2, 1.0f, 0x07FF, opacity);
+                const bool same = !memcmp(direct.getBuffer(), copied.getBuffer(), 48 * 48 * sizeof(uint16_t));
+                if (!same)
+                    printf("format %d at %.1f, opacity %u\n", static_cast<int>(texture.data.colorspace), factor, opacity);
+                CHECK(same);
+            }
+        }
+    }
+}
+
+//Elements can be created on the preload thread while the UI thread creates others, every one of them still gets its own ID
+static void testIds(){
+    std::vector<ElementID> first, second;
+    const auto create = [](std::vector<ElementID>& ids){
+        for (int i = 0; i < 30000; i++){
+            UIElement element;
+            ids.push_back(element.getId());
+        }
+    };
+    std::thread other(create, std::ref(second));
+    create(first);
+    other.join();
+    first.insert(first.end(), second.begin(), second.end());
+    std::sort(first.begin(), first.end());
+    CHECK(first.front() != 0);
+    CHECK(std::adjacent_find(first.begin(), first.end()) == first.end());
+}
+
+int main(){
+    for (int i = 0; i < 16 * 16; i++)
+        gradient[i] = static_cast<uint16_t>(((i % 16) << 12) | ((i / 16) << 7) | (i % 13));
+    testFirstFrame();
+    testUnprepared();
+    testDecode();
+    testIds();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
@@ -0,0 +1,180 @@
+/*
+  Host test of the static memory profile. Every global operator new is counted, and once the UI is built any allocation fails the test:
+  rendering, moving the focus, clicking, animating and updating labels must all run from the memory reserved at init. The second half
+  fills every container to its capacity and checks that the overflow is reported instead of corrupting the UI, and that animations
+  created past the capacity or in another store keep to themselves.
+
+  Build:  tools/host/build.sh tools/test_static_memory.cpp test_static_memory -DSIMPLEUI_STATIC_MEMORY=1
+  Run:    ./test_static_memory, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+#include <new>
+#include <optional>
+#if !SIMPLEUI_STATIC_MEMORY
+  #error "Build with -DSIMPLEUI_STATIC_MEMORY=1"
+#endif
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+//Once armed every allocation is a failure, it still succeeds so the test can report how many there were
+static bool armed = false;
+static size_t late_allocations = 0;
+
+void* operator new(size_t size){
+    if (armed && !late_allocations++)
+        fprintf(stderr, "first allocation after init: %zu bytes\n", size);
+    if (void* block = malloc(size ? size : 1))
+        return block;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size){ return operator new(size); }
+void operator delete(void* block) noexcept { free(block); }
+void operator delete[](void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+void operator delete[](void* block, size_t) noexcept { free(block); }
+
+static const uint8_t dot[] = {0x60, 0xF0, 0xF0, 0x60, 0x3C, 0x7E, 0xFF, 0xFF};
+
+static void testSteadyState(){
+    GFXcanvas16 canvas(128, 64), snapshot(128, 64);
+    Texture small(8, 4, dot), big(8, 8, dot);
+    GlyphAtlas atlas;
+    Checkbox a({4, 4}, false, 10, 10, Outline(1, 0, 2, 0xFFFF), 0xFFFF);
+    Checkbox b({24, 4}, false, 10, 10, Outline(1, 0, 2, 0xFFFF), 0xFFFF);
+    Checkbox c({4, 24}, false, 10, 10, Outline(1, 0, 2, 0xFFFF), 0xFFFF);
+    Checkbox d({24, 24}, false, 10, 10, Outline(1, 0, 2, 0xFFFF), 0xFFFF);
+    AnimatedApp app({60, 10}, false, &small, &big, Constraint::Center, 120U, 2.0f);
+    Label counter({60, 40}, false, &atlas);
+    Group group({&c, &d});
+    Scene home({&a, &b, &group, &app, &counter}, &a);
+    Checkbox other_box({10, 10}, false, 20, 20, Outline(1, 0, 2, 0xFFFF), 0xFFFF);
+    Scene other({&other_box}, &other_box);
+    UI ui(&home, &canvas);
+    CHECK(ui.AddScene(&other));
+    ui.setTransitionBuffer(&snapshot);
+    VirtualClock clock(1000);
+    ui.setClock(&clock);
+    home.settings.focus.glide_duration = 80;
+
+    //The first frames build the scene and start the animations
+    for (int i = 0; i < 5; i++){
+        clock.advance(16667);
+        ui.Render();
+    }
+    armed = true;
+    static const unsigned int moves[] = {0, 270, 180, 0, 0, 90, 180};
+    for (int frame = 0; frame < 600; frame++){
+        if (frame % 20 == 0)
+            CHECK(ui.FocusDirection(moves[(frame / 20) % 7]));
+        if (frame % 50 == 25)
+            ui.Click();
+        if (frame == 300)
+            ui.TransitionTo(&other, Transition::SlideLeft, 200);
+        if (frame == 450)
+            ui.TransitionTo(&home, Transition::Fade, 200);
+        counter.setNumber(frame);
+        clock.advance(16667);
+        ui.Render();
+        ui.Presented();
+    }
+    armed = false;
+    CHECK(late_allocations == 0);
+}
+
+static void testCapacities(){
+    //A group only keeps SIMPLEUI_MAX_CHILDREN children, the one past it is refused and stays out of the group
+    static Checkbox boxes[SIMPLEUI_MAX_CHILDREN + 1];
+    Group group;
+    for (int i = 0; i < SIMPLEUI_MAX_CHILDREN; i++)
+        CHECK(group.add(&boxes[i]));
+    CHECK(!group.add(&boxes[SIMPLEUI_MAX_CHILDREN]));
+    CHECK(group.getChildren().size() == SIMPLEUI_MAX_CHILDREN);
+    CHECK(boxes[SIMPLEUI_MAX_CHILDREN].getGroup() == nullptr);
+
+    //The same for the elements of a scene
+    static Checkbox elements[SIMPLEUI_MAX_ELEMENTS + 1];
+    Scene scene;
+    for (int i = 0; i < SIMPLEUI_MAX_ELEMENTS; i++)
+        CHECK(scene.addElement(&elements[i]));
+    CHECK(!scene.addElement(&elements[SIMPLEUI_MAX_ELEMENTS]));
+    CHECK(scene.size() == SIMPLEUI_MAX_ELEMENTS);
+    CHECK(scene.getElementByID(elements[SIMPLEUI_MAX_ELEMENTS - 1].getId()) == &elements[SIMPLEUI_MAX_ELEMENTS - 1]);
+
+    //Repeated moves in one direction share a queue entry, alternating ones fill the queue
+    GFXcanvas16 canvas(64, 32);
+    Checkbox left({4, 4}, false, 10, 10), right({30, 4}, false, 10, 10);
+    Scene pair({&left, &right}, &left);
+    UI ui(&pair, &canvas);
+    for (int i = 0; i < 3 * SIMPLEUI_MAX_FOCUS_MOVES; i++)
+        CHECK(ui.FocusDirection(Direction::Right));
+    for (int i = 1; i < SIMPLEUI_MAX_FOCUS_MOVES; i++)
+        CHECK(ui.FocusDirection(i % 2 ? Direction::Left : Direction::Right));
+    CHECK(!ui.FocusDirection(Direction::Up));
+    ui.Render();
+    //Once the queue has been resolved there's room again
+    CHECK(ui.FocusDirection(Direction::Left));
+
+    Scene scenes[SIMPLEUI_MAX_SCENES];
+    for (int i = 1; i < SIMPLEUI_MAX_SCENES; i++)
+        CHECK(ui.AddScene(&scenes[i]));
+    CHECK(!ui.AddScene(&scenes[0]));
+
+    //An animation past SIMPLEUI_MAX_ANIMATIONS is told it has no slot, in a store of its own so the UI above keeps its animations
+    static AnimationStore store;
+    AnimationStore::Scope scope(store);
+    Animation animations[AnimationStore::CAPACITY - 1];
+    {
+        Animation last;
+        CHECK(store.getUsed() == AnimationStore::CAPACITY && store.getOverflows() == 0);
+        Animation extra;
+        CHECK(!extra.isValid() && last.isValid());
+        CHECK(store.getOverflows() == 1);
+        //Animations without a slot don't share anything, each one reads as finished at its own end
+        Animation grow(0.5f, 2.0f), shrink(1.0f, 0.25f);
+        grow.Start();
+        shrink.setThreshold(0.5f);
+        store.update(1000000);
+        CHECK(grow.getProgress() == 2.0f && shrink.getProgress() == 0.25f);
+        CHECK(grow.getState() == AnimState::Finished && !grow.isEnabled() && !grow.isDirty() && shrink.getThreshold() == 0.0f);
+        shrink.Flip();
+        CHECK(shrink.getProgress() == 1.0f && grow.getProgress() == 2.0f && shrink.getDirection());
+        const Animation copy = grow;
+        CHECK(!copy.isValid() && copy.getProgress() == 2.0f);
+    }
+    Animation fits;
+    CHECK(fits.isValid() && animations[0].isValid());
+}
+
+//A handle keeps reading the store it was created in once the Scope that made it the global one has ended
+static void testScopedHandle(){
+    static AnimationStore store;
+    std::optional<Animation> scoped;
+    {
+        AnimationStore::Scope scope(store);
+        scoped.emplace(0.0f, 1.0f, 10);
+    }
+    CHECK(store.getUsed() == 1);
+    const uint16_t used = AnimationStore::global().getUsed();
+    Animation outside(3.0f, 4.0f);
+    scoped->Start();
+    store.update(5000);
+    CHECK(scoped->getProgress() > 0.0f && scoped->getProgress() < 1.0f);
+    CHECK(outside.getProgress() == 3.0f);
+    //A copy goes in the store of the original
+    Animation copy = *scoped;
+    CHECK(store.getUsed() == 2 && AnimationStore::global().getUsed() == used + 1);
+    CHECK(copy.getProgress() == scoped->getProgress());
+    scoped.reset();
+    CHECK(store.getUsed() == 1 && AnimationStore::global().getUsed() == used + 1);
+}
+
+int main(){
+    testSteadyState();
+    testCapacities();
+    testScopedHandle();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
@@ -0,0 +1,346 @@
+/*
+  Host test of the texture encoders and of blending. Every compressed format must decode back to the pixels it was encoded from, and an
+  encoder must report the exact size it needs, refuse an output that's too small and refuse inputs its format can't hold. Textures with
+  alpha, and images faded with setOpacity(), have to land within a rounding step of a floating point blend of the same pixels. Scaled
+  textures have to sample the source pixels ScaleStep picks, whether scale() or drawTexture() scales them, and raw images have to draw
+  what GFX's bitmap calls drew.
+
+  Build:  tools/host/build.sh tools/test_texture.cpp test_texture
+  Run:    ./test_texture, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+#include <vector>
+
+using SimpleUI::UIImage;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+//!@return The color of a pixel of a decoded texture and its alpha from 0 to 15, RGB565 ones are opaque
+static uint16_t pixelAt(const Texture& decoded, unsigned int x, unsigned int y, uint8_t& alpha){
+    alpha = 15;
+    if (decoded.data.colorspace == PixelType::RGB565A4){
+        const uint8_t packed = decoded.data.alpha[y * ((decoded.width + 1) / 2) + x / 2];
+        alpha = x % 2 ? packed & 0x0F : packed >> 4;
+    }
+    return decoded.data.rgb565[y * decoded.width + x];
+}
+
+//Measuring, encoding and encoding into one byte less than needed
+template<typename Encode>
+static std::vector<uint8_t> encodeChecked(Encode&& encode){
+    const size_t size = encode(nullptr, 0);
+    CHECK(size > 0);
+    std::vector<uint8_t> output(size);
+    CHECK(encode(output.data(), size) == size);
+    std::vector<uint8_t> small(size - 1);
+    CHECK(encode(small.data(), size - 1) == 0);
+    return output;
+}
+
+static void testRLEMono(){
+    constexpr unsigned int W = 37, H = 9, ROW = (W + 7) / 8;
+    uint8_t bits[ROW * H] = {};
+    for (unsigned int y = 0; y < H; y++){
+        for (unsigned int x = 0; x < W; x++){
+            //An empty row, a full one and runs of every length in between
+            const bool lit = y == 2 || (y != 1 && (x * (y + 1) / 5) % 2);
+            if (lit)
+                bits[y * ROW + x / 8] |= 0x80 >> (x % 8);
+        }
+    }
+    const Texture source(W, H, bits);
+    const std::vector<uint8_t> encoded = encodeChecked([&](uint8_t* output, size_t capacity){ return encodeRLEMono(source, output, capacity); });
+    const Texture decoded = decode(Texture(W, H, PixelType::RLEMono, encoded.data()), 1.0f, 0x07E0);
+    int wrong = 0;
+    for (unsigned int y = 0; y < H; y++){
+        for (unsigned int x = 0; x < W; x++){
+            uint8_t alpha;
+            const uint16_t color = pixelAt(decoded, x, y, alpha);
+            const bool lit = bits[y * ROW + x / 8] & (0x80 >> (x % 8));
+            wrong += lit ? alpha != 15 || color != 0x07E0 : alpha != 0;
+        }
+    }
+    CHECK(wrong == 0);
+
+    static uint8_t wide[32 * 2];
+    CHECK(encodeRLEMono(Texture(256, 2, wide), nullptr, 0) == 0);
+    CHECK(encodeRLEMono(Texture(8, 8, static_cast<uint16_t*>(nullptr)), nullptr, 0) == 0);
+}
+
+static void testRLE565(){
+    //Runs longer than a packet, literals, single pixels and the transparent color
+    constexpr unsigned int W = 150, H = 4;
+    uint16_t colors[W * H];
+    for (unsigned int y = 0; y < H; y++){
+        for (unsigned int x = 0; x < W; x++){
+            uint16_t color = static_cast<uint16_t>(x * 2749 + y);
+            if (x < 70 || (y == 1 && x >= 100))
+                color = y % 2 ? 0x0000 : 0xF800;
+            else if (x % 9 == 0)
+                color = 0x0000;
+            colors[y * W + x] = color;
+        }
+    }
+    const Texture source(W, H, colors);
+    for (const int32_t transparent : {-1, 0x0000}){
+        const std::vector<uint8_t> encoded = encodeChecked([&](uint8_t* output, size_t capacity){ return encodeRLE565(source, output, capacity, transparent); });
+        const Texture decoded = decode(Texture(W, H, PixelType::RLE565, encoded.data()));
+        int wrong = 0;
+        for (unsigned int y = 0; y < H; y++){
+            for (unsigned int x = 0; x < W; x++){
+                uint8_t alpha;
+                const uint16_t color = pixelAt(decoded, x, y, alpha);
+                wrong += colors[y * W + x] == transparent ? alpha != 0 : alpha != 15 || color != colors[y * W + x];
+            }
+        }
+        CHECK(wrong == 0);
+    }
+    CHECK(encodeRLE565(Texture(8, 8, static_cast<uint8_t*>(nullptr)), nullptr, 0) == 0);
+}
+
+static void testPalette(){
+    constexpr unsigned int W = 13, H = 5;
+    for (const PixelType format : {PixelType::Palette2, PixelType::Palette4}){
+        const unsigned int count = 1 << static_cast<unsigned int>(format);
+        uint16_t colors[W * H];
+        for (unsigned int i = 0; i < W * H; i++)
+            colors[i] = static_cast<uint16_t>(((i * 7) % count) * 0x0841 + 1);
+        const Texture source(W, H, colors);
+        uint16_t palette[16];
+        const std::vector<uint8_t> encoded = encodeChecked([&](uint8_t* output, size_t capacity){ return encodePalette(source, format, palette, output, capacity); });
+        const Texture decoded = decode(Texture(W, H, format, encoded.data(), palette));
+        CHECK(decoded.data.colorspace == PixelType::RGB565);
+        CHECK(!memcmp(decoded.data.rgb565, colors, sizeof(colors)));
+
+        //One color more than the palette holds
+        colors[W * H - 1] = 0xFFFF;
+        CHECK(encodePalette(source, format, palette, nullptr, 0) == 0);
+    }
+    uint16_t palette[16];
+    CHECK(encodePalette(Texture(2, 2, static_cast<uint16_t*>(nullptr)), PixelType::RLE565, palette, nullptr, 0) == 0);
+}
+
+static void testAlpha(){
+    constexpr unsigned int W = 11, H = 6;
+    uint16_t colors[W * H];
+    uint8_t alpha[W * H];
+    for (unsigned int i = 0; i < W * H; i++){
+        colors[i] = static_cast<uint16_t>(i * 977);
+        alpha[i] = static_cast<uint8_t>(i * 255 / (W * H - 1));
+    }
+    for (const PixelType format : {PixelType::RGB565A1, PixelType::RGB565A4}){
+        const std::vector<uint8_t> plane = encodeChecked([&](uint8_t* output, size_t capacity){ return encodeAlpha(alpha, W, H, format, output, capacity); });
+        const Texture decoded = decode(Texture(W, H, format, colors, plane.data()));
+        int wrong = 0;
+        for (unsigned int y = 0; y < H; y++){
+            for (unsigned int x = 0; x < W; x++){
+                const unsigned int i = y * W + x;
+                const uint8_t expected = format == PixelType::RGB565A1 ? (alpha[i] >= 128 ? 15 : 0) : (alpha[i] * 15 + 127) / 255;
+                uint8_t value;
+                const uint16_t color = pixelAt(decoded, x, y, value);
+                wrong += value != expected || (expected && color != colors[i]);
+            }
+        }
+        CHECK(wrong == 0);
+    }
+    CHECK(encodeAlpha(alpha, W, H, PixelType::RGB565, nullptr, 0) == 0);
+}
+
+/*!
+    @brief Check a canvas against a floating point blend of the texture over the background it was drawn on
+    @param alphaAt The alpha of a source pixel from 0 to 1, before the opacity
+    @return How many channels are further from the reference than the fixed point alpha can explain
+*/
+template<typename A>
+static int compareBlend(const GFXcanvas16& canvas, const uint16_t* background, const uint16_t* colors, unsigned int width, int x0, int y0,
+                        float factor, uint8_t opacity, A alphaAt){
+    const ScaleStep step(factor);
+    int wrong = 0;
+    for (int y = 0; y < canvas.height(); y++){
+        for (int x = 0; x < canvas.width(); x++){
+            const int i = y * canvas.width() + x;
+            const int dx = x - x0, dy = y - y0;
+            const bool inside = dx >= 0 && dy >= 0 && dx < static_cast<int>(width * factor) && dy < static_cast<int>(width * factor);
+            const unsigned int src = inside ? step.source(dy) * width + step.source(dx) : 0;
+            const float alpha = inside ? alphaAt(src) * opacity / 32.0f : 0.0f;
+            for (const auto& [shift, mask] : {std::pair<int, int>{11, 0x1F}, {5, 0x3F}, {0, 0x1F}}){
+                const int from = (background[i] >> shift) & mask;
+                const int to = inside ? (colors[src] >> shift) & mask : from;
+                const float expected = from + (to - from) * alpha;
+                const int actual = (canvas.getBuffer()[i] >> shift) & mask;
+                //alpha4 and the opacity each round to 1/32, blend565 truncates
+                wrong += fabsf(actual - expected) > 1.0f + abs(to - from) * 2.0f / 32.0f;
+            }
+        }
+    }
+    return wrong;
+}
+
+static void testDrawAlpha(){
+    constexpr unsigned int W = 12;
+    uint16_t colors[W * W];
+    uint8_t alpha[W * W];
+    for (unsigned int i = 0; i < W * W; i++){
+        colors[i] = static_cast<uint16_t>(i * 2311 + 0x0841);
+        alpha[i] = i % 5 == 0 ? 0 : i % 5 == 1 ? 255 : static_cast<uint8_t>(i * 37);     //Transparent, opaque and blended spans
+    }
+    GFXcanvas16 canvas(40, 40);
+    uint16_t background[40 * 40];
+    for (unsigned int i = 0; i < 40 * 40; i++)
+        background[i] = static_cast<uint16_t>(0xFFFF - i * 41);
+    for (const PixelType format : {PixelType::RGB565A1, PixelType::RGB565A4}){
+        uint8_t plane[W * W];
+        CHECK(encodeAlpha(alpha, W, W, format, plane, sizeof(plane)));
+        const Texture texture(W, W, format, colors, plane);
+        const auto alphaAt = [&](unsigned int src){
+            return format == PixelType::RGB565A1 ? (alpha[src] >= 128 ? 1.0f : 0.0f) : ((alpha[src] * 15 + 127) / 255) / 15.0f;
+        };
+        for (const float factor : {1.0f, 2.0f, 0.7f}){
+            for (const uint8_t opacity : {32, 20, 1, 0}){
+                memcpy(canvas.getBuffer(), background, sizeof(background));
+                drawTexture(&canvas, texture, 5, 3, factor, 0xFFFF, opacity);
+                const int wrong = compareBlend(canvas, background, colors, W, 5, 3, factor, opacity, alphaAt);
+                if (wrong)
+                    printf("format %d at %.1f, opacity %u: %d channels\n", static_cast<int>(format), factor, opacity, wrong);
+                CHECK(wrong == 0);
+            }
+        }
+    }
+}
+
+//An opaque image faded with setOpacity() is blended like a texture whose every pixel has that alpha
+static void testOpacity(){
+    constexpr unsigned int W = 12;
+    uint16_t colors[W * W];
+    for (unsigned int i = 0; i < W * W; i++)
+        colors[i] = static_cast<uint16_t>(i * 977);
+    Texture texture(W, W, colors);
+    GFXcanvas16 canvas(40, 40);
+    uint16_t background[40 * 40];
+    for (unsigned int i = 0; i < 40 * 40; i++)
+        background[i] = static_cast<uint16_t>(i * 53);
+    UIImage image(&texture, {7, 9});
+    image.setScale(1.0f);
+    SimpleUI::Scene scene({&image});
+    SimpleUI::UI ui(&scene, &canvas);
+    for (const uint8_t opacity : {32, 24, 8, 0}){
+        image.setOpacity(opacity);
+        memcpy(canvas.getBuffer(), background, sizeof(background));
+        ui.Render();
+        CHECK(compareBlend(canvas, background, colors, W, 7, 9, 1.0f, opacity, [](unsigned int){ return 1.0f; }) == 0);
+    }
+    image.setOpacity(200);
+    memcpy(canvas.getBuffer(), background, sizeof(background));
+    ui.Render();
+    CHECK(canvas.getBuffer()[9 * 40 + 7] == colors[0]);
+}
+
+/*Nearest neighbor scale() and drawTexture() follow ScaleStep, raw and compressed alike, at factors whose inverse isn't exact too. Next to
+the float rule they replaced, dst * (1.0f / factor), they sample the same source pixel at exact factors and at most the next one otherwise*/
+static void testScale(){
+    constexpr unsigned int W = 40;
+    uint16_t colors[W * W];
+    uint8_t bits[W / 8 * W] = {};
+    for (unsigned int i = 0; i < W * W; i++){
+        colors[i] = static_cast<uint16_t>(i * 3 + 1);    //Every pixel has its own color, never the transparent 0
+        if (i % 3 != 1 && (i / W) % 4 != 2)
+            bits[i / 8] |= 0x80 >> (i % 8);
+    }
+    Texture raw(W, W, colors), mono(W, W, bits);
+    const std::vector<uint8_t> rle = encodeChecked([&](uint8_t* out, size_t capacity){ return encodeRLE565(raw, out, capacity); });
+    const std::vector<uint8_t> rle_mono = encodeChecked([&](uint8_t* out, size_t capacity){ return encodeRLEMono(mono, out, capacity); });
+    const Texture encoded[] = {Texture(W, W, PixelType::RLE565, rle.data()), Texture(W, W, PixelType::RLEMono, rle_mono.data())};
+
+    for (const float factor : {0.3f, 0.5f, 0.7f, 1.3f, 1.7f, 2.0f, 2.3f, 3.0f, 3.1f}){
+        const ScaleStep step(factor);
+        const float inv = 1.0f / factor;
+        const bool exact = factor == 0.5f || factor == 2.0f || factor == 3.0f;
+        for (int format = 0; format < 2; format++){
+            Texture& source = format ? mono : raw;
+            const Texture scaled = scale(source, factor);
+            GFXcanvas16 drawn(scaled.width, scaled.height), compressed(scaled.width, scaled.height);
+            memset(drawn.getBuffer(), 0, scaled.width * scaled.height * sizeof(uint16_t));
+            memset(compressed.getBuffer(), 0, scaled.width * scaled.height * sizeof(uint16_t));
+            drawTexture(&drawn, source, 0, 0, factor, 0xFFFF);
+            drawTexture(&compressed, encoded[format], 0, 0, factor, 0xFFFF);
+            int wrong = 0, far = 0, moved = 0;
+            for (unsigned int y = 0; y < scaled.height; y++){
+                for (unsigned int x = 0; x < scaled.width; x++){
+                    const unsigned int src_x = step.source(x), src_y = step.source(y);
+                    const unsigned int i = src_y * W + src_x;
+                    const uint16_t expected = format ? ((bits[i / 8] & (0x80 >> (i % 8))) ? 0xFFFF : 0) : colors[i];
+                    const uint16_t actual = format ? ((scaled.data.mono[y * ((scaled.width + 7) / 8) + x / 8] & (0x80 >> (x % 8))) ? 0xFFFF : 0)
+                                                   : scaled.data.rgb565[y * scaled.width + x];
+                    wrong += actual != expected;
+                    wrong += drawn.getBuffer()[y * scaled.width + x] != expected;
+                    wrong += compressed.getBuffer()[y * scaled.width + x] != expected;
+                    const int dx = static_cast<int>(src_x) - static_cast<int>(x * inv), dy = static_cast<int>(src_y) - static_cast<int>(y * inv);
+                    far += dx < 0 || dy < 0 || dx > 1 || dy > 1;
+                    moved += dx || dy;
+                }
+            }
+            if (wrong || far || (exact && moved))
+                printf("format %d at %.1f: %d wrong, %d far, %d moved\n", format, factor, wrong, far, moved);
+            CHECK(wrong == 0);
+            CHECK(far == 0);
+            CHECK(!exact || moved == 0);
+        }
+    }
+}
+
+//Opaque raw images go through drawTexture() where GFX used to blit them, the canvas must come out as drawRGBBitmap() and drawBitmap() left it
+static void testBlit(){
+    constexpr unsigned int W = 20;
+    uint16_t colors[W * W];
+    uint8_t bits[(W + 7) / 8 * W] = {};
+    for (unsigned int i = 0; i < W * W; i++){
+        colors[i] = static_cast<uint16_t>(i * 1237 + 5);
+        if ((i * 7) % 5 < 2)
+            bits[(i / W) * ((W + 7) / 8) + (i % W) / 8] |= 0x80 >> (i % W % 8);
+    }
+    Texture raw(W, W, colors), mono(W, W, bits);
+    GFXcanvas16 canvas(64, 40), blitted(64, 40);
+    for (Texture* texture : {&raw, &mono}){
+        for (const ScaleFilter filter : {ScaleFilter::Nearest, ScaleFilter::Bilinear, ScaleFilter::Box}){
+            if (texture == &mono && filter != ScaleFilter::Nearest)
+                continue;   //Filtered Mono textures come back with a coverage alpha, they were never blitted by GFX
+            for (const float factor : {1.0f, 0.6f, 1.5f}){
+                for (const SimpleUI::Point pos : {SimpleUI::Point(3, 4), SimpleUI::Point(-7, -5), SimpleUI::Point(50, 30)}){     //Inside and clipped on every side
+                    UIImage image(texture, pos);
+                    image.scale_filter = filter;
+                    image.setScale(factor);
+                    image.setColor(0x07E0);
+                    SimpleUI::Scene scene({&image});
+                    SimpleUI::UI ui(&scene, &canvas);
+                    for (int i = 0; i < 64 * 40; i++)
+                        canvas.getBuffer()[i] = blitted.getBuffer()[i] = static_cast<uint16_t>(i * 29);
+                    ui.Render();
+
+                    const Texture scaled = scale(*texture, factor, nullptr, filter, 0x07E0);
+                    if (texture == &mono)
+                        blitted.drawBitmap(pos.x, pos.y, scaled.data.mono, scaled.width, scaled.height, 0x07E0);
+                    else
+                        blitted.drawRGBBitmap(pos.x, pos.y, scaled.data.rgb565, scaled.width, scaled.height);
+                    const bool same = !memcmp(canvas.getBuffer(), blitted.getBuffer(), 64 * 40 * sizeof(uint16_t));
+                    if (!same)
+                        printf("%s, filter %d at %.1f, (%d, %d)\n", texture == &mono ? "Mono" : "RGB565", static_cast<int>(filter), factor, pos.x, pos.y);
+                    CHECK(same);
+                }
+            }
+        }
+    }
+}
+
+int main(){
+    testRLEMono();
+    testRLE565();
+    testPalette();
+    testAlpha();
+    testDrawAlpha();
+    testOpacity();
+    testScale();
+    testBlit();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}
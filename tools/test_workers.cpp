@@ -0,0 +1,189 @@
+/*
+  Host test of the worker pool. Every item of a parallelFor must be handed out exactly once, also after the pool is stopped and started
+  again, when it's stopped while another thread is using it, and on a pool opened with a Scope in place of the global one. What scale()
+  and drawTexture() produce has to hash the same with any number of workers.
+
+  Build:  tools/host/build.sh tools/test_workers.cpp test_workers
+  Run:    ./test_workers, the exit status is the number of failed checks
+*/
+#include "SimpleUI.h"
+#include <thread>
+#include <vector>
+
+using namespace SimpleUI;
+
+static int failures = 0;
+#define CHECK(condition) do{ if (!(condition)){ printf("FAIL %s:%d  %s\n", __FILE__, __LINE__, #condition); failures++; } }while(0)
+
+static constexpr unsigned int ITEMS = 1000;
+
+//Marks every item it's given, a job that runs twice or skips a range shows up in the marks
+struct Marks{
+    std::atomic<unsigned int> hits[ITEMS];
+    std::atomic<unsigned int> calls{0};
+
+    Marks(){ clear(); }
+    void clear(){
+        for (auto& hit : hits)
+            hit = 0;
+        calls = 0;
+    }
+    void operator()(unsigned int begin, unsigned int end){
+        calls++;
+        for (unsigned int i = begin; i < end; i++)
+            hits[i]++;
+    }
+    bool once() const {
+        for (const auto& hit : hits)
+            if (hit != 1)
+                return false;
+        return true;
+    }
+};
+
+static void testRestart(){
+    WorkerPool pool;
+    Marks first, second;
+    pool.parallelFor(ITEMS, 1, first);
+    CHECK(first.once() && first.calls == 1);    //Not started yet, everything runs on the calling thread
+
+    CHECK(pool.start(3));
+    CHECK(pool.getWorkers() == 3);
+    first.clear();
+    pool.parallelFor(ITEMS, 1, first);
+    CHECK(first.once() && first.calls == 4);
+
+    //After a restart the workers only run the new job, the last one before the stop isn't run again
+    for (int round = 0; round < 20; round++){
+        Marks& last = round % 2 ? second : first;
+        Marks& next = round % 2 ? first : second;
+        const unsigned int last_calls = last.calls;
+        pool.stop();
+        CHECK(pool.getWorkers() == 0);
+        CHECK(pool.start(round % 3 + 1));
+        next.clear();
+        pool.parallelFor(ITEMS, 1, next);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        CHECK(next.once() && next.calls == pool.getWorkers() + 1U);
+        CHECK(last.calls == last_calls);
+    }
+
+    //Ranges smaller than min_range aren't handed out
+    second.clear();
+    pool.parallelFor(ITEMS, ITEMS / 2, second);
+    CHECK(second.once() && second.calls == 2);
+    second.clear();
+    pool.parallelFor(ITEMS, ITEMS, second);
+    CHECK(second.once() && second.calls == 1);
+}
+
+static void testStopWhileBusy(){
+    WorkerPool pool;
+    CHECK(pool.start(3));
+    std::atomic<bool> done{false};
+    std::atomic<int> broken{0};
+    std::thread user([&](){
+        Marks marks;
+        while (!done){
+            marks.clear();
+            pool.parallelFor(ITEMS, 1, marks);
+            broken += !marks.once();
+        }
+    });
+    for (int round = 0; round < 200; round++){
+        pool.stop();
+        pool.start(round % 3 + 1);
+    }
+    done = true;
+    user.join();
+    CHECK(broken == 0);
+}
+
+static void testScope(){
+    WorkerPool& global = WorkerPool::global();
+    WorkerPool pool;
+    CHECK(pool.start(2));
+    {
+        WorkerPool::Scope scope(pool);
+        CHECK(&WorkerPool::global() == &pool);
+        Marks marks;
+        parallelRows(ITEMS, SIMPLEUI_PARALLEL_PIXELS, marks);
+        CHECK(marks.once() && marks.calls == 3);
+    }
+    CHECK(&WorkerPool::global() == &global);
+}
+
+//FNV-1a of a texture's pixels, or of a canvas
+static uint32_t hash(const void* data, size_t bytes, uint32_t h = 2166136261u){
+    for (size_t i = 0; i < bytes; i++)
+        h = (h ^ static_cast<const uint8_t*>(data)[i]) * 16777619u;
+    return h;
+}
+
+static uint32_t hash(const Texture& texture){
+    const size_t pixels = static_cast<size_t>(texture.width) * texture.height;
+    if (texture.data.colorspace == PixelType::Mono)
+        return hash(texture.data.mono, (texture.width + 7) / 8 * texture.height);
+    const uint32_t colors = hash(texture.data.rgb565, pixels * sizeof(uint16_t));
+    return texture.data.colorspace == PixelType::RGB565A4 ? hash(texture.data.alpha, (texture.width + 1) / 2 * texture.height, colors) : colors;
+}
+
+//The hash of everything the kernels that split their rows produce, scale() with every filter and drawTexture() with every format
+static std::vector<uint32_t> render(){
+    constexpr unsigned int W = 128;
+    static uint16_t colors[W * W];
+    static uint8_t bits[W / 8 * W], alpha[W * W], a4[W / 2 * W], rle[W * W * 3];
+    for (unsigned int i = 0; i < W * W; i++){
+        colors[i] = static_cast<uint16_t>((i % 97 < 40) ? 0 : i * 2311);
+        alpha[i] = static_cast<uint8_t>(i * 37);
+        if ((i * 7) % 5 < 2)
+            bits[i / 8] |= 0x80 >> (i % 8);
+    }
+    Texture raw(W, W, colors), mono(W, W, bits);
+    encodeAlpha(alpha, W, W, PixelType::RGB565A4, a4, sizeof(a4));
+    encodeRLE565(raw, rle, sizeof(rle), 0x0000);
+    const Texture textures[] = {raw, mono, Texture(W, W, PixelType::RGB565A4, colors, a4), Texture(W, W, PixelType::RLE565, rle)};
+
+    std::vector<uint32_t> hashes;
+    for (Texture* source : {&raw, &mono}){
+        for (const ScaleFilter filter : {ScaleFilter::Nearest, ScaleFilter::Bilinear, ScaleFilter::Box}){
+            for (const float factor : {0.7f, 1.9f})
+                hashes.push_back(hash(scale(*source, factor, nullptr, filter, 0x07E0)));
+        }
+    }
+    GFXcanvas16 canvas(160, 128);
+    for (const Texture& texture : textures){
+        for (const uint8_t opacity : {32, 20}){
+            for (int i = 0; i < 160 * 128; i++)
+                canvas.getBuffer()[i] = static_cast<uint16_t>(i * 13);
+            drawTexture(&canvas, texture, -9, 3, 1.3f, 0x07E0, opacity);
+            hashes.push_back(hash(canvas.getBuffer(), 160 * 128 * sizeof(uint16_t)));
+        }
+    }
+    return hashes;
+}
+
+//Rows are written by one thread each with the serial math, the output can't depend on how many workers share them
+static void testOutput(){
+    const std::vector<uint32_t> serial = render();
+    for (uint8_t workers = 1; workers <= WorkerPool::MAX_WORKERS; workers++){
+        WorkerPool pool;
+        WorkerPool::Scope scope(pool);
+        CHECK(pool.start(workers));
+        const std::vector<uint32_t> parallel = render();
+        for (size_t i = 0; i < serial.size(); i++){
+            if (parallel[i] != serial[i])
+                printf("%u workers: output %u differs\n", workers, static_cast<unsigned int>(i));
+        }
+        CHECK(parallel == serial);
+    }
+}
+
+int main(){
+    testRestart();
+    testStopWhileBusy();
+    testScope();
+    testOutput();
+    printf("%s: %d failure%s\n", failures ? "FAILED" : "passed", failures, failures == 1 ? "" : "s");
+    return failures;
+}